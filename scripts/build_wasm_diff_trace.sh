@@ -38,7 +38,9 @@ em++ \
   "${ROOT_DIR}/src/app/AssetPaths.cpp" \
   "${ROOT_DIR}/src/core/WorldGrid.cpp" \
   "${ROOT_DIR}/src/core/SimulatedLidar.cpp" \
+  "${ROOT_DIR}/src/core/BatchedRayMarch.cpp" \
   "${ROOT_DIR}/src/core/OccupancyGridMap.cpp" \
+  "${ROOT_DIR}/src/core/WorkerPool.cpp" \
   "${ROOT_DIR}/src/input/Motion.cpp" \
   -sWASM=1 \
   -sENVIRONMENT=node \
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "core/ScanMatcher.h"
+#include "core/Types.h"
+
 /**
  * @file Config.h
  * @brief Runtime configuration structures for the SLAM app.
@@ -27,6 +30,8 @@ struct WorldConfig {
   int height = 80;
   /// True to show world map at startup.
   bool showWorldByDefault = false;
+  /// Memory order of the clearance field read by LidarMode::kSphereTrace.
+  core::MapLayout layout = core::MapLayout::kRowMajor;
 };
 
 /**
@@ -39,6 +44,42 @@ struct LidarConfig {
   int beamCount = 72;
   /// Ray-march step size in grid units.
   double stepSize = 1.0;
+  /// Beam casting strategy.
+  core::LidarMode mode = core::LidarMode::kRayMarch;
+  /// Threads for beam casting and map integration; 1 keeps both on the main thread.
+  int workerThreads = 1;
+};
+
+/**
+ * @brief Reconstructed occupancy map parameters.
+ */
+struct MapConfig {
+  /// Cell update rule for integrated beams.
+  core::MapUpdateMode updateMode = core::MapUpdateMode::kOverwrite;
+  /// Log-odds increments, clamps, and thresholds used by MapUpdateMode::kLogOdds.
+  core::LogOddsParams logOdds{};
+  /// True to give each cell at most one free and one occupied update per scan.
+  bool deduplicateScanUpdates = false;
+  /// Free-space rasterization; kVisibilityPolygon covers the gaps between sparse beams.
+  core::IntegrationMode integrationMode = core::IntegrationMode::kBeams;
+  /// Cell memory order; kTiled and kMorton keep 2D neighbourhoods within a few cache lines on large maps.
+  core::MapLayout layout = core::MapLayout::kRowMajor;
+};
+
+/**
+ * @brief Scan-matching pose tracking parameters.
+ */
+struct TrackingConfig {
+  /// True to build the map at poses matched against it instead of the input-driven pose.
+  bool enabled = false;
+  /// Translation search half-width around the odometry prediction, in grid cells.
+  int linearWindow = 4;
+  /// Rotation search half-width around the odometry prediction, in radians.
+  double angularWindow = 0.2;
+  /// Standard deviation of simulated odometry noise per frame of motion, in grid units.
+  double odometryNoise = 0.0;
+  /// Standard deviation of simulated heading noise per frame of motion, in radians.
+  double headingNoise = 0.0;
 };
 
 /**
@@ -56,8 +97,20 @@ struct AppConfig {
   ScreenConfig screen{};
   WorldConfig world{};
   LidarConfig lidar{};
+  MapConfig map{};
+  TrackingConfig tracking{};
   MotionConfig motion{};
 
+  /**
+   * @brief Pose tracker options of the tracking configuration.
+   */
+  core::PoseTrackerOptions TrackerOptions() const {
+    return core::PoseTrackerOptions{
+        .matcher = {.linearWindow = tracking.linearWindow, .angularWindow = tracking.angularWindow},
+        .odometryNoise = tracking.odometryNoise,
+        .headingNoise = tracking.headingNoise};
+  }
+
   /**
    * @brief Return the default app configuration.
    */
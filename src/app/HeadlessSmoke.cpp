@@ -6,8 +6,11 @@
 #include "app/HeadlessSmoke.h"
 
 #include <cmath>
+#include <cstdint>
 
 #include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/ScanMatcher.h"
 #include "core/SimulatedLidar.h"
 #include "core/Types.h"
 #include "world/WorldLoader.h"
@@ -26,13 +29,24 @@ int RunHeadlessSmoke(const AppConfig& config, int steps) {
   }
 
   core::WorldGrid world = world::BuildDemoWorld(config.world.width, config.world.height);
-  core::OccupancyGridMap map(config.world.width, config.world.height);
-  core::SimulatedLidar lidar(config.lidar.maxRange, config.lidar.beamCount, config.lidar.stepSize);
+  world.SetLayout(config.world.layout);
+  core::OccupancyGridMap map(config.world.width, config.world.height, config.map.updateMode, config.map.logOdds);
+  map.SetDeduplicateScanUpdates(config.map.deduplicateScanUpdates);
+  map.SetIntegrationMode(config.map.integrationMode);
+  map.SetLayout(config.map.layout);
+  map.SetMaintainPyramid(config.tracking.enabled);
+  core::SimulatedLidar lidar(config.lidar.maxRange, config.lidar.beamCount, config.lidar.stepSize, config.lidar.mode);
   core::RobotPose pose{10.0, 10.0, 0.0};
+  core::ScanBuffer scan(lidar.BeamCount());
+  core::PoseTracker tracker(config.TrackerOptions(), pose);
 
   for (int i = 0; i < steps; ++i) {
-    const auto scan = lidar.Scan(world, pose);
-    map.IntegrateScan(pose, scan);
+    lidar.Scan(world, pose, scan);
+    if (config.tracking.enabled) {
+      map.IntegrateScan(tracker.Track(map, pose, scan), tracker.CorrectedScan());
+    } else {
+      map.IntegrateScan(pose, scan);
+    }
 
     const double phase = static_cast<double>(i % 4);
     const double vx = (phase < 2.0) ? 0.5 : -0.5;
@@ -47,16 +61,8 @@ int RunHeadlessSmoke(const AppConfig& config, int steps) {
     }
   }
 
-  bool hasOccupied = false;
-  bool hasFree = false;
-  for (const auto value : map.Data()) {
-    hasOccupied = hasOccupied || (value == core::kOccupied);
-    hasFree = hasFree || (value == core::kFree);
-    if (hasOccupied && hasFree) {
-      return 0;
-    }
-  }
-  return 1;
+  const core::MapStats stats = map.Stats();
+  return (stats.occupiedCells > 0 && stats.freeCells > 0) ? 0 : 1;
 }
 
 }  // namespace slam::app
@@ -120,18 +120,24 @@ SlamApp::SlamApp(const AppConfig& config)
       windowWidth_(config.world.width * config.screen.worldCellSize),
       windowHeight_(config.world.height * config.screen.worldCellSize),
       world_(core::WorldGrid::WithBorderWalls(config.world.width, config.world.height)),
-      slamMap_(config.world.width, config.world.height),
-      lidar_(config.lidar.maxRange, config.lidar.beamCount, config.lidar.stepSize),
+      slamMap_(config.world.width, config.world.height, config.map.updateMode, config.map.logOdds),
+      lidar_(config.lidar.maxRange, config.lidar.beamCount, config.lidar.stepSize, config.lidar.mode),
+      scanWorkers_(config.lidar.workerThreads),
       pose_({10.0, 10.0, 0.0}),
+      poseTracker_(config.TrackerOptions(), pose_),
       showWorldMap_(config.world.showWorldByDefault) {
   InitWindow(windowWidth_, windowHeight_, "SLAM Understanding (Raylib C++)");
   SetTargetFPS(config_.screen.fps);
+  slamMap_.SetDeduplicateScanUpdates(config_.map.deduplicateScanUpdates);
+  slamMap_.SetIntegrationMode(config_.map.integrationMode);
+  slamMap_.SetLayout(config_.map.layout);
+  slamMap_.SetMaintainPyramid(config_.tracking.enabled);
 #ifdef EMSCRIPTEN
   EnsureWebCanvasFocusable();
   EnsureWebAudioUnlockHooks();
 #endif
   controls_ = ui::CreateUiControlsForWindow(windowWidth_, windowHeight_);
-  hitPixelOccupancy_.assign(static_cast<std::size_t>(windowWidth_ * windowHeight_), 0U);
+  hitPixelOccupancy_.Assign(static_cast<std::size_t>(windowWidth_) * static_cast<std::size_t>(windowHeight_));
   hitLayer_ = LoadRenderTexture(windowWidth_, windowHeight_);
   hitLayerReady_ = (hitLayer_.id != 0U);
   if (hitLayerReady_) {
@@ -139,6 +145,13 @@ SlamApp::SlamApp(const AppConfig& config)
     ClearBackground(BLANK);
     EndTextureMode();
   }
+  mapLayer_ = LoadRenderTexture(windowWidth_, windowHeight_);
+  mapLayerReady_ = (mapLayer_.id != 0U);
+  if (mapLayerReady_) {
+    BeginTextureMode(mapLayer_);
+    ClearBackground(render::Palette::kBackground);
+    EndTextureMode();
+  }
   InitializeWorld();
   const std::string scanPath = ResolveAssetPath("assets/sounds/scan_loop.wav");
   const std::string collisionPath = ResolveAssetPath("assets/sounds/collision_beep.wav");
@@ -170,6 +183,10 @@ SlamApp::~SlamApp() {
     UnloadRenderTexture(hitLayer_);
     hitLayerReady_ = false;
   }
+  if (mapLayerReady_) {
+    UnloadRenderTexture(mapLayer_);
+    mapLayerReady_ = false;
+  }
   if (IsWindowReady()) {
     CloseWindow();
   }
@@ -197,9 +214,10 @@ void SlamApp::InitializeWorld() {
   mazeAssetPresent_ = FileExists(mazePath.c_str());
   if (mazeAssetPresent_) {
     world_ = world::BuildWorldFromImage(mazePath, config_.world.width, config_.world.height);
-    return;
+  } else {
+    world_ = world::BuildDemoWorld(config_.world.width, config_.world.height);
   }
-  world_ = world::BuildDemoWorld(config_.world.width, config_.world.height);
+  world_.SetLayout(config_.world.layout);
 }
 
 /**
@@ -235,6 +253,14 @@ void SlamApp::InitializeAudio() {
  */
 void SlamApp::ResetMap() {
   slamMap_.Reset();
+  poseTracker_.Reset(pose_);
+  // Clearing the texture replaces redrawing every cell the reset marked dirty.
+  slamMap_.ConsumeDirtyRegions(mapDirtyRegions_);
+  if (mapLayerReady_) {
+    BeginTextureMode(mapLayer_);
+    ClearBackground(render::Palette::kBackground);
+    EndTextureMode();
+  }
   ResetAccumulatedHitCache();
   wasAccumulating_ = false;
 }
@@ -426,15 +452,21 @@ void SlamApp::PublishWebDebugState(bool hasKeyboardIntent, bool draggingNow) con
  * @brief Perform one lidar scan and map integration update.
  */
 void SlamApp::UpdateScan() {
-  latestScan_ = lidar_.Scan(world_, pose_);
-  slamMap_.IntegrateScan(pose_, latestScan_);
-  latestRays_ = render::ScanSamplesToPixels(pose_, latestScan_, config_.screen.worldCellSize, 0);
+  lidar_.Scan(world_, pose_, latestScan_, scanWorkers_);
+  if (config_.tracking.enabled) {
+    // The input-driven pose serves as odometry; the map is built at the matched estimate.
+    const core::RobotPose& estimate = poseTracker_.Track(slamMap_, pose_, latestScan_);
+    slamMap_.IntegrateScan(estimate, poseTracker_.CorrectedScan(), scanWorkers_);
+  } else {
+    slamMap_.IntegrateScan(pose_, latestScan_, scanWorkers_);
+  }
+  UpdateMapLayer();
+  render::ScanSamplesToPixels(pose_, latestScan_, config_.screen.worldCellSize, 0, latestRays_);
 
-  std::vector<Vector2> currentHits;
-  currentHits.reserve(latestRays_.size());
+  currentHits_.clear();
   for (const render::PixelRay& ray : latestRays_) {
     if (ray.hit) {
-      currentHits.push_back(ray.end);
+      currentHits_.push_back(ray.end);
     }
   }
 
@@ -443,7 +475,8 @@ void SlamApp::UpdateScan() {
       ResetAccumulatedHitCache();
       wasAccumulating_ = false;
     }
-    hitHistory_ = std::move(currentHits);
+    // Swap keeps both buffers' capacity for the next frame.
+    hitHistory_.swap(currentHits_);
     return;
   }
 
@@ -460,7 +493,7 @@ void SlamApp::UpdateScan() {
     wasAccumulating_ = true;
   }
 
-  for (const Vector2& point : currentHits) {
+  for (const Vector2& point : currentHits_) {
     if (render::TryMarkHitPixel(hitPixelOccupancy_, windowWidth_, windowHeight_, point)) {
       hitHistory_.push_back(point);
       pendingAccumulatedDrawHits_.push_back(point);
@@ -472,7 +505,7 @@ void SlamApp::UpdateScan() {
 void SlamApp::ResetAccumulatedHitCache() {
   hitHistory_.clear();
   pendingAccumulatedDrawHits_.clear();
-  std::fill(hitPixelOccupancy_.begin(), hitPixelOccupancy_.end(), 0U);
+  hitPixelOccupancy_.Clear();
   if (hitLayerReady_) {
     BeginTextureMode(hitLayer_);
     ClearBackground(BLANK);
@@ -492,6 +525,23 @@ void SlamApp::FlushAccumulatedHitDraws() {
   pendingAccumulatedDrawHits_.clear();
 }
 
+/**
+ * @brief Redraw dirty map regions into the persistent map texture.
+ * @note Regions are consumed even while the world view is shown, so the texture is current
+ * whenever the map view comes back.
+ */
+void SlamApp::UpdateMapLayer() {
+  slamMap_.ConsumeDirtyRegions(mapDirtyRegions_);
+  if (!mapLayerReady_ || mapDirtyRegions_.empty()) {
+    return;
+  }
+  BeginTextureMode(mapLayer_);
+  for (const core::GridRect& region : mapDirtyRegions_) {
+    render::DrawMapRegion(slamMap_, config_.screen.worldCellSize, 0, region);
+  }
+  EndTextureMode();
+}
+
 /**
  * @brief Render world/map, rays, hits, robot, and controls.
  */
@@ -501,6 +551,12 @@ void SlamApp::DrawFrame() const {
 
   if (showWorldMap_) {
     render::DrawWorld(world_, config_.screen.worldCellSize, 0);
+  } else if (mapLayerReady_) {
+    DrawTextureRec(
+        mapLayer_.texture,
+        Rectangle{0.0F, 0.0F, static_cast<float>(mapLayer_.texture.width), -static_cast<float>(mapLayer_.texture.height)},
+        Vector2{0.0F, 0.0F},
+        WHITE);
   } else {
     render::DrawMap(slamMap_, config_.screen.worldCellSize, 0);
   }
@@ -526,6 +582,15 @@ void SlamApp::DrawFrame() const {
       6,
       6,
       render::Palette::kRobot);
+  if (config_.tracking.enabled) {
+    const core::RobotPose& estimate = poseTracker_.Estimate();
+    DrawRectangleLines(
+        static_cast<int>(estimate.x * static_cast<float>(config_.screen.worldCellSize)) - 5,
+        static_cast<int>(estimate.y * static_cast<float>(config_.screen.worldCellSize)) - 5,
+        10,
+        10,
+        render::Palette::kRobot);
+  }
 
   const std::string worldText = std::string("WORLD ") + (showWorldMap_ ? "ON" : "OFF") + " (M)";
   const std::string hitText = std::string("GREEN ") + (accumulateHits_ ? "ACC" : "LIVE") + " (G)";
@@ -6,8 +6,11 @@
 
 #include "app/Config.h"
 #include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/ScanMatcher.h"
 #include "core/SimulatedLidar.h"
 #include "core/Types.h"
+#include "core/WorkerPool.h"
 #include "core/WorldGrid.h"
 #include "render/Renderer.h"
 #include "ui/UiControls.h"
@@ -86,6 +89,10 @@ class SlamApp {
    * @brief Flush newly discovered accumulated hits into the hit texture.
    */
   void FlushAccumulatedHitDraws();
+  /**
+   * @brief Redraw the map cells changed since the last frame into the map texture.
+   */
+  void UpdateMapLayer();
   /**
    * @brief Update audio playback state for this frame.
    */
@@ -101,7 +108,9 @@ class SlamApp {
   core::WorldGrid world_;
   core::OccupancyGridMap slamMap_;
   core::SimulatedLidar lidar_;
+  core::WorkerPool scanWorkers_;
   core::RobotPose pose_{};
+  core::PoseTracker poseTracker_;
   ui::UiControls controls_{};
 
   bool showWorldMap_ = false;
@@ -112,10 +121,14 @@ class SlamApp {
   bool wasAccumulating_ = false;
   bool hitLayerReady_ = false;
   RenderTexture2D hitLayer_{};
-  std::vector<unsigned char> hitPixelOccupancy_;
+  bool mapLayerReady_ = false;
+  RenderTexture2D mapLayer_{};
+  std::vector<core::GridRect> mapDirtyRegions_;
+  render::HitPixelCache hitPixelOccupancy_;
   std::vector<Vector2> pendingAccumulatedDrawHits_;
   std::vector<Vector2> hitHistory_;
-  std::vector<core::ScanSample> latestScan_;
+  std::vector<Vector2> currentHits_;
+  core::ScanBuffer latestScan_;
   std::vector<render::PixelRay> latestRays_;
 
   bool audioEnabled_ = false;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file AtomicBitWords.h
+ * @brief Copyable array of atomic 64-bit bitset words.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Bitset words that threads set concurrently, and that copy by value.
+ * @note std::atomic is neither copyable nor movable, so a std::vector of them makes its owner
+ * non-copyable. Copying this array copies each word's current value with a relaxed load;
+ * the source must not be written concurrently, as with any other copied member.
+ */
+class AtomicBitWords {
+ public:
+  AtomicBitWords() = default;
+  /**
+   * @brief Construct with every bit clear.
+   * @param size Number of 64-bit words.
+   */
+  explicit AtomicBitWords(std::size_t size) : words_(size) {}
+  AtomicBitWords(const AtomicBitWords& other) : words_(other.words_.size()) { CopyValues(other); }
+  AtomicBitWords& operator=(const AtomicBitWords& other) {
+    if (this != &other) {
+      words_ = std::vector<std::atomic<std::uint64_t>>(other.words_.size());
+      CopyValues(other);
+    }
+    return *this;
+  }
+  AtomicBitWords(AtomicBitWords&&) noexcept = default;
+  AtomicBitWords& operator=(AtomicBitWords&&) noexcept = default;
+
+  /// @return Number of words.
+  std::size_t Size() const { return words_.size(); }
+  /// @return True when there are no words.
+  bool Empty() const { return words_.empty(); }
+  /// @return One word for atomic access.
+  std::atomic<std::uint64_t>& operator[](std::size_t word) { return words_[word]; }
+  /// @return One word for atomic reads.
+  const std::atomic<std::uint64_t>& operator[](std::size_t word) const { return words_[word]; }
+
+ private:
+  void CopyValues(const AtomicBitWords& other) {
+    for (std::size_t i = 0; i < words_.size(); ++i) {
+      words_[i].store(other.words_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+  }
+
+  std::vector<std::atomic<std::uint64_t>> words_;
+};
+
+}  // namespace slam::core
@@ -0,0 +1,245 @@
+/**
+ * @file BatchedRayMarch.cpp
+ * @brief SIMD lockstep ray march with AVX2, SSE2, WASM SIMD128, and scalar builds.
+ */
+
+#include "core/BatchedRayMarch.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace slam::core {
+namespace {
+
+/**
+ * @brief Raw view of the packed obstacle words for lane-wise lookups.
+ */
+struct ObstacleView {
+  const std::uint64_t* words = nullptr;
+  int wordsPerRow = 0;
+  int width = 0;
+  int height = 0;
+
+  explicit ObstacleView(const WorldGrid& world)
+      : words(world.ObstacleWords().data()),
+        wordsPerRow(world.WordsPerRow()),
+        width(world.Width()),
+        height(world.Height()) {}
+
+  /// Same clamp-to-guard lookup as WorldGrid::IsObstacle.
+  bool Blocked(int x, int y) const {
+    const int paddedX = std::clamp(x, -1, width) + 1;
+    const int paddedY = std::clamp(y, -1, height) + 1;
+    return ((words[paddedY * wordsPerRow + (paddedX >> 6)] >> (paddedX & 63)) & 1U) != 0U;
+  }
+};
+
+#if defined(__AVX2__)
+
+constexpr std::size_t kLanes = 8;
+constexpr const char* kIsa = "avx2";
+
+/**
+ * @brief Test four beam samples against the obstacle bits with one hardware gather.
+ * @return Hit flags in the low four bits.
+ */
+unsigned BlockedMask4(const ObstacleView& view, __m256d originX, __m256d originY, __m256d dirX, __m256d dirY,
+                      __m256d distance) {
+  const __m128i x = _mm256_cvttpd_epi32(_mm256_add_pd(originX, _mm256_mul_pd(dirX, distance)));
+  const __m128i y = _mm256_cvttpd_epi32(_mm256_add_pd(originY, _mm256_mul_pd(dirY, distance)));
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i paddedX = _mm_add_epi32(_mm_min_epi32(_mm_max_epi32(x, _mm_set1_epi32(-1)),
+                                                      _mm_set1_epi32(view.width)), one);
+  const __m128i paddedY = _mm_add_epi32(_mm_min_epi32(_mm_max_epi32(y, _mm_set1_epi32(-1)),
+                                                      _mm_set1_epi32(view.height)), one);
+  const __m128i index =
+      _mm_add_epi32(_mm_mullo_epi32(paddedY, _mm_set1_epi32(view.wordsPerRow)), _mm_srli_epi32(paddedX, 6));
+  const __m256i words = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(view.words), index, 8);
+  const __m256i shift = _mm256_cvtepi32_epi64(_mm_and_si128(paddedX, _mm_set1_epi32(63)));
+  const __m256i bits = _mm256_and_si256(_mm256_srlv_epi64(words, shift), _mm256_set1_epi64x(1));
+  const __m256i blocked = _mm256_cmpeq_epi64(bits, _mm256_set1_epi64x(1));
+  return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(blocked)));
+}
+
+/**
+ * @brief Test all lanes of one batch at a shared distance.
+ * @return Hit flags, bit j for lane j.
+ */
+unsigned BlockedMask(const ObstacleView& view, double originX, double originY, const double* dirX,
+                     const double* dirY, double distance) {
+  const __m256d ox = _mm256_set1_pd(originX);
+  const __m256d oy = _mm256_set1_pd(originY);
+  const __m256d t = _mm256_set1_pd(distance);
+  const unsigned low = BlockedMask4(view, ox, oy, _mm256_loadu_pd(dirX), _mm256_loadu_pd(dirY), t);
+  const unsigned high = BlockedMask4(view, ox, oy, _mm256_loadu_pd(dirX + 4), _mm256_loadu_pd(dirY + 4), t);
+  return low | (high << 4U);
+}
+
+#elif defined(__SSE2__) || defined(__wasm_simd128__)
+
+constexpr std::size_t kLanes = 4;
+#if defined(__SSE2__)
+constexpr const char* kIsa = "sse2";
+#else
+constexpr const char* kIsa = "simd128";
+#endif
+
+/**
+ * @brief Compute the truncated sample cells of four lanes.
+ */
+void SampleCells4(double originX, double originY, const double* dirX, const double* dirY, double distance,
+                  std::int32_t* cellX, std::int32_t* cellY) {
+#if defined(__SSE2__)
+  const __m128d ox = _mm_set1_pd(originX);
+  const __m128d oy = _mm_set1_pd(originY);
+  const __m128d t = _mm_set1_pd(distance);
+  const __m128i x01 = _mm_cvttpd_epi32(_mm_add_pd(ox, _mm_mul_pd(_mm_loadu_pd(dirX), t)));
+  const __m128i x23 = _mm_cvttpd_epi32(_mm_add_pd(ox, _mm_mul_pd(_mm_loadu_pd(dirX + 2), t)));
+  const __m128i y01 = _mm_cvttpd_epi32(_mm_add_pd(oy, _mm_mul_pd(_mm_loadu_pd(dirY), t)));
+  const __m128i y23 = _mm_cvttpd_epi32(_mm_add_pd(oy, _mm_mul_pd(_mm_loadu_pd(dirY + 2), t)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(cellX), _mm_unpacklo_epi64(x01, x23));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(cellY), _mm_unpacklo_epi64(y01, y23));
+#else
+  const v128_t ox = wasm_f64x2_splat(originX);
+  const v128_t oy = wasm_f64x2_splat(originY);
+  const v128_t t = wasm_f64x2_splat(distance);
+  const v128_t x01 = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_add(ox, wasm_f64x2_mul(wasm_v128_load(dirX), t)));
+  const v128_t x23 =
+      wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_add(ox, wasm_f64x2_mul(wasm_v128_load(dirX + 2), t)));
+  const v128_t y01 = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_add(oy, wasm_f64x2_mul(wasm_v128_load(dirY), t)));
+  const v128_t y23 =
+      wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_add(oy, wasm_f64x2_mul(wasm_v128_load(dirY + 2), t)));
+  wasm_v128_store(cellX, wasm_i64x2_shuffle(x01, x23, 0, 2));
+  wasm_v128_store(cellY, wasm_i64x2_shuffle(y01, y23, 0, 2));
+#endif
+}
+
+/**
+ * @brief Test all lanes of one batch at a shared distance.
+ * @return Hit flags, bit j for lane j.
+ * @note Cell math is vectorized; the obstacle word loads are per lane since neither
+ * SSE2 nor SIMD128 has a gather.
+ */
+unsigned BlockedMask(const ObstacleView& view, double originX, double originY, const double* dirX,
+                     const double* dirY, double distance) {
+  alignas(16) std::int32_t cellX[kLanes];
+  alignas(16) std::int32_t cellY[kLanes];
+  SampleCells4(originX, originY, dirX, dirY, distance, cellX, cellY);
+  unsigned mask = 0;
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    mask |= view.Blocked(cellX[lane], cellY[lane]) ? (1U << lane) : 0U;
+  }
+  return mask;
+}
+
+#else
+
+constexpr std::size_t kLanes = 1;
+constexpr const char* kIsa = "scalar";
+
+#endif
+
+/**
+ * @brief March one beam; the reference the lockstep kernel must reproduce.
+ */
+void MarchOne(const ObstacleView& view, double originX, double originY, double dirX, double dirY, double stepSize,
+              double maxRange, double& distanceOut, bool& hitOut) {
+  double distance = stepSize;
+  while (distance <= maxRange) {
+    const int x = static_cast<int>(originX + dirX * distance);
+    const int y = static_cast<int>(originY + dirY * distance);
+    if (view.Blocked(x, y)) {
+      distanceOut = distance;
+      hitOut = true;
+      return;
+    }
+    distance += stepSize;
+  }
+  distanceOut = maxRange;
+  hitOut = false;
+}
+
+}  // namespace
+
+/**
+ * @brief March beams in lockstep batches, finishing any remainder with the scalar march.
+ */
+void RayMarchBeams(
+    const WorldGrid& world,
+    double originX,
+    double originY,
+    std::span<const double> dirX,
+    std::span<const double> dirY,
+    double stepSize,
+    double maxRange,
+    std::span<double> distances,
+    std::span<bool> hits) {
+  const ObstacleView view(world);
+  std::size_t begin = 0;
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__wasm_simd128__)
+  constexpr unsigned kAllLanes = (1U << kLanes) - 1U;
+  for (; begin + kLanes <= dirX.size(); begin += kLanes) {
+    unsigned active = kAllLanes;
+    double distance = stepSize;
+    while (active != 0U && distance <= maxRange) {
+      unsigned retired =
+          BlockedMask(view, originX, originY, dirX.data() + begin, dirY.data() + begin, distance) & active;
+      active &= ~retired;
+      while (retired != 0U) {
+        const std::size_t lane = static_cast<std::size_t>(std::countr_zero(retired));
+        distances[begin + lane] = distance;
+        hits[begin + lane] = true;
+        retired &= retired - 1U;
+      }
+      distance += stepSize;
+    }
+    while (active != 0U) {
+      const std::size_t lane = static_cast<std::size_t>(std::countr_zero(active));
+      distances[begin + lane] = maxRange;
+      hits[begin + lane] = false;
+      active &= active - 1U;
+    }
+  }
+#endif
+  for (; begin < dirX.size(); ++begin) {
+    MarchOne(view, originX, originY, dirX[begin], dirY[begin], stepSize, maxRange, distances[begin], hits[begin]);
+  }
+}
+
+/**
+ * @brief March each beam independently.
+ */
+void RayMarchBeamsScalar(
+    const WorldGrid& world,
+    double originX,
+    double originY,
+    std::span<const double> dirX,
+    std::span<const double> dirY,
+    double stepSize,
+    double maxRange,
+    std::span<double> distances,
+    std::span<bool> hits) {
+  const ObstacleView view(world);
+  for (std::size_t i = 0; i < dirX.size(); ++i) {
+    MarchOne(view, originX, originY, dirX[i], dirY[i], stepSize, maxRange, distances[i], hits[i]);
+  }
+}
+
+std::size_t RayMarchBatchWidth() {
+  return kLanes;
+}
+
+const char* RayMarchBatchIsa() {
+  return kIsa;
+}
+
+}  // namespace slam::core
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "core/WorldGrid.h"
+
+/**
+ * @file BatchedRayMarch.h
+ * @brief Fixed-step ray march that advances several beams in lockstep with SIMD.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief March beams from one origin, several lanes at a time.
+ * @param world Ground-truth world grid.
+ * @param originX Beam origin X in grid units.
+ * @param originY Beam origin Y in grid units.
+ * @param dirX Beam direction X components.
+ * @param dirY Beam direction Y components, same length as dirX.
+ * @param stepSize Distance between samples along each beam.
+ * @param maxRange Maximum beam range.
+ * @param distances Receives the first blocked sample distance, or maxRange on a miss.
+ * @param hits Receives true for beams that reached an obstacle.
+ * @note Lanes share one accumulated distance sequence and compute sample cells with the
+ * same multiply-then-add as the scalar march, so results are bit-identical to
+ * RayMarchBeamsScalar. Lanes retire as they hit; a batch ends when all lanes retired.
+ */
+void RayMarchBeams(
+    const WorldGrid& world,
+    double originX,
+    double originY,
+    std::span<const double> dirX,
+    std::span<const double> dirY,
+    double stepSize,
+    double maxRange,
+    std::span<double> distances,
+    std::span<bool> hits);
+
+/**
+ * @brief Scalar reference for RayMarchBeams, one beam at a time.
+ */
+void RayMarchBeamsScalar(
+    const WorldGrid& world,
+    double originX,
+    double originY,
+    std::span<const double> dirX,
+    std::span<const double> dirY,
+    double stepSize,
+    double maxRange,
+    std::span<double> distances,
+    std::span<bool> hits);
+
+/// @return Number of beams RayMarchBeams advances in lockstep on this build.
+std::size_t RayMarchBatchWidth();
+/// @return Instruction set used by RayMarchBeams on this build ("avx2", "sse2", "simd128", or "scalar").
+const char* RayMarchBatchIsa();
+
+}  // namespace slam::core
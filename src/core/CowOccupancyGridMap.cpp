@@ -0,0 +1,232 @@
+/**
+ * @file CowOccupancyGridMap.cpp
+ * @brief Copy-on-write tiled occupancy integration.
+ */
+
+#include "core/CowOccupancyGridMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "core/GridLine.h"
+#include "core/OccupancyCell.h"
+
+namespace slam::core {
+
+/**
+ * @brief Construct an unknown map with no tiles allocated.
+ * @param width Map width in cells.
+ * @param height Map height in cells.
+ * @param mode Cell update rule.
+ * @param logOdds Log-odds parameters used by MapUpdateMode::kLogOdds.
+ */
+CowOccupancyGridMap::CowOccupancyGridMap(int width, int height, MapUpdateMode mode, const LogOddsParams& logOdds)
+    : width_(width), height_(height), mode_(mode), logOdds_(logOdds) {
+  if (width <= 0 || height <= 0) {
+    throw std::invalid_argument("CowOccupancyGridMap dimensions must be positive");
+  }
+  if (mode == MapUpdateMode::kLogOdds) {
+    ValidateLogOddsParams(logOdds, "CowOccupancyGridMap");
+  }
+  tilesPerRow_ = static_cast<std::size_t>((width + kTileSize - 1) >> kTileShift);
+  tiles_.resize(tilesPerRow_ * static_cast<std::size_t>((height + kTileSize - 1) >> kTileShift));
+  owned_.assign(tiles_.size(), 0U);
+}
+
+/**
+ * @brief Copy a map by sharing its tiles.
+ * @param other Map to copy; its tiles become shared too.
+ */
+CowOccupancyGridMap::CowOccupancyGridMap(const CowOccupancyGridMap& other)
+    : width_(other.width_),
+      height_(other.height_),
+      mode_(other.mode_),
+      logOdds_(other.logOdds_),
+      tilesPerRow_(other.tilesPerRow_),
+      tiles_(other.tiles_),
+      owned_(other.owned_.size(), 0U) {
+  std::fill(other.owned_.begin(), other.owned_.end(), 0U);
+}
+
+/**
+ * @brief Replace this map with a copy sharing another map's tiles.
+ * @param other Map to copy; its tiles become shared too.
+ * @return This map.
+ */
+CowOccupancyGridMap& CowOccupancyGridMap::operator=(const CowOccupancyGridMap& other) {
+  if (this != &other) {
+    width_ = other.width_;
+    height_ = other.height_;
+    mode_ = other.mode_;
+    logOdds_ = other.logOdds_;
+    tilesPerRow_ = other.tilesPerRow_;
+    tiles_ = other.tiles_;
+    owned_.assign(other.owned_.size(), 0U);
+    std::fill(other.owned_.begin(), other.owned_.end(), 0U);
+  }
+  return *this;
+}
+
+/**
+ * @brief Drop every tile reference; tiles shared with copies stay alive for them.
+ */
+void CowOccupancyGridMap::Reset() {
+  std::fill(tiles_.begin(), tiles_.end(), nullptr);
+  std::fill(owned_.begin(), owned_.end(), 0U);
+}
+
+/**
+ * @brief Read map value at a coordinate.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return Raw cell value, or the unknown value outside the map and in unwritten tiles.
+ */
+std::int16_t CowOccupancyGridMap::ValueAt(int x, int y) const {
+  if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+    return UnknownCellValue(mode_);
+  }
+  const TilePtr& tile = tiles_[TileOf(x, y)];
+  return tile ? (*tile)[CellInTile(x, y)] : UnknownCellValue(mode_);
+}
+
+/**
+ * @brief Read a map cell thresholded to kUnknown, kFree, or kOccupied.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return Occupancy state value.
+ */
+std::int16_t CowOccupancyGridMap::ClassifiedValueAt(int x, int y) const {
+  return ClassifyCellValue(mode_, logOdds_, ValueAt(x, y));
+}
+
+/**
+ * @brief Integrate one lidar scan, computing each endpoint from the pose.
+ * @param pose Robot pose.
+ * @param scan Scan samples to fuse.
+ */
+void CowOccupancyGridMap::IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan) {
+  const int startX = static_cast<int>(pose.x);
+  const int startY = static_cast<int>(pose.y);
+  WithCellUpdateRules(mode_, logOdds_, [&](auto miss, auto onHit) {
+    for (const ScanSample& sample : scan) {
+      const double angle = pose.theta + sample.relativeAngle;
+      IntegrateBeam(startX, startY, static_cast<int>(pose.x + std::cos(angle) * sample.distance),
+                    static_cast<int>(pose.y + std::sin(angle) * sample.distance), sample.hit, miss, onHit);
+    }
+  });
+}
+
+/**
+ * @brief Integrate one struct-of-arrays scan from its stored endpoints.
+ * @param pose Robot pose.
+ * @param scan Scan with world-space endpoints.
+ */
+void CowOccupancyGridMap::IntegrateScan(const RobotPose& pose, const ScanBuffer& scan) {
+  const int startX = static_cast<int>(pose.x);
+  const int startY = static_cast<int>(pose.y);
+  WithCellUpdateRules(mode_, logOdds_, [&](auto miss, auto onHit) {
+    for (std::size_t i = 0; i < scan.Size(); ++i) {
+      IntegrateBeam(startX, startY, static_cast<int>(scan.EndX()[i]), static_cast<int>(scan.EndY()[i]), scan.Hit(i),
+                    miss, onHit);
+    }
+  });
+}
+
+/**
+ * @brief Count tiles with cell storage.
+ */
+std::size_t CowOccupancyGridMap::AllocatedTiles() const {
+  return static_cast<std::size_t>(std::count_if(tiles_.begin(), tiles_.end(), [](const TilePtr& tile) { return tile != nullptr; }));
+}
+
+/**
+ * @brief Count tiles this map owns.
+ */
+std::size_t CowOccupancyGridMap::ExclusiveTiles() const {
+  return static_cast<std::size_t>(std::count(owned_.begin(), owned_.end(), std::uint8_t{1}));
+}
+
+/**
+ * @brief Tile storage with every shared tile split evenly among its owners.
+ */
+double CowOccupancyGridMap::SharedCellBytes() const {
+  double bytes = 0.0;
+  for (const TilePtr& tile : tiles_) {
+    if (tile != nullptr) {
+      bytes += static_cast<double>(sizeof(TileCells)) / static_cast<double>(tile.use_count());
+    }
+  }
+  return bytes;
+}
+
+/**
+ * @brief Walk one beam clipped to the map and apply the given cell updates.
+ * @param startX Robot cell X.
+ * @param startY Robot cell Y.
+ * @param endX Beam end cell X.
+ * @param endY Beam end cell Y.
+ * @param hit True when the beam terminated on an obstacle.
+ * @param miss Update applied to every ray cell.
+ * @param onHit Update applied to the end cell when the beam hit.
+ * @note A cell is only stored back when the update changes it, so confirming a saturated
+ * or already-free cell never clones a tile this map does not own. Consecutive cells of a beam usually
+ * share a tile, so the tile lookup is cached across them.
+ */
+template <typename MissFn, typename HitFn>
+void CowOccupancyGridMap::IntegrateBeam(
+    int startX, int startY, int endX, int endY, bool hit, MissFn&& miss, HitFn&& onHit) {
+  std::size_t cachedTile = std::numeric_limits<std::size_t>::max();
+  std::int16_t* cells = nullptr;
+  bool writable = false;
+  const auto apply = [&](int x, int y, auto& rule) {
+    const std::size_t tile = TileOf(x, y);
+    if (tile != cachedTile) {
+      cachedTile = tile;
+      cells = tiles_[tile] ? tiles_[tile]->data() : nullptr;
+      writable = false;
+    }
+    const std::size_t offset = CellInTile(x, y);
+    const std::int16_t before = (cells != nullptr) ? cells[offset] : UnknownCellValue(mode_);
+    std::int16_t value = before;
+    rule(value);
+    if (value != before) {
+      if (!writable) {
+        cells = WritableTile(tile);
+        writable = true;
+      }
+      cells[offset] = value;
+    }
+  };
+
+  // The robot cell (step 0) is never freed and a hit's end cell gets the hit update instead.
+  const GridRect bounds{.xBegin = 0, .yBegin = 0, .xEnd = width_, .yEnd = height_};
+  const int length = GridLineLength(startX, startY, endX, endY);
+  VisitGridLine(startX, startY, endX, endY, 1, hit ? length : length + 1, bounds, [&](int x, int y) { apply(x, y, miss); });
+  if (hit && endX >= 0 && endY >= 0 && endX < width_ && endY < height_) {
+    apply(endX, endY, onHit);
+  }
+}
+
+/**
+ * @brief Make a tile owned by this map before writing it.
+ * @param tile Tile index.
+ * @return Writable cells of the tile.
+ * @note Ownership is decided by the flags alone, never by the reference count: a tile this
+ * map does not own may still be read by a copy being integrated on another thread, so it is
+ * cloned even when the copies referencing it have since dropped it.
+ */
+std::int16_t* CowOccupancyGridMap::WritableTile(std::size_t tile) {
+  TilePtr& slot = tiles_[tile];
+  if (slot == nullptr) {
+    slot = std::make_shared<TileCells>();
+    slot->fill(UnknownCellValue(mode_));
+  } else if (owned_[tile] == 0U) {
+    slot = std::make_shared<TileCells>(*slot);
+  }
+  owned_[tile] = 1U;
+  return slot->data();
+}
+
+}  // namespace slam::core
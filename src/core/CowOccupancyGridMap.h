@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "core/GridIndexer.h"
+#include "core/ScanBuffer.h"
+#include "core/Types.h"
+
+/**
+ * @file CowOccupancyGridMap.h
+ * @brief Tiled occupancy map whose copies share tiles until one side writes them.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Bounded occupancy map stored as 16x16 tiles shared copy-on-write between copies.
+ * @note Copying the map copies one tile pointer per tile and bumps its reference count, so
+ * a copy costs O(tiles) instead of O(cells) and holds no cell storage of its own. A scan
+ * writing into a tile that another copy still references first clones that tile; tiles
+ * nobody wrote since the copy stay shared. Never-written tiles are not allocated and read
+ * as unknown. Values follow OccupancyGridMap: kUnknown/kFree/kOccupied in
+ * MapUpdateMode::kOverwrite, clamped log-odds in hundredths in MapUpdateMode::kLogOdds, and
+ * scans update the same cells as OccupancyGridMap's per-beam integration.
+ *
+ * Each map flags the tiles it owns. Only owned tiles are written in place; copying a map
+ * clears the flags on both sides, so a tile reachable from two maps is never written, only
+ * cloned. Copies may then be integrated concurrently. Copying reads and clears the source's
+ * flags, so a map must not be copied while it is integrated.
+ */
+class CowOccupancyGridMap {
+ public:
+  /// Tile edge length is 1 << kTileShift cells, the same tiles as OccupancyGridMap's dirty regions.
+  static constexpr int kTileShift = GridIndexer::kTileShift;
+  /// Tile edge length in cells.
+  static constexpr int kTileSize = 1 << kTileShift;
+  /// Cells per tile.
+  static constexpr std::size_t kTileCells = static_cast<std::size_t>(kTileSize) * kTileSize;
+
+  /**
+   * @brief Construct a map initialized to unknown, with no tiles allocated.
+   * @param width Map width in cells.
+   * @param height Map height in cells.
+   * @param mode Cell update rule.
+   * @param logOdds Increments, clamps, and thresholds for MapUpdateMode::kLogOdds.
+   * @throws std::invalid_argument when dimensions are not positive or log-odds mode gets
+   * invalid parameters.
+   */
+  CowOccupancyGridMap(
+      int width, int height, MapUpdateMode mode = MapUpdateMode::kOverwrite, const LogOddsParams& logOdds = {});
+  /**
+   * @brief Share every tile of another map; neither map owns them afterwards.
+   */
+  CowOccupancyGridMap(const CowOccupancyGridMap& other);
+  /**
+   * @brief Drop this map's tiles and share every tile of another map; neither owns them afterwards.
+   */
+  CowOccupancyGridMap& operator=(const CowOccupancyGridMap& other);
+  CowOccupancyGridMap(CowOccupancyGridMap&&) noexcept = default;
+  CowOccupancyGridMap& operator=(CowOccupancyGridMap&&) noexcept = default;
+
+  /// Release this map's references to every tile; all cells read as unknown.
+  void Reset();
+  /// Read one raw cell value; unknown outside the map and in unallocated tiles.
+  std::int16_t ValueAt(int x, int y) const;
+  /// Read one cell as kUnknown, kFree, or kOccupied in either update mode.
+  std::int16_t ClassifiedValueAt(int x, int y) const;
+  /**
+   * @brief Integrate one lidar scan, computing endpoints from the pose.
+   * @param pose Robot pose at scan time.
+   * @param scan Beam samples.
+   */
+  void IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan);
+  /**
+   * @brief Integrate one lidar scan using its precomputed world-space endpoints.
+   * @param pose Robot pose at scan time.
+   * @param scan Struct-of-arrays scan with endpoints.
+   */
+  void IntegrateScan(const RobotPose& pose, const ScanBuffer& scan);
+
+  /// @return Map width in cells.
+  int Width() const { return width_; }
+  /// @return Map height in cells.
+  int Height() const { return height_; }
+  /// @return Tiles covering the map, allocated or not.
+  std::size_t TileCount() const { return tiles_.size(); }
+  /// @return Tiles with cell storage, shared or not.
+  std::size_t AllocatedTiles() const;
+  /// @return Tiles this map owns and writes in place; the rest are cloned on their next write.
+  std::size_t ExclusiveTiles() const;
+  /**
+   * @brief Bytes of tile storage, each tile divided by the number of maps referencing it.
+   * @note Summed over a set of maps that only share tiles among themselves, this is their
+   * total cell storage. Excludes the tile pointer table, see TableBytes(). Reads reference
+   * counts, so it is a statistic only while no copy is integrated.
+   */
+  double SharedCellBytes() const;
+  /// @return Bytes of the tile pointer table and ownership flags every copy carries.
+  std::size_t TableBytes() const { return tiles_.size() * (sizeof(TilePtr) + sizeof(std::uint8_t)); }
+  /// @return Cell update rule.
+  MapUpdateMode UpdateMode() const { return mode_; }
+  /// @return Log-odds parameters; only used in MapUpdateMode::kLogOdds.
+  const LogOddsParams& LogOdds() const { return logOdds_; }
+
+ private:
+  using TileCells = std::array<std::int16_t, kTileCells>;
+  using TilePtr = std::shared_ptr<TileCells>;
+
+  /**
+   * @brief Walk one beam and apply the given cell updates; same cells as OccupancyGridMap.
+   */
+  template <typename MissFn, typename HitFn>
+  void IntegrateBeam(int startX, int startY, int endX, int endY, bool hit, MissFn&& miss, HitFn&& onHit);
+  /**
+   * @brief Return a tile's cells for writing, allocating it or cloning one this map does not own.
+   */
+  std::int16_t* WritableTile(std::size_t tile);
+  /**
+   * @brief Index of the tile holding an in-range cell.
+   */
+  std::size_t TileOf(int x, int y) const {
+    return static_cast<std::size_t>(y >> kTileShift) * tilesPerRow_ + static_cast<std::size_t>(x >> kTileShift);
+  }
+  /**
+   * @brief Offset of an in-range cell within its tile.
+   */
+  static std::size_t CellInTile(int x, int y) {
+    return static_cast<std::size_t>(((y & (kTileSize - 1)) << kTileShift) | (x & (kTileSize - 1)));
+  }
+
+  int width_ = 0;
+  int height_ = 0;
+  MapUpdateMode mode_ = MapUpdateMode::kOverwrite;
+  LogOddsParams logOdds_{};
+  std::size_t tilesPerRow_ = 0;
+  /// Row-major tiles; null until first written.
+  std::vector<TilePtr> tiles_;
+  /// Per tile, 1 when no other map can reach it and it may be written in place. Copies clear it.
+  mutable std::vector<std::uint8_t> owned_;
+};
+
+}  // namespace slam::core
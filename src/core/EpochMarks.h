@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file EpochMarks.h
+ * @brief Per-slot marks whose clear is a counter bump instead of a buffer fill.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Fixed-size set of marked slots with an amortized O(1) Clear().
+ * @tparam Epoch Unsigned stamp type. A slot is marked when its stamp equals the current
+ * epoch, so Clear() only advances the epoch; the stamps are zeroed once every time the
+ * epoch wraps. A narrow type keeps memory at one stamp per slot, a wide one makes the
+ * wrap-around fill rarer.
+ */
+template <typename Epoch>
+class EpochMarks {
+ public:
+  EpochMarks() = default;
+  /**
+   * @brief Construct with every slot unmarked.
+   * @param size Number of slots.
+   */
+  explicit EpochMarks(std::size_t size) : stamps_(size, Epoch{0}) {}
+
+  /// Resize to size slots, all unmarked.
+  void Assign(std::size_t size) {
+    stamps_.assign(size, Epoch{0});
+    epoch_ = 1;
+  }
+  /// @return Number of slots.
+  std::size_t Size() const { return stamps_.size(); }
+  /// @return True when slot was marked since the last Clear().
+  bool IsMarked(std::size_t slot) const { return stamps_[slot] == epoch_; }
+  /**
+   * @brief Mark one slot.
+   * @return True when the slot was not marked before.
+   */
+  bool Mark(std::size_t slot) {
+    if (stamps_[slot] == epoch_) {
+      return false;
+    }
+    stamps_[slot] = epoch_;
+    return true;
+  }
+  /// Unmark every slot.
+  void Clear() {
+    if (++epoch_ == Epoch{0}) {
+      std::fill(stamps_.begin(), stamps_.end(), Epoch{0});
+      epoch_ = 1;
+    }
+  }
+
+ private:
+  std::vector<Epoch> stamps_;
+  Epoch epoch_ = 1;
+};
+
+}  // namespace slam::core
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "core/Types.h"
+
+/**
+ * @file GridIndexer.h
+ * @brief Cell-to-buffer index mapping of the row-major, tiled, and Morton grid layouts.
+ */
+
+namespace slam::core {
+
+namespace detail {
+
+/**
+ * @brief Table spreading the 8 bits of a byte to the even bits of a 16-bit value.
+ */
+constexpr std::array<std::uint16_t, 256> BuildMortonSpreadTable() {
+  std::array<std::uint16_t, 256> table{};
+  for (std::uint32_t value = 0; value < 256U; ++value) {
+    std::uint32_t spread = 0;
+    for (std::uint32_t bit = 0; bit < 8U; ++bit) {
+      spread |= ((value >> bit) & 1U) << (2U * bit);
+    }
+    table[value] = static_cast<std::uint16_t>(spread);
+  }
+  return table;
+}
+
+inline constexpr std::array<std::uint16_t, 256> kMortonSpread = BuildMortonSpreadTable();
+
+}  // namespace detail
+
+/**
+ * @brief Interleave the bits of x (even positions) and y (odd positions).
+ * @note Uses BMI2 pdep when the compiler targets it (e.g. -mbmi2 or -march=native), and a
+ * byte table otherwise; both give the same code.
+ */
+inline std::uint64_t MortonEncode(std::uint32_t x, std::uint32_t y) {
+#if defined(__BMI2__)
+  return _pdep_u64(x, 0x5555555555555555ULL) | _pdep_u64(y, 0xAAAAAAAAAAAAAAAAULL);
+#else
+  const auto spread16 = [](std::uint32_t value) {
+    return static_cast<std::uint64_t>(detail::kMortonSpread[value & 0xFFU]) |
+           (static_cast<std::uint64_t>(detail::kMortonSpread[(value >> 8U) & 0xFFU]) << 16U);
+  };
+  std::uint64_t code = spread16(x) | (spread16(y) << 1U);
+  // Grid coordinates rarely reach 16 bits, so the upper halves are usually skipped.
+  if (((x | y) >> 16U) != 0U) {
+    code |= (spread16(x >> 16U) | (spread16(y >> 16U) << 1U)) << 32U;
+  }
+  return code;
+#endif
+}
+
+/**
+ * @brief Maps in-bounds cell coordinates of a width x height grid to buffer indices.
+ * @note Row-major is y * width + x. Tiled stores 16x16 tiles contiguously, tiles in
+ * row-major order. Morton rounds both sides up to powers of two, interleaves the bits the
+ * two sides share, and puts the longer side's remaining bits on top, so a non-square grid
+ * costs at most 4x its cell count rather than the square of its longer side.
+ */
+class GridIndexer {
+ public:
+  /// Tile edge length of MapLayout::kTiled is 1 << kTileShift cells.
+  static constexpr int kTileShift = 4;
+
+  GridIndexer() = default;
+  /**
+   * @brief Index cells of a grid in one layout.
+   * @param layout Memory order.
+   * @param width Grid width in cells, positive.
+   * @param height Grid height in cells, positive.
+   */
+  GridIndexer(MapLayout layout, int width, int height)
+      : layout_(layout),
+        width_(static_cast<std::size_t>(width)),
+        height_(static_cast<std::size_t>(height)),
+        tilesPerRow_((static_cast<std::size_t>(width) + kTileMask) >> kTileShift),
+        tileRows_((static_cast<std::size_t>(height) + kTileMask) >> kTileShift),
+        widthBits_(std::bit_width(static_cast<std::uint32_t>(width - 1))),
+        heightBits_(std::bit_width(static_cast<std::uint32_t>(height - 1))),
+        sharedBits_(std::min(widthBits_, heightBits_)) {}
+
+  /// @return Memory order.
+  MapLayout Layout() const { return layout_; }
+  /// @return Buffer index of an in-bounds cell.
+  std::size_t Index(int x, int y) const {
+    const auto column = static_cast<std::size_t>(x);
+    const auto row = static_cast<std::size_t>(y);
+    switch (layout_) {
+      case MapLayout::kTiled: {
+        const std::size_t tile = (row >> kTileShift) * tilesPerRow_ + (column >> kTileShift);
+        return (tile << (2 * kTileShift)) | ((row & kTileMask) << kTileShift) | (column & kTileMask);
+      }
+      case MapLayout::kMorton: {
+        const std::uint32_t sharedMask = (std::uint32_t{1} << sharedBits_) - 1U;
+        const auto low = static_cast<std::size_t>(MortonEncode(static_cast<std::uint32_t>(x) & sharedMask,
+                                                               static_cast<std::uint32_t>(y) & sharedMask));
+        // Only the longer side has coordinates at or above 1 << sharedBits_.
+        const std::size_t high = (column >> sharedBits_) | (row >> sharedBits_);
+        return (high << (2 * sharedBits_)) | low;
+      }
+      case MapLayout::kRowMajor:
+        break;
+    }
+    return row * width_ + column;
+  }
+  /// @return Buffer cells the layout needs, including tile or power-of-two padding.
+  std::size_t StorageSize() const {
+    switch (layout_) {
+      case MapLayout::kTiled:
+        return (tileRows_ * tilesPerRow_) << (2 * kTileShift);
+      case MapLayout::kMorton:
+        return std::size_t{1} << (widthBits_ + heightBits_);
+      case MapLayout::kRowMajor:
+        break;
+    }
+    return width_ * height_;
+  }
+
+ private:
+  static constexpr std::size_t kTileMask = (std::size_t{1} << kTileShift) - 1U;
+
+  MapLayout layout_ = MapLayout::kRowMajor;
+  std::size_t width_ = 0;
+  std::size_t height_ = 0;
+  std::size_t tilesPerRow_ = 0;
+  std::size_t tileRows_ = 0;
+  int widthBits_ = 0;
+  int heightBits_ = 0;
+  int sharedBits_ = 0;
+};
+
+}  // namespace slam::core
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ * @file GridLine.h
+ * @brief Allocation-free Bresenham line visitor with per-line rectangle clipping.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Half-open cell rectangle [xBegin, xEnd) x [yBegin, yEnd).
+ */
+struct GridRect {
+  int xBegin = 0;
+  int yBegin = 0;
+  int xEnd = 0;
+  int yEnd = 0;
+};
+
+/// @return Number of steps on the Bresenham line between two cells (cell count minus one).
+inline int GridLineLength(int x0, int y0, int x1, int y1) {
+  return std::max(std::abs(x1 - x0), std::abs(y1 - y0));
+}
+
+/**
+ * @brief Visit the cells of the Bresenham line from (x0, y0) to (x1, y1) that fall in a rectangle.
+ * @param x0 Start cell X.
+ * @param y0 Start cell Y.
+ * @param x1 End cell X.
+ * @param y1 End cell Y.
+ * @param stepBegin First step index to visit; step 0 is the start cell.
+ * @param stepEnd One past the last step index to visit; GridLineLength() + 1 includes the end cell.
+ * @param clip Cells outside this rectangle are skipped.
+ * @param visit Callable taking (x, y), called in line order.
+ * @note Visits the same cells as the classic all-octant integer loop. Step k of a line with
+ * major extent dM and minor extent dm sits at minor offset floor((2*k*dm + dM - 1) / (2*dM)),
+ * so clipping solves the rectangle bounds for k once, Liang-Barsky style, and the loop
+ * itself carries no bounds checks.
+ */
+template <typename Visitor>
+void VisitGridLine(int x0, int y0, int x1, int y1, int stepBegin, int stepEnd, const GridRect& clip, Visitor&& visit) {
+  const long long dx = std::abs(static_cast<long long>(x1) - x0);
+  const long long dy = std::abs(static_cast<long long>(y1) - y0);
+  const bool xMajor = dx >= dy;
+  const long long majorExtent = xMajor ? dx : dy;
+  const long long minorExtent = xMajor ? dy : dx;
+  const long long majorStart = xMajor ? x0 : y0;
+  const long long minorStart = xMajor ? y0 : x0;
+  const long long majorDir = (xMajor ? (x0 < x1) : (y0 < y1)) ? 1 : -1;
+  const long long minorDir = (xMajor ? (y0 < y1) : (x0 < x1)) ? 1 : -1;
+  const long long majorLow = xMajor ? clip.xBegin : clip.yBegin;
+  const long long majorHigh = (xMajor ? clip.xEnd : clip.yEnd) - 1LL;
+  const long long minorLow = xMajor ? clip.yBegin : clip.xBegin;
+  const long long minorHigh = (xMajor ? clip.yEnd : clip.xEnd) - 1LL;
+
+  long long kLow = std::max<long long>(stepBegin, 0);
+  long long kHigh = std::min<long long>(stepEnd, majorExtent + 1) - 1;
+
+  // Major coordinate is majorStart + majorDir * k.
+  if (majorDir > 0) {
+    kLow = std::max(kLow, majorLow - majorStart);
+    kHigh = std::min(kHigh, majorHigh - majorStart);
+  } else {
+    kLow = std::max(kLow, majorStart - majorHigh);
+    kHigh = std::min(kHigh, majorStart - majorLow);
+  }
+
+  // Minor coordinate is minorStart + minorDir * m(k) with m(k) non-decreasing.
+  const long long mLow = (minorDir > 0) ? (minorLow - minorStart) : (minorStart - minorHigh);
+  const long long mHigh = (minorDir > 0) ? (minorHigh - minorStart) : (minorStart - minorLow);
+  if (mHigh < 0 || mLow > mHigh) {
+    return;
+  }
+  if (minorExtent == 0) {
+    if (mLow > 0) {
+      return;
+    }
+  } else {
+    const long long twiceMinor = 2 * minorExtent;
+    if (mLow > 0) {
+      // m(k) >= mLow  <=>  k >= ceil((2*dM*mLow - dM + 1) / (2*dm)).
+      kLow = std::max(kLow, (2 * majorExtent * mLow - majorExtent + 1 + twiceMinor - 1) / twiceMinor);
+    }
+    // m(k) <= mHigh  <=>  k <= floor((2*dM*(mHigh + 1) - dM) / (2*dm)).
+    kHigh = std::min(kHigh, (2 * majorExtent * (mHigh + 1) - majorExtent) / twiceMinor);
+  }
+  if (kLow > kHigh) {
+    return;
+  }
+
+  if (majorExtent == 0) {
+    visit(x0, y0);
+    return;
+  }
+  const long long twiceMajor = 2 * majorExtent;
+  const long long numerator = 2 * kLow * minorExtent + majorExtent - 1;
+  long long minorOffset = numerator / twiceMajor;
+  long long remainder = numerator % twiceMajor;
+  long long major = majorStart + majorDir * kLow;
+  for (long long k = kLow; k <= kHigh; ++k) {
+    const int minor = static_cast<int>(minorStart + minorDir * minorOffset);
+    if (xMajor) {
+      visit(static_cast<int>(major), minor);
+    } else {
+      visit(minor, static_cast<int>(major));
+    }
+    major += majorDir;
+    remainder += 2 * minorExtent;
+    if (remainder >= twiceMajor) {
+      remainder -= twiceMajor;
+      ++minorOffset;
+    }
+  }
+}
+
+/**
+ * @brief Visit every cell of the Bresenham line from (x0, y0) to (x1, y1), both ends included.
+ * @param visit Callable taking (x, y), called in line order.
+ */
+template <typename Visitor>
+void VisitGridLine(int x0, int y0, int x1, int y1, Visitor&& visit) {
+  const GridRect everywhere{
+      .xBegin = std::min(x0, x1), .yBegin = std::min(y0, y1), .xEnd = std::max(x0, x1) + 1, .yEnd = std::max(y0, y1) + 1};
+  VisitGridLine(x0, y0, x1, y1, 0, GridLineLength(x0, y0, x1, y1) + 1, everywhere, visit);
+}
+
+}  // namespace slam::core
@@ -0,0 +1,264 @@
+/**
+ * @file LikelihoodField.cpp
+ * @brief Dynamic brushfire distance field and batched endpoint scoring implementation.
+ */
+
+#include "core/LikelihoodField.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace slam::core {
+
+/**
+ * @brief Convert a scan's hit beams to robot-frame endpoints.
+ * @param scan Scan to convert.
+ */
+void ScanPoints::Assign(const ScanBuffer& scan) {
+  x_.clear();
+  y_.clear();
+  const std::span<const double> angles = scan.RelativeAngles();
+  const std::span<const double> distances = scan.Distances();
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    if (scan.Hit(i)) {
+      x_.push_back(static_cast<float>(std::cos(angles[i]) * distances[i]));
+      y_.push_back(static_cast<float>(std::sin(angles[i]) * distances[i]));
+    }
+  }
+}
+
+/**
+ * @brief Construct an obstacle-free field.
+ * @param width Field width in cells.
+ * @param height Field height in cells.
+ * @param options Distance range and likelihood spread.
+ */
+LikelihoodField::LikelihoodField(int width, int height, const LikelihoodFieldOptions& options)
+    : width_(width), height_(height), options_(options) {
+  if (width <= 0 || height <= 0 ||
+      static_cast<long long>(width) * static_cast<long long>(height) >= std::numeric_limits<std::int32_t>::max()) {
+    throw std::invalid_argument("LikelihoodField dimensions must be positive and fit 32-bit cell indices");
+  }
+  if (!(options.maxDistance >= 1.0) || !(options.sigma > 0.0)) {
+    throw std::invalid_argument("LikelihoodField needs maxDistance >= 1 and a positive sigma");
+  }
+  maxSquared_ = static_cast<std::int32_t>(std::floor(options.maxDistance * options.maxDistance));
+  farDistance_ = maxSquared_ + 1;
+  const std::size_t cells = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+  distances_.assign(cells + 1U, farDistance_);
+  sites_.assign(cells, kNoSite);
+  raising_.assign(cells, 0U);
+  likelihood_.resize(static_cast<std::size_t>(farDistance_) + 1U);
+  for (std::int32_t squared = 0; squared <= maxSquared_; ++squared) {
+    likelihood_[static_cast<std::size_t>(squared)] =
+        static_cast<float>(std::exp(-static_cast<double>(squared) / (2.0 * options.sigma * options.sigma)));
+  }
+  likelihood_.back() = 0.0F;
+  buckets_.resize(static_cast<std::size_t>(maxSquared_) + 1U);
+}
+
+/**
+ * @brief Queue a new obstacle cell.
+ * @param x Cell X.
+ * @param y Cell Y.
+ */
+void LikelihoodField::SetObstacle(int x, int y) {
+  const std::int32_t cell = y * width_ + x;
+  const std::size_t slot = static_cast<std::size_t>(cell);
+  if (sites_[slot] == cell) {
+    return;
+  }
+  // A cell removed and restored before the next update keeps the neighbours that still
+  // point at it, so its pending raise is dropped.
+  raising_[slot] = 0U;
+  sites_[slot] = cell;
+  distances_[slot] = 0;
+  Push(cell, 0);
+}
+
+/**
+ * @brief Queue the removal of an obstacle cell.
+ * @param x Cell X.
+ * @param y Cell Y.
+ */
+void LikelihoodField::RemoveObstacle(int x, int y) {
+  const std::int32_t cell = y * width_ + x;
+  const std::size_t slot = static_cast<std::size_t>(cell);
+  if (sites_[slot] != cell) {
+    return;
+  }
+  ClearCell(slot);
+  raising_[slot] = 1U;
+  Push(cell, 0);
+}
+
+/**
+ * @brief Run the queued raise and lower waves to completion.
+ * @return Queue entries processed.
+ * @note An entry whose cell has since been lowered below its key is stale: the cell was
+ * queued again under the smaller key, so the entry is skipped.
+ */
+std::size_t LikelihoodField::Update() {
+  std::size_t processed = 0;
+  while (queued_ > 0U) {
+    while (buckets_[lowestBucket_].empty()) {
+      ++lowestBucket_;
+    }
+    std::vector<std::int32_t>& bucket = buckets_[lowestBucket_];
+    const std::int32_t cell = bucket.back();
+    bucket.pop_back();
+    --queued_;
+    ++processed;
+    const std::size_t slot = static_cast<std::size_t>(cell);
+    if (raising_[slot] != 0U) {
+      Raise(cell);
+      continue;
+    }
+    const std::int32_t site = sites_[slot];
+    if (site != kNoSite && sites_[static_cast<std::size_t>(site)] == site &&
+        distances_[slot] == static_cast<std::int32_t>(lowestBucket_)) {
+      Lower(cell);
+    }
+  }
+  lowestBucket_ = 0;
+  return processed;
+}
+
+/**
+ * @brief Drop every obstacle and pending change.
+ */
+void LikelihoodField::Clear() {
+  std::fill(distances_.begin(), distances_.end(), farDistance_);
+  std::fill(sites_.begin(), sites_.end(), kNoSite);
+  std::fill(raising_.begin(), raising_.end(), std::uint8_t{0});
+  for (std::vector<std::int32_t>& bucket : buckets_) {
+    bucket.clear();
+  }
+  lowestBucket_ = 0;
+  queued_ = 0;
+}
+
+/**
+ * @brief Read the distance to the nearest obstacle.
+ * @param x Cell X.
+ * @param y Cell Y.
+ * @return Distance in cells, or infinity beyond maxDistance.
+ */
+double LikelihoodField::DistanceAt(int x, int y) const {
+  const std::int32_t squared = distances_[Cell(x, y)];
+  return (squared > maxSquared_) ? std::numeric_limits<double>::infinity() : std::sqrt(static_cast<double>(squared));
+}
+
+/**
+ * @brief Sum endpoint likelihoods at a pose.
+ * @param pose Scan pose.
+ * @param points Robot-frame hit endpoints.
+ * @return Likelihood sum.
+ */
+double LikelihoodField::Score(const RobotPose& pose, const ScanPoints& points) const {
+  constexpr std::size_t kBlock = 64;
+  const float c = static_cast<float>(std::cos(pose.theta));
+  const float s = static_cast<float>(std::sin(pose.theta));
+  const float originX = static_cast<float>(pose.x);
+  const float originY = static_cast<float>(pose.y);
+  const float width = static_cast<float>(width_);
+  const float height = static_cast<float>(height_);
+  const std::int32_t stride = width_;
+  const std::int32_t padding = width_ * height_;
+  const float* pointX = points.X().data();
+  const float* pointY = points.Y().data();
+  const std::int32_t* distances = distances_.data();
+  const float* likelihood = likelihood_.data();
+
+  std::array<std::int32_t, kBlock> cells{};
+  double sum = 0.0;
+  for (std::size_t begin = 0; begin < points.Size(); begin += kBlock) {
+    const std::size_t count = std::min(kBlock, points.Size() - begin);
+    for (std::size_t i = 0; i < count; ++i) {
+      const float x = originX + c * pointX[begin + i] - s * pointY[begin + i];
+      const float y = originY + s * pointX[begin + i] + c * pointY[begin + i];
+      const bool inside = (x >= 0.0F) & (x < width) & (y >= 0.0F) & (y < height);
+      // Clamp before truncating so far or NaN endpoints never convert out of int range.
+      const std::int32_t cellX = static_cast<std::int32_t>(std::min(width - 1.0F, std::max(0.0F, x)));
+      const std::int32_t cellY = static_cast<std::int32_t>(std::min(height - 1.0F, std::max(0.0F, y)));
+      cells[i] = inside ? cellY * stride + cellX : padding;
+    }
+    float blockSum = 0.0F;
+    for (std::size_t i = 0; i < count; ++i) {
+      blockSum += likelihood[distances[cells[i]]];
+    }
+    sum += static_cast<double>(blockSum);
+  }
+  return sum;
+}
+
+/**
+ * @brief Queue a cell in the bucket of its key.
+ * @param cell Cell index.
+ * @param key Squared distance the cell is ordered by.
+ */
+void LikelihoodField::Push(std::int32_t cell, std::int32_t key) {
+  const std::size_t bucket = static_cast<std::size_t>(key);
+  buckets_[bucket].push_back(cell);
+  lowestBucket_ = std::min(lowestBucket_, bucket);
+  ++queued_;
+}
+
+/**
+ * @brief Spread a removal to the neighbours that pointed at a removed site.
+ * @param cell Cell whose site was removed.
+ * @note Neighbours whose site survives are queued under their own distance so the lower
+ * wave refills the cleared region from them.
+ */
+void LikelihoodField::Raise(std::int32_t cell) {
+  const int x = cell % width_;
+  const int y = cell / width_;
+  for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height_ - 1); ++ny) {
+    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width_ - 1); ++nx) {
+      const std::int32_t neighbour = ny * width_ + nx;
+      const std::size_t slot = static_cast<std::size_t>(neighbour);
+      const std::int32_t site = sites_[slot];
+      if (site == kNoSite || raising_[slot] != 0U) {
+        continue;
+      }
+      const std::int32_t key = distances_[slot];
+      if (sites_[static_cast<std::size_t>(site)] != site) {
+        ClearCell(slot);
+        raising_[slot] = 1U;
+      }
+      Push(neighbour, key);
+    }
+  }
+  raising_[static_cast<std::size_t>(cell)] = 0U;
+}
+
+/**
+ * @brief Offer a cell's site to its neighbours.
+ * @param cell Cell with a valid site.
+ */
+void LikelihoodField::Lower(std::int32_t cell) {
+  const int x = cell % width_;
+  const int y = cell / width_;
+  const std::int32_t site = sites_[static_cast<std::size_t>(cell)];
+  const int siteX = site % width_;
+  const int siteY = site / width_;
+  for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height_ - 1); ++ny) {
+    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width_ - 1); ++nx) {
+      const std::size_t slot = Cell(nx, ny);
+      if (raising_[slot] != 0U) {
+        continue;
+      }
+      const std::int32_t squared = (nx - siteX) * (nx - siteX) + (ny - siteY) * (ny - siteY);
+      if (squared <= maxSquared_ && squared < distances_[slot]) {
+        distances_[slot] = squared;
+        sites_[slot] = site;
+        Push(static_cast<std::int32_t>(slot), squared);
+      }
+    }
+  }
+}
+
+}  // namespace slam::core
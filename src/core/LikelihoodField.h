@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core/ScanBuffer.h"
+#include "core/Types.h"
+
+/**
+ * @file LikelihoodField.h
+ * @brief Distance-to-nearest-obstacle field with incremental updates and batched scan scoring.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Range and spread of the likelihood field.
+ */
+struct LikelihoodFieldOptions {
+  /// Distances are tracked up to this many cells; farther cells read as unreached and score zero.
+  double maxDistance = 8.0;
+  /// Standard deviation of the endpoint likelihood, in cells.
+  double sigma = 1.0;
+};
+
+/**
+ * @brief Hit endpoints of one scan in the robot frame, laid out for LikelihoodField::Score.
+ * @note Assigned once per scan and reused for every pose the scan is scored at.
+ */
+class ScanPoints {
+ public:
+  /**
+   * @brief Keep the endpoints of a scan's hit beams, relative to the scan pose.
+   * @param scan Scan to convert; only distances, angles, and hits are read.
+   */
+  void Assign(const ScanBuffer& scan);
+
+  /// @return Number of hit endpoints.
+  std::size_t Size() const { return x_.size(); }
+  /// @return Endpoint X along the robot heading, in grid units.
+  std::span<const float> X() const { return x_; }
+  /// @return Endpoint Y across the robot heading, in grid units.
+  std::span<const float> Y() const { return y_; }
+
+ private:
+  std::vector<float> x_;
+  std::vector<float> y_;
+};
+
+/**
+ * @brief Euclidean distance from every cell to its nearest obstacle cell, kept current as obstacles change.
+ * @note A dynamic brushfire: every cell stores its nearest obstacle ("site") and the squared
+ * distance to it. SetObstacle and RemoveObstacle only queue the changed cell; Update() then
+ * runs a lowering wave from new obstacles and a raising wave that clears the cells whose site
+ * disappeared, followed by a lowering wave back into them from the surviving sites. Waves are
+ * processed in order of squared distance from a bucket queue and stop at maxDistance, so the
+ * cost of an update scales with the cells whose distance actually changed, not with the map.
+ * The likelihood of a cell is exp(-d^2 / (2 sigma^2)), read from a table indexed by the
+ * squared distance.
+ */
+class LikelihoodField {
+ public:
+  LikelihoodField() = default;
+  /**
+   * @brief Construct a field with no obstacles.
+   * @param width Field width in cells.
+   * @param height Field height in cells.
+   * @param options Distance range and likelihood spread.
+   * @throws std::invalid_argument when dimensions are not positive, maxDistance is below one
+   * cell, or sigma is not positive.
+   */
+  LikelihoodField(int width, int height, const LikelihoodFieldOptions& options = {});
+
+  /// @return Field width in cells.
+  int Width() const { return width_; }
+  /// @return Field height in cells.
+  int Height() const { return height_; }
+  /// @return Distance range and likelihood spread.
+  const LikelihoodFieldOptions& Options() const { return options_; }
+
+  /// Make an in-range cell an obstacle; distances around it change at the next Update().
+  void SetObstacle(int x, int y);
+  /// Make an in-range cell free again; distances around it change at the next Update().
+  void RemoveObstacle(int x, int y);
+  /// @return True when an in-range cell is an obstacle, including changes not yet propagated.
+  bool IsObstacle(int x, int y) const {
+    const std::int32_t cell = y * width_ + x;
+    return sites_[static_cast<std::size_t>(cell)] == cell;
+  }
+  /**
+   * @brief Propagate the obstacle changes queued since the last update.
+   * @return Queue entries processed, a measure of the work done.
+   */
+  std::size_t Update();
+  /// Remove every obstacle without propagating; O(cells).
+  void Clear();
+
+  /**
+   * @brief Distance from an in-range cell to its nearest obstacle cell, in cells.
+   * @return Distance between cell centers, or infinity when no obstacle is within maxDistance.
+   */
+  double DistanceAt(int x, int y) const;
+  /// @return Likelihood of an endpoint landing in an in-range cell, in [0, 1].
+  float LikelihoodAt(int x, int y) const { return likelihood_[static_cast<std::size_t>(distances_[Cell(x, y)])]; }
+  /**
+   * @brief Sum the likelihoods of a scan's endpoints placed at a pose.
+   * @param pose Pose the endpoints are transformed by.
+   * @param points Robot-frame hit endpoints.
+   * @return Sum of LikelihoodAt over the endpoint cells; endpoints outside the field add nothing.
+   * @note Endpoints are transformed and turned into cell indices a block at a time in a
+   * branch-free loop the compiler vectorizes; out-of-range endpoints are redirected to a
+   * padding cell that always scores zero. The table lookups that follow are gathers and stay scalar.
+   */
+  double Score(const RobotPose& pose, const ScanPoints& points) const;
+
+ private:
+  /**
+   * @brief Queue a cell under a squared distance.
+   */
+  void Push(std::int32_t cell, std::int32_t key);
+  /**
+   * @brief Clear the neighbours whose site is gone and queue the border of the cleared region.
+   */
+  void Raise(std::int32_t cell);
+  /**
+   * @brief Offer a cell's site to its neighbours.
+   */
+  void Lower(std::int32_t cell);
+  /**
+   * @brief Forget a cell's site.
+   */
+  void ClearCell(std::size_t cell) {
+    sites_[cell] = kNoSite;
+    distances_[cell] = farDistance_;
+  }
+  std::size_t Cell(int x, int y) const {
+    return static_cast<std::size_t>(y) * static_cast<std::size_t>(width_) + static_cast<std::size_t>(x);
+  }
+
+  static constexpr std::int32_t kNoSite = -1;
+
+  int width_ = 0;
+  int height_ = 0;
+  LikelihoodFieldOptions options_{};
+  /// Largest tracked squared distance; farDistance_ = maxSquared_ + 1 marks unreached cells.
+  std::int32_t maxSquared_ = 0;
+  std::int32_t farDistance_ = 1;
+  /// Squared distance to the site per cell, plus one always-far padding cell at the end.
+  std::vector<std::int32_t> distances_;
+  /// Nearest obstacle cell per cell, or kNoSite.
+  std::vector<std::int32_t> sites_;
+  /// Cells whose site was removed and whose neighbours still have to be checked.
+  std::vector<std::uint8_t> raising_;
+  /// Likelihood per squared distance, zero at farDistance_.
+  std::vector<float> likelihood_;
+  /// Bucket queue keyed by squared distance; lowestBucket_ is at or below the smallest queued key.
+  std::vector<std::vector<std::int32_t>> buckets_;
+  std::size_t lowestBucket_ = 0;
+  std::size_t queued_ = 0;
+};
+
+}  // namespace slam::core
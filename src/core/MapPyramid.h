@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "core/GridLine.h"
+
+/**
+ * @file MapPyramid.h
+ * @brief Max-pooled multi-resolution levels over an occupancy grid.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Levels 1..N of a max-pooled pyramid; level 0 is the grid itself and is read through a callable.
+ * @note Level l cell (x, y) holds the largest raw value of the level-0 block
+ * [x << l, (x + 1) << l) x [y << l, (y + 1) << l), clipped to the grid. Each level halves
+ * both sides, rounding up, until a single cell remains. Occupancy classification is
+ * monotone in the raw value in both update modes, so a pooled cell classifies as occupied
+ * exactly when some cell of its block does.
+ */
+class MapPyramid {
+ public:
+  MapPyramid() = default;
+  /**
+   * @brief Allocate every level over a width x height grid.
+   * @param fill Initial value of every pooled cell, normally the unknown value.
+   */
+  MapPyramid(int width, int height, std::int16_t fill) : baseWidth_(width), baseHeight_(height) {
+    int levelWidth = width;
+    int levelHeight = height;
+    while (levelWidth > 1 || levelHeight > 1) {
+      levelWidth = (levelWidth + 1) >> 1;
+      levelHeight = (levelHeight + 1) >> 1;
+      levels_.push_back(Level{levelWidth, levelHeight,
+                              std::vector<std::int16_t>(static_cast<std::size_t>(levelWidth) * static_cast<std::size_t>(levelHeight), fill)});
+    }
+  }
+
+  /// @return Number of levels including level 0; 1 when the grid is a single cell.
+  int LevelCount() const { return static_cast<int>(levels_.size()) + 1; }
+  /// @return Width in cells of a level.
+  int LevelWidth(int level) const { return (level == 0) ? baseWidth_ : levels_[static_cast<std::size_t>(level - 1)].width; }
+  /// @return Height in cells of a level.
+  int LevelHeight(int level) const {
+    return (level == 0) ? baseHeight_ : levels_[static_cast<std::size_t>(level - 1)].height;
+  }
+  /// @return Pooled value of an in-range cell of a level >= 1.
+  std::int16_t MaxAt(int level, int x, int y) const {
+    const Level& pooled = levels_[static_cast<std::size_t>(level - 1)];
+    return pooled.cells[static_cast<std::size_t>(y) * static_cast<std::size_t>(pooled.width) + static_cast<std::size_t>(x)];
+  }
+  /// Set every pooled cell to value, e.g. after the grid was reset.
+  void Fill(std::int16_t value) {
+    for (Level& level : levels_) {
+      std::fill(level.cells.begin(), level.cells.end(), value);
+    }
+  }
+  /**
+   * @brief Recompute the pooled ancestors of a rectangle of level-0 cells.
+   * @param cells Level-0 cells whose values may have changed.
+   * @param base Callable returning the level-0 value at (x, y).
+   * @note Works up one level at a time over the rectangle's ancestors and stops at the first
+   * level where none of them changed, since coarser cells only depend on that level.
+   */
+  template <typename BaseFn>
+  void Refresh(const GridRect& cells, BaseFn&& base) {
+    GridRect region = cells;
+    for (std::size_t level = 0; level < levels_.size(); ++level) {
+      const int childWidth = LevelWidth(static_cast<int>(level));
+      const int childHeight = LevelHeight(static_cast<int>(level));
+      region = GridRect{.xBegin = region.xBegin >> 1,
+                        .yBegin = region.yBegin >> 1,
+                        .xEnd = (region.xEnd + 1) >> 1,
+                        .yEnd = (region.yEnd + 1) >> 1};
+      Level& pooled = levels_[level];
+      bool changed = false;
+      for (int y = region.yBegin; y < region.yEnd; ++y) {
+        const int childYEnd = std::min(2 * y + 2, childHeight);
+        for (int x = region.xBegin; x < region.xEnd; ++x) {
+          const int childXEnd = std::min(2 * x + 2, childWidth);
+          std::int16_t largest = std::numeric_limits<std::int16_t>::min();
+          for (int childY = 2 * y; childY < childYEnd; ++childY) {
+            for (int childX = 2 * x; childX < childXEnd; ++childX) {
+              largest = std::max(largest, (level == 0) ? base(childX, childY) : MaxAt(static_cast<int>(level), childX, childY));
+            }
+          }
+          std::int16_t& cell =
+              pooled.cells[static_cast<std::size_t>(y) * static_cast<std::size_t>(pooled.width) + static_cast<std::size_t>(x)];
+          changed = changed || (cell != largest);
+          cell = largest;
+        }
+      }
+      if (!changed) {
+        return;
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief One pooled level, row-major.
+   */
+  struct Level {
+    int width = 0;
+    int height = 0;
+    std::vector<std::int16_t> cells;
+  };
+
+  int baseWidth_ = 0;
+  int baseHeight_ = 0;
+  std::vector<Level> levels_;
+};
+
+}  // namespace slam::core
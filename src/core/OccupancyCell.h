@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "core/Types.h"
+
+/**
+ * @file OccupancyCell.h
+ * @brief Cell values and update rules shared by the occupancy map storages.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Value of a never-observed cell: kUnknown, or even log-odds.
+ */
+constexpr std::int16_t UnknownCellValue(MapUpdateMode mode) {
+  return (mode == MapUpdateMode::kLogOdds) ? std::int16_t{0} : kUnknown;
+}
+
+/**
+ * @brief Reject log-odds parameters the clamped update cannot honor.
+ * @param logOdds Parameters to check.
+ * @param owner Class name prefixed to the error message.
+ * @throws std::invalid_argument on non-positive increments, a clamp range that excludes 0,
+ * or thresholds that are unordered or outside the clamp range.
+ */
+inline void ValidateLogOddsParams(const LogOddsParams& logOdds, const char* owner) {
+  if (logOdds.hitIncrement <= 0 || logOdds.missDecrement <= 0) {
+    throw std::invalid_argument(std::string(owner) + " log-odds increments must be positive");
+  }
+  if (logOdds.clampMin >= 0 || logOdds.clampMax <= 0) {
+    throw std::invalid_argument(std::string(owner) + " log-odds clamp range must contain 0");
+  }
+  if (logOdds.freeThreshold >= logOdds.occupiedThreshold || logOdds.freeThreshold < logOdds.clampMin ||
+      logOdds.occupiedThreshold > logOdds.clampMax) {
+    throw std::invalid_argument(std::string(owner) + " log-odds thresholds must be ordered inside the clamp range");
+  }
+}
+
+/**
+ * @brief Threshold a raw cell value to kUnknown, kFree, or kOccupied.
+ */
+constexpr std::int16_t ClassifyCellValue(MapUpdateMode mode, const LogOddsParams& logOdds, std::int16_t value) {
+  if (mode == MapUpdateMode::kOverwrite) {
+    return value;
+  }
+  if (value >= logOdds.occupiedThreshold) {
+    return kOccupied;
+  }
+  return (value <= logOdds.freeThreshold) ? kFree : kUnknown;
+}
+
+/**
+ * @brief Call fn(miss, hit) with callables that apply one update to a cell reference.
+ * @note Dispatching on the mode once per scan keeps the per-cell updates branch-free.
+ */
+template <typename Fn>
+void WithCellUpdateRules(MapUpdateMode mode, const LogOddsParams& logOdds, Fn&& fn) {
+  if (mode == MapUpdateMode::kLogOdds) {
+    fn([decrement = int{logOdds.missDecrement}, low = int{logOdds.clampMin}](std::int16_t& cell) {
+         cell = static_cast<std::int16_t>(std::max(cell - decrement, low));
+       },
+       [increment = int{logOdds.hitIncrement}, high = int{logOdds.clampMax}](std::int16_t& cell) {
+         cell = static_cast<std::int16_t>(std::min(cell + increment, high));
+       });
+  } else {
+    fn([](std::int16_t& cell) { cell = kFree; }, [](std::int16_t& cell) { cell = kOccupied; });
+  }
+}
+
+}  // namespace slam::core
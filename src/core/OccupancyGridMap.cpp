@@ -1,52 +1,28 @@
 /**
  * @file OccupancyGridMap.cpp
- * @brief Occupancy integration and Bresenham-based ray updates.
+ * @brief Occupancy integration by clipped Bresenham rays or visibility-polygon fills, serial or in row bands.
  */
 
 #include "core/OccupancyGridMap.h"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "core/OccupancyCell.h"
 
 namespace slam::core {
 namespace {
 
-/**
- * @brief Compute integer line points using Bresenham algorithm.
- * @param start Start coordinate.
- * @param end End coordinate.
- * @return Ordered list of grid points on the line.
- */
-std::vector<std::pair<int, int>> Bresenham(std::pair<int, int> start, std::pair<int, int> end) {
-  int x0 = start.first;
-  int y0 = start.second;
-  const int x1 = end.first;
-  const int y1 = end.second;
-
-  std::vector<std::pair<int, int>> points;
-  const int dx = std::abs(x1 - x0);
-  const int dy = std::abs(y1 - y0);
-  const int xStep = (x0 < x1) ? 1 : -1;
-  const int yStep = (y0 < y1) ? 1 : -1;
-
-  int err = dx - dy;
-  while (true) {
-    points.push_back({x0, y0});
-    if (x0 == x1 && y0 == y1) {
-      break;
-    }
-    const int errTwice = 2 * err;
-    if (errTwice > -dy) {
-      err -= dy;
-      x0 += xStep;
-    }
-    if (errTwice < dx) {
-      err += dx;
-      y0 += yStep;
-    }
-  }
-  return points;
-}
+/// Mask of a coordinate's offset within its tile.
+constexpr std::size_t kTileMask = (std::size_t{1} << OccupancyGridMap::kTileShift) - 1U;
+/// Range difference in cells between neighbouring polygon vertices that counts as an occlusion edge.
+constexpr double kShadowRangeJump = 1.0;
+/// Range change per cell of sideways spread above which neighbouring vertices count as an occlusion edge.
+constexpr double kShadowSlope = 2.0;
 
 }  // namespace
 
@@ -54,21 +30,53 @@ std::vector<std::pair<int, int>> Bresenham(std::pair<int, int> start, std::pair<
  * @brief Construct an occupancy map initialized to unknown.
  * @param width Map width in cells.
  * @param height Map height in cells.
+ * @param mode Cell update rule.
+ * @param logOdds Log-odds parameters used by MapUpdateMode::kLogOdds.
  */
-OccupancyGridMap::OccupancyGridMap(int width, int height)
+OccupancyGridMap::OccupancyGridMap(int width, int height, MapUpdateMode mode, const LogOddsParams& logOdds)
     : width_(width),
       height_(height),
-      grid_(static_cast<std::size_t>(width * height), kUnknown) {
+      mode_(mode),
+      logOdds_(logOdds) {
   if (width <= 0 || height <= 0) {
     throw std::invalid_argument("OccupancyGridMap dimensions must be positive");
   }
+  if (mode == MapUpdateMode::kLogOdds) {
+    ValidateLogOddsParams(logOdds, "OccupancyGridMap");
+  }
+  tilesPerRow_ = (static_cast<std::size_t>(width) + kTileMask) >> kTileShift;
+  tileRows_ = (static_cast<std::size_t>(height) + kTileMask) >> kTileShift;
+  indexer_ = GridIndexer(MapLayout::kRowMajor, width, height);
+  grid_.assign(indexer_.StorageSize(), UnknownCellValue(mode));
+  currentRows_.Assign(static_cast<std::size_t>(height));
+  MarkAllRowsCurrent();
+  dirtyTiles_ = AtomicBitWords((tilesPerRow_ * tileRows_ + 63U) / 64U);
 }
 
 /**
  * @brief Reset all cells to unknown state.
+ * @note Rows are only marked stale here; each is refilled with unknown by its next write or
+ * by Data(). Marking every tile dirty is one pass over the tile bitset.
  */
 void OccupancyGridMap::Reset() {
-  std::fill(grid_.begin(), grid_.end(), kUnknown);
+  currentRows_.Clear();
+  if (maintainPyramid_) {
+    pyramid_.Fill(UnknownCellValue(mode_));
+  }
+  if (maintainField_) {
+    field_.Clear();
+  }
+  for (std::size_t word = 0; word < layerTiles_.Size(); ++word) {
+    layerTiles_[word].store(0U, std::memory_order_relaxed);
+  }
+  freeCells_ = 0;
+  occupiedCells_ = 0;
+  const std::size_t tileCount = tilesPerRow_ * tileRows_;
+  for (std::size_t word = 0; word < dirtyTiles_.Size(); ++word) {
+    const std::size_t bitsInWord = std::min<std::size_t>(64U, tileCount - word * 64U);
+    dirtyTiles_[word].store((bitsInWord == 64U) ? ~std::uint64_t{0} : ((std::uint64_t{1} << bitsInWord) - 1U),
+                            std::memory_order_relaxed);
+  }
 }
 
 /**
@@ -78,7 +86,132 @@ void OccupancyGridMap::Reset() {
  * @return Occupancy state value.
  */
 std::int16_t OccupancyGridMap::ValueAt(int x, int y) const {
-  return grid_[static_cast<std::size_t>(Index(x, y))];
+  return currentRows_.IsMarked(static_cast<std::size_t>(y)) ? grid_[Index(x, y)] : UnknownCellValue(mode_);
+}
+
+/**
+ * @brief Read a map cell thresholded to kUnknown, kFree, or kOccupied.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return Occupancy state value.
+ */
+std::int16_t OccupancyGridMap::ClassifiedValueAt(int x, int y) const {
+  return ClassifyCellValue(mode_, logOdds_, ValueAt(x, y));
+}
+
+/**
+ * @brief Enable or disable per-scan update deduplication.
+ * @param enabled True to deduplicate.
+ */
+void OccupancyGridMap::SetDeduplicateScanUpdates(bool enabled) {
+  deduplicateScanUpdates_ = enabled;
+  if (enabled) {
+    EnsureScanStamps();
+  }
+}
+
+/**
+ * @brief Start or stop maintaining the max-pooled pyramid.
+ * @param enabled True to build it from the current cells.
+ */
+void OccupancyGridMap::SetMaintainPyramid(bool enabled) {
+  maintainPyramid_ = enabled;
+  if (!enabled) {
+    pyramid_ = MapPyramid();
+  } else {
+    pyramid_ = MapPyramid(width_, height_, UnknownCellValue(mode_));
+    pyramid_.Refresh(GridRect{.xBegin = 0, .yBegin = 0, .xEnd = width_, .yEnd = height_},
+                     [this](int x, int y) { return ValueAt(x, y); });
+  }
+  SizeLayerTiles();
+}
+
+/**
+ * @brief Start or stop maintaining the likelihood field.
+ * @param enabled True to build it from the current occupied cells.
+ * @param options Distance range and likelihood spread.
+ */
+void OccupancyGridMap::SetMaintainLikelihoodField(bool enabled, const LikelihoodFieldOptions& options) {
+  if (!enabled) {
+    maintainField_ = false;
+    field_ = LikelihoodField();
+  } else {
+    LikelihoodField field(width_, height_, options);
+    for (int y = 0; y < height_; ++y) {
+      for (int x = 0; x < width_; ++x) {
+        if (ClassifiedValueAt(x, y) == kOccupied) {
+          field.SetObstacle(x, y);
+        }
+      }
+    }
+    field.Update();
+    field_ = std::move(field);
+    maintainField_ = true;
+  }
+  SizeLayerTiles();
+}
+
+/**
+ * @brief Read a pooled value.
+ * @param level Pyramid level; 0 reads the cell itself.
+ * @param x Block column at that level.
+ * @param y Block row at that level.
+ * @return Largest raw value in the block.
+ */
+std::int16_t OccupancyGridMap::PooledValueAt(int level, int x, int y) const {
+  if (level < 0 || level >= PyramidLevels() || x < 0 || y < 0 || x >= pyramid_.LevelWidth(level) ||
+      y >= pyramid_.LevelHeight(level)) {
+    return UnknownCellValue(mode_);
+  }
+  return (level == 0) ? ValueAt(x, y) : pyramid_.MaxAt(level, x, y);
+}
+
+/**
+ * @brief Check a block for occupied cells with one pooled read.
+ * @param level Pyramid level; 0 checks a single cell.
+ * @param x Block column at that level.
+ * @param y Block row at that level.
+ * @return True when the block's largest value classifies as occupied.
+ */
+bool OccupancyGridMap::AnyOccupied(int level, int x, int y) const {
+  return ClassifyCellValue(mode_, logOdds_, PooledValueAt(level, x, y)) == kOccupied;
+}
+
+/**
+ * @brief Select per-beam lines or visibility-polygon fills for free space.
+ * @param mode Free-space rasterization mode.
+ */
+void OccupancyGridMap::SetIntegrationMode(IntegrationMode mode) {
+  integrationMode_ = mode;
+  if (mode == IntegrationMode::kVisibilityPolygon) {
+    EnsureScanStamps();
+  }
+}
+
+/**
+ * @brief Move every cell into the given memory order.
+ * @param layout Target layout.
+ * @note Scan stamps are dropped rather than moved; they only matter within one scan.
+ */
+void OccupancyGridMap::SetLayout(MapLayout layout) {
+  if (layout == indexer_.Layout()) {
+    return;
+  }
+  const GridIndexer target(layout, width_, height_);
+  std::vector<std::int16_t> cells(target.StorageSize(), UnknownCellValue(mode_));
+  for (int y = 0; y < height_; ++y) {
+    for (int x = 0; x < width_; ++x) {
+      cells[target.Index(x, y)] = ValueAt(x, y);
+    }
+  }
+  grid_.swap(cells);
+  MarkAllRowsCurrent();
+  indexer_ = target;
+  if (!missStamps_.empty()) {
+    missStamps_.clear();
+    hitStamps_.clear();
+    EnsureScanStamps();
+  }
 }
 
 /**
@@ -87,40 +220,569 @@ std::int16_t OccupancyGridMap::ValueAt(int x, int y) const {
  * @param scan Scan samples to fuse.
  */
 void OccupancyGridMap::IntegrateScan(const RobotPose& pose, const std::vector<ScanSample>& scan) {
-  const std::pair<int, int> start{static_cast<int>(pose.x), static_cast<int>(pose.y)};
+  IntegrateScan(pose, std::span<const ScanSample>(scan));
+}
 
+/**
+ * @brief Integrate one lidar scan held in caller-owned storage.
+ * @param pose Robot pose.
+ * @param scan Scan samples to fuse.
+ */
+void OccupancyGridMap::IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan) {
+  BeginScan();
+  if (UsesVisibilityPolygon(scan.size())) {
+    BuildVisibilityPolygon(pose, scan.size(), [&](std::size_t i) {
+      const double angle = pose.theta + scan[i].relativeAngle;
+      return std::tuple{
+          pose.x + std::cos(angle) * scan[i].distance, pose.y + std::sin(angle) * scan[i].distance, scan[i].hit};
+    });
+    ApplyCountDelta(FillVisibilityRows(pose, 0, height_));
+    UpdateLayers();
+    return;
+  }
+
+  const std::pair<int, int> start{static_cast<int>(pose.x), static_cast<int>(pose.y)};
+  CellCountDelta counts;
   for (const ScanSample& sample : scan) {
     const double angle = pose.theta + sample.relativeAngle;
     const int endX = static_cast<int>(pose.x + std::cos(angle) * sample.distance);
     const int endY = static_cast<int>(pose.y + std::sin(angle) * sample.distance);
-    const std::vector<std::pair<int, int>> ray = Bresenham(start, {endX, endY});
+    IntegrateBeam(start, endX, endY, sample.hit, 0, height_, counts);
+  }
+  ApplyCountDelta(counts);
+  UpdateLayers();
+}
+
+/**
+ * @brief Integrate one struct-of-arrays scan from its stored endpoints.
+ * @param pose Robot pose.
+ * @param scan Scan with world-space endpoints.
+ */
+void OccupancyGridMap::IntegrateScan(const RobotPose& pose, const ScanBuffer& scan) {
+  BeginScan();
+  if (UsesVisibilityPolygon(scan.Size())) {
+    BuildVisibilityPolygon(pose, scan.Size(), [&](std::size_t i) {
+      return std::tuple{scan.EndX()[i], scan.EndY()[i], scan.Hit(i)};
+    });
+    ApplyCountDelta(FillVisibilityRows(pose, 0, height_));
+  } else {
+    ApplyCountDelta(IntegrateScanRows(pose, scan, 0, height_));
+  }
+  UpdateLayers();
+}
+
+/**
+ * @brief Integrate one struct-of-arrays scan with row bands split across a worker pool.
+ * @param pose Robot pose.
+ * @param scan Scan with world-space endpoints.
+ * @param pool Worker pool that integrates the bands.
+ */
+void OccupancyGridMap::IntegrateScan(const RobotPose& pose, const ScanBuffer& scan, WorkerPool& pool) {
+  BeginScan();
+  const bool polygon = UsesVisibilityPolygon(scan.Size());
+  if (polygon) {
+    BuildVisibilityPolygon(pose, scan.Size(), [&](std::size_t i) {
+      return std::tuple{scan.EndX()[i], scan.EndY()[i], scan.Hit(i)};
+    });
+  }
+  const int bandCount = std::min(pool.ThreadCount(), height_);
+  bandCounts_.assign(static_cast<std::size_t>(bandCount), CellCountDelta{});
+  pool.ParallelFor(static_cast<std::size_t>(bandCount), [&](std::size_t band) {
+    const int rowBegin = static_cast<int>((static_cast<long long>(height_) * static_cast<long long>(band)) / bandCount);
+    const int rowEnd =
+        static_cast<int>((static_cast<long long>(height_) * static_cast<long long>(band + 1)) / bandCount);
+    bandCounts_[band] = polygon ? FillVisibilityRows(pose, rowBegin, rowEnd) : IntegrateScanRows(pose, scan, rowBegin, rowEnd);
+  });
+  for (const CellCountDelta& counts : bandCounts_) {
+    ApplyCountDelta(counts);
+  }
+  UpdateLayers();
+}
 
-    const std::size_t freeLimit = sample.hit ? (ray.size() > 1 ? ray.size() - 1 : 0) : ray.size();
-    for (std::size_t i = 1; i < freeLimit; ++i) {
-      const auto [x, y] = ray[i];
-      if (InBounds(x, y)) {
-        grid_[static_cast<std::size_t>(Index(x, y))] = kFree;
+/**
+ * @brief Integrate every beam of a scan, writing only cells in rows [rowBegin, rowEnd).
+ * @param pose Robot pose.
+ * @param scan Scan with world-space endpoints.
+ * @param rowBegin First row written.
+ * @param rowEnd One past the last row written.
+ * @return Free and occupied count changes of the band.
+ */
+OccupancyGridMap::CellCountDelta OccupancyGridMap::IntegrateScanRows(
+    const RobotPose& pose, const ScanBuffer& scan, int rowBegin, int rowEnd) {
+  const std::pair<int, int> start{static_cast<int>(pose.x), static_cast<int>(pose.y)};
+  const std::span<const double> endX = scan.EndX();
+  const std::span<const double> endY = scan.EndY();
+
+  CellCountDelta counts;
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    IntegrateBeam(start, static_cast<int>(endX[i]), static_cast<int>(endY[i]), scan.Hit(i), rowBegin, rowEnd, counts);
+  }
+  return counts;
+}
+
+/**
+ * @brief Call fn(miss, hit) with the update callables of the current update mode.
+ * @param counts Receives the free and occupied count changes of the applied updates.
+ * @param fn Callable taking the miss and hit updates, each callable with (index, x, y).
+ */
+template <typename Fn>
+void OccupancyGridMap::WithCellUpdates(CellCountDelta& counts, Fn&& fn) {
+  std::int16_t* cells = grid_.data();
+  // The clamped log-odds update is applied inline during the walk. Gathering ray cells into
+  // lanes for vector subtracts, or vectorizing contiguous row runs, measured slower:
+  // beams are short and rarely axis-aligned, so the shuffling cost more than the arithmetic.
+  WithCellUpdateRules(mode_, logOdds_, [&](auto missRule, auto hitRule) {
+    const auto tracked = [this, cells, &counts](auto rule) {
+      return [this, cells, &counts, rule](std::size_t index, int x, int y) {
+        EnsureRowCurrent(y);
+        // Unchanged cells are not stored back, which also keeps their cache lines clean.
+        std::int16_t value = cells[index];
+        rule(value);
+        if (value != cells[index]) {
+          CountTransition(counts, cells[index], value);
+          cells[index] = value;
+          MarkDirty(x, y);
+        }
+      };
+    };
+    fn(tracked(missRule), tracked(hitRule));
+  });
+}
+
+/**
+ * @brief Apply free and occupied updates for one beam, restricted to a row band.
+ * @param start Robot cell.
+ * @param endX Beam end cell X.
+ * @param endY Beam end cell Y.
+ * @param hit True when the beam terminated on an obstacle.
+ * @param rowBegin First row written.
+ * @param rowEnd One past the last row written.
+ * @param counts Receives the free and occupied count changes.
+ * @note Clips the Bresenham line to the band once and walks only the visible steps. Beams
+ * are applied in scan order within each band, so splitting the map into bands leaves
+ * every cell with its serial value.
+ */
+void OccupancyGridMap::IntegrateBeam(
+    std::pair<int, int> start, int endX, int endY, bool hit, int rowBegin, int rowEnd, CellCountDelta& counts) {
+  const GridRect band{
+      .xBegin = 0, .yBegin = std::max(rowBegin, 0), .xEnd = width_, .yEnd = std::min(rowEnd, height_)};
+  if (std::max(start.second, endY) < band.yBegin || std::min(start.second, endY) >= band.yEnd) {
+    return;
+  }
+
+  // Stamping a cell with the scan generation lets each update kind reach it once per scan.
+  const auto oncePerScan = [generation = scanGeneration_](std::vector<std::uint32_t>& stamps, auto update) {
+    return [stamp = stamps.data(), generation, update](std::size_t index, int x, int y) {
+      if (stamp[index] != generation) {
+        stamp[index] = generation;
+        update(index, x, y);
       }
+    };
+  };
+  WithCellUpdates(counts, [&](auto miss, auto onHit) {
+    if (deduplicateScanUpdates_) {
+      ApplyBeam(start, endX, endY, hit, band, oncePerScan(missStamps_, miss), oncePerScan(hitStamps_, onHit));
+    } else {
+      ApplyBeam(start, endX, endY, hit, band, miss, onHit);
     }
+  });
+}
 
-    if (sample.hit && InBounds(endX, endY)) {
-      grid_[static_cast<std::size_t>(Index(endX, endY))] = kOccupied;
+/**
+ * @brief Walk one beam clipped to a band and apply the given cell updates.
+ * @param start Robot cell.
+ * @param endX Beam end cell X.
+ * @param endY Beam end cell Y.
+ * @param hit True when the beam terminated on an obstacle.
+ * @param band Cells outside this rectangle are left untouched.
+ * @param miss Called with the index and coordinates of every ray cell.
+ * @param onHit Called with the end cell's index and coordinates when the beam hit.
+ */
+template <typename MissFn, typename HitFn>
+void OccupancyGridMap::ApplyBeam(
+    std::pair<int, int> start, int endX, int endY, bool hit, const GridRect& band, MissFn&& miss, HitFn&& onHit) {
+  // The robot cell (step 0) is never freed and a hit's end cell gets the hit update instead.
+  const int length = GridLineLength(start.first, start.second, endX, endY);
+  VisitGridLine(start.first, start.second, endX, endY, 1, hit ? length : length + 1, band, [&](int x, int y) {
+    miss(Index(x, y), x, y);
+  });
+
+  if (hit && endY >= band.yBegin && endY < band.yEnd && InBounds(endX, endY)) {
+    onHit(Index(endX, endY), endX, endY);
+  }
+}
+
+/**
+ * @brief True when the polygon mode is selected and the scan has enough beams to span an area.
+ */
+bool OccupancyGridMap::UsesVisibilityPolygon(std::size_t beamCount) const {
+  return integrationMode_ == IntegrationMode::kVisibilityPolygon && beamCount >= 3;
+}
+
+/**
+ * @brief Build the visibility polygon of one scan and bucket its row-center crossings by row.
+ * @param pose Robot pose.
+ * @param beamCount Number of beams, in angle order.
+ * @param endpoint Returns std::tuple{x, y, hit} for a beam index.
+ * @note A hit vertex is pulled back to the face where its beam enters the obstacle, so the
+ * polygon edge between two hits on a wall runs along the wall face and leaves the wall
+ * cells outside, and a range jump between neighbouring beams gets a shadow vertex so the
+ * edge does not cut across the near obstacle. Crossings are counting-sorted into per-row slices, which keeps the build
+ * linear in the perimeter and lets row bands fill disjoint slices concurrently.
+ */
+template <typename EndpointFn>
+void OccupancyGridMap::BuildVisibilityPolygon(const RobotPose& pose, std::size_t beamCount, EndpointFn&& endpoint) {
+  polygonX_.resize(beamCount);
+  polygonY_.resize(beamCount);
+  polygonHits_.clear();
+  for (std::size_t i = 0; i < beamCount; ++i) {
+    const auto [x, y, hit] = endpoint(i);
+    polygonX_[i] = x;
+    polygonY_[i] = y;
+    if (!hit) {
+      continue;
+    }
+    const int cellX = static_cast<int>(x);
+    const int cellY = static_cast<int>(y);
+    polygonHits_.emplace_back(cellX, cellY);
+    const double dx = x - pose.x;
+    const double dy = y - pose.y;
+    // Fractions of the beam at which it enters the hit cell's column and row.
+    const double columnEntry =
+        (dx != 0.0) ? (static_cast<double>(cellX + (dx < 0.0 ? 1 : 0)) - pose.x) / dx : 0.0;
+    const double rowEntry = (dy != 0.0) ? (static_cast<double>(cellY + (dy < 0.0 ? 1 : 0)) - pose.y) / dy : 0.0;
+    double entry = std::clamp(std::max(columnEntry, rowEntry), 0.0, 1.0);
+    // A fixed-step march can clip the corner of the real first obstacle without sampling it
+    // and stop one cell further. A cell the beam crosses right next to the hit cell may be
+    // such an unsampled obstacle, so the vertex stops at that earlier crossing instead.
+    // This can leave a sliver of free cells along a wall unfilled, never the reverse.
+    const double stripEntry = std::clamp(std::min(columnEntry, rowEntry), 0.0, 1.0);
+    const int stripCellX = static_cast<int>(std::floor(pose.x + dx * stripEntry));
+    const int stripCellY = static_cast<int>(std::floor(pose.y + dy * stripEntry));
+    if (std::abs(stripCellX - cellX) <= 1 && std::abs(stripCellY - cellY) <= 1) {
+      entry = stripEntry;
     }
+    polygonX_[i] = pose.x + dx * entry;
+    polygonY_[i] = pose.y + dy * entry;
   }
+
+  // Row r is sampled at its center r + 0.5; each edge owns the centers in [lowY, highY).
+  const double rowLimit = static_cast<double>(height_);
+  const auto forEachEdgeCrossing = [&](double ax, double ay, double bx, double by, auto&& emit) {
+    if (ay == by) {
+      return;
+    }
+    const int rowFirst = static_cast<int>(std::ceil(std::clamp(std::min(ay, by) - 0.5, 0.0, rowLimit)));
+    const int rowLast = static_cast<int>(std::ceil(std::clamp(std::max(ay, by) - 0.5, 0.0, rowLimit)));
+    const double inverseSlope = (bx - ax) / (by - ay);
+    for (int row = rowFirst; row < rowLast; ++row) {
+      emit(row, ax + (static_cast<double>(row) + 0.5 - ay) * inverseSlope);
+    }
+  };
+  // Where the range jumps between neighbouring beams, the edge between their vertices would
+  // cut through the near obstacle's silhouette. The outline instead steps out along the far
+  // beam from a shadow vertex at the near range, so the wedge is only filled up to the range
+  // both beams saw free. A jump below kShadowSlope times the wedge's width is taken for one
+  // surface seen at an angle, such as a wall running away from the robot, and keeps its edge.
+  const auto forEachCrossing = [&](auto&& emit) {
+    for (std::size_t i = 0; i < beamCount; ++i) {
+      const std::size_t next = (i + 1 == beamCount) ? 0 : i + 1;
+      const double ax = polygonX_[i];
+      const double ay = polygonY_[i];
+      const double bx = polygonX_[next];
+      const double by = polygonY_[next];
+      const double rangeA = std::hypot(ax - pose.x, ay - pose.y);
+      const double rangeB = std::hypot(bx - pose.x, by - pose.y);
+      // Sideways extent of the wedge at the near range.
+      const double spread =
+          std::abs((ax - pose.x) * (by - pose.y) - (ay - pose.y) * (bx - pose.x)) / std::max(rangeA, rangeB);
+      if (std::abs(rangeA - rangeB) <= std::max(kShadowRangeJump, kShadowSlope * spread)) {
+        forEachEdgeCrossing(ax, ay, bx, by, emit);
+        continue;
+      }
+      const bool nearA = rangeA < rangeB;
+      const double scale = nearA ? rangeA / rangeB : rangeB / rangeA;
+      const double shadowX = pose.x + ((nearA ? bx : ax) - pose.x) * scale;
+      const double shadowY = pose.y + ((nearA ? by : ay) - pose.y) * scale;
+      forEachEdgeCrossing(ax, ay, shadowX, shadowY, emit);
+      forEachEdgeCrossing(shadowX, shadowY, bx, by, emit);
+    }
+  };
+
+  rowCrossingOffsets_.assign(static_cast<std::size_t>(height_) + 2U, 0);
+  forEachCrossing([&](int row, double) { ++rowCrossingOffsets_[static_cast<std::size_t>(row) + 2U]; });
+  for (std::size_t r = 2; r < rowCrossingOffsets_.size(); ++r) {
+    rowCrossingOffsets_[r] += rowCrossingOffsets_[r - 1];
+  }
+  rowCrossings_.resize(static_cast<std::size_t>(rowCrossingOffsets_.back()));
+  forEachCrossing([&](int row, double x) {
+    rowCrossings_[static_cast<std::size_t>(rowCrossingOffsets_[static_cast<std::size_t>(row) + 1U]++)] = x;
+  });
 }
 
 /**
- * @brief Check whether a coordinate lies inside map bounds.
+ * @brief Apply this scan's hit updates and even-odd fill the visibility polygon in a row band.
+ * @param pose Robot pose; the robot cell is never freed.
+ * @param rowBegin First row written.
+ * @param rowEnd One past the last row written.
+ * @return Free and occupied count changes of the band.
+ * @note Hit cells are stamped first and skipped by the fill, so every cell gets at most one
+ * update per scan. A cell is inside when its center is.
  */
-bool OccupancyGridMap::InBounds(int x, int y) const {
-  return x >= 0 && x < width_ && y >= 0 && y < height_;
+OccupancyGridMap::CellCountDelta OccupancyGridMap::FillVisibilityRows(const RobotPose& pose, int rowBegin, int rowEnd) {
+  const int rowLow = std::max(rowBegin, 0);
+  const int rowHigh = std::min(rowEnd, height_);
+  const std::uint32_t generation = scanGeneration_;
+  const int robotX = static_cast<int>(pose.x);
+  const int robotY = static_cast<int>(pose.y);
+  const std::size_t robotIndex =
+      InBounds(robotX, robotY) ? Index(robotX, robotY) : grid_.size();
+  const double columnLimit = static_cast<double>(width_);
+
+  CellCountDelta counts;
+  WithCellUpdates(counts, [&](auto miss, auto onHit) {
+    for (const auto& [x, y] : polygonHits_) {
+      if (y >= rowLow && y < rowHigh && InBounds(x, y)) {
+        const std::size_t index = Index(x, y);
+        if (hitStamps_[index] != generation) {
+          hitStamps_[index] = generation;
+          onHit(index, x, y);
+        }
+      }
+    }
+    for (int row = rowLow; row < rowHigh; ++row) {
+      double* const first = rowCrossings_.data() + rowCrossingOffsets_[static_cast<std::size_t>(row)];
+      double* const last = rowCrossings_.data() + rowCrossingOffsets_[static_cast<std::size_t>(row) + 1U];
+      std::sort(first, last);
+      for (double* span = first; span + 1 < last; span += 2) {
+        const int columnBegin = static_cast<int>(std::ceil(std::clamp(span[0] - 0.5, 0.0, columnLimit)));
+        const int columnEnd = static_cast<int>(std::ceil(std::clamp(span[1] - 0.5, 0.0, columnLimit)));
+        for (int x = columnBegin; x < columnEnd; ++x) {
+          const std::size_t index = Index(x, row);
+          if (hitStamps_[index] != generation && index != robotIndex) {
+            miss(index, x, row);
+          }
+        }
+      }
+    }
+  });
+  return counts;
+}
+
+/**
+ * @brief Start a new stamp generation, clearing the stamps when the counter wraps.
+ */
+void OccupancyGridMap::BeginScan() {
+  if (!deduplicateScanUpdates_ && integrationMode_ != IntegrationMode::kVisibilityPolygon) {
+    return;
+  }
+  if (++scanGeneration_ == 0U) {
+    std::fill(missStamps_.begin(), missStamps_.end(), 0U);
+    std::fill(hitStamps_.begin(), hitStamps_.end(), 0U);
+    scanGeneration_ = 1U;
+  }
+}
+
+/**
+ * @brief Allocate zeroed generation stamps for every cell if they do not exist yet.
+ */
+void OccupancyGridMap::EnsureScanStamps() {
+  if (missStamps_.empty()) {
+    missStamps_.assign(grid_.size(), 0U);
+    hitStamps_.assign(grid_.size(), 0U);
+    scanGeneration_ = 0;
+  }
+}
+
+/**
+ * @brief Return the raw buffer after refilling rows left stale by Reset().
+ */
+const std::vector<std::int16_t>& OccupancyGridMap::Data() {
+  for (int y = 0; y < height_; ++y) {
+    EnsureRowCurrent(y);
+  }
+  return grid_;
+}
+
+/**
+ * @brief Refill one row with unknown if it has not been written since the last Reset().
+ * @note Row bands own whole rows, so concurrent bands never touch the same row stamp.
+ */
+void OccupancyGridMap::EnsureRowCurrent(int y) {
+  if (!currentRows_.Mark(static_cast<std::size_t>(y))) {
+    return;
+  }
+  const std::int16_t unknown = UnknownCellValue(mode_);
+  if (indexer_.Layout() == MapLayout::kRowMajor) {
+    std::fill_n(grid_.begin() + static_cast<std::ptrdiff_t>(Index(0, y)), width_, unknown);
+    return;
+  }
+  for (int x = 0; x < width_; ++x) {
+    grid_[Index(x, y)] = unknown;
+  }
 }
 
 /**
- * @brief Convert a 2D coordinate to row-major index.
+ * @brief Mark every row as holding valid cells.
  */
-int OccupancyGridMap::Index(int x, int y) const {
-  return y * width_ + x;
+void OccupancyGridMap::MarkAllRowsCurrent() {
+  for (std::size_t y = 0; y < currentRows_.Size(); ++y) {
+    currentRows_.Mark(y);
+  }
+}
+
+/**
+ * @brief Return the maintained cell counters.
+ */
+MapStats OccupancyGridMap::Stats() const {
+  const std::size_t total = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+  const auto freeCells = static_cast<std::size_t>(freeCells_);
+  const auto occupiedCells = static_cast<std::size_t>(occupiedCells_);
+  return MapStats{
+      .totalCells = total,
+      .knownCells = freeCells + occupiedCells,
+      .freeCells = freeCells,
+      .occupiedCells = occupiedCells,
+      .exploredFraction = static_cast<double>(freeCells + occupiedCells) / static_cast<double>(total),
+  };
+}
+
+/**
+ * @brief Record one cell's classification change in a count delta.
+ * @param counts Delta to update.
+ * @param before Raw value before the update.
+ * @param after Raw value after the update.
+ */
+void OccupancyGridMap::CountTransition(CellCountDelta& counts, std::int16_t before, std::int16_t after) const {
+  const std::int16_t from = ClassifyCellValue(mode_, logOdds_, before);
+  const std::int16_t to = ClassifyCellValue(mode_, logOdds_, after);
+  if (from != to) {
+    counts.freeCells += static_cast<std::int64_t>(to == kFree) - static_cast<std::int64_t>(from == kFree);
+    counts.occupiedCells += static_cast<std::int64_t>(to == kOccupied) - static_cast<std::int64_t>(from == kOccupied);
+  }
+}
+
+/**
+ * @brief Fold one scan's count changes into the map counters.
+ */
+void OccupancyGridMap::ApplyCountDelta(const CellCountDelta& counts) {
+  freeCells_ += counts.freeCells;
+  occupiedCells_ += counts.occupiedCells;
+}
+
+/**
+ * @brief Collect dirty tiles as row runs and clear the bitset.
+ * @param regions Output rectangles, cleared first.
+ * @return Bounding box of the regions.
+ */
+GridRect OccupancyGridMap::ConsumeDirtyRegions(std::vector<GridRect>& regions) {
+  regions.clear();
+  GridRect bounds{.xBegin = width_, .yBegin = height_, .xEnd = 0, .yEnd = 0};
+  const int tileSize = 1 << kTileShift;
+  for (std::size_t word = 0; word < dirtyTiles_.Size(); ++word) {
+    std::uint64_t bits = dirtyTiles_[word].exchange(0U, std::memory_order_relaxed);
+    while (bits != 0U) {
+      const std::size_t tile = word * 64U + static_cast<std::size_t>(std::countr_zero(bits));
+      bits &= bits - 1U;
+      const int x = static_cast<int>(tile % tilesPerRow_) * tileSize;
+      const int y = static_cast<int>(tile / tilesPerRow_) * tileSize;
+      const int xEnd = std::min(x + tileSize, width_);
+      if (!regions.empty() && regions.back().yBegin == y && regions.back().xEnd == x) {
+        regions.back().xEnd = xEnd;
+      } else {
+        regions.push_back(GridRect{.xBegin = x, .yBegin = y, .xEnd = xEnd, .yEnd = std::min(y + tileSize, height_)});
+      }
+      bounds.xBegin = std::min(bounds.xBegin, x);
+      bounds.yBegin = std::min(bounds.yBegin, y);
+      bounds.xEnd = std::max(bounds.xEnd, xEnd);
+      bounds.yEnd = std::max(bounds.yEnd, regions.back().yEnd);
+    }
+  }
+  return regions.empty() ? GridRect{} : bounds;
+}
+
+/**
+ * @brief Set the dirty bit of a cell's tile.
+ * @note The plain load skips the locked read-modify-write for tiles that are already dirty,
+ * which is the common case while a scan frees a long run of cells.
+ */
+void OccupancyGridMap::MarkDirty(int x, int y) {
+  const std::size_t tile =
+      (static_cast<std::size_t>(y) >> kTileShift) * tilesPerRow_ + (static_cast<std::size_t>(x) >> kTileShift);
+  std::atomic<std::uint64_t>& word = dirtyTiles_[tile >> 6U];
+  const std::uint64_t bit = std::uint64_t{1} << (tile & 63U);
+  if ((word.load(std::memory_order_relaxed) & bit) == 0U) {
+    word.fetch_or(bit, std::memory_order_relaxed);
+  }
+  if (!layerTiles_.Empty()) {
+    std::atomic<std::uint64_t>& layerWord = layerTiles_[tile >> 6U];
+    if ((layerWord.load(std::memory_order_relaxed) & bit) == 0U) {
+      layerWord.fetch_or(bit, std::memory_order_relaxed);
+    }
+  }
+}
+
+/**
+ * @brief Allocate the layer tile bitset while a derived layer is maintained, release it otherwise.
+ */
+void OccupancyGridMap::SizeLayerTiles() {
+  if (!maintainPyramid_ && !maintainField_) {
+    layerTiles_ = AtomicBitWords();
+  } else if (layerTiles_.Empty()) {
+    layerTiles_ = AtomicBitWords(dirtyTiles_.Size());
+  }
+}
+
+/**
+ * @brief Re-pool the pyramid ancestors and resync the field obstacles of every tile a scan changed.
+ * @note Runs on the calling thread after the row bands joined. Tiles are 16x16, so the
+ * first four levels of a tile's ancestors lie inside the tile; coarser levels are shared
+ * with neighbouring tiles and the refresh stops once a level comes out unchanged. The
+ * field only hears about cells whose occupied classification flipped, then propagates all
+ * of them in one update.
+ */
+void OccupancyGridMap::UpdateLayers() {
+  if (layerTiles_.Empty()) {
+    return;
+  }
+  const int tileSize = 1 << kTileShift;
+  const auto base = [this](int x, int y) { return ValueAt(x, y); };
+  for (std::size_t word = 0; word < layerTiles_.Size(); ++word) {
+    std::uint64_t bits = layerTiles_[word].exchange(0U, std::memory_order_relaxed);
+    while (bits != 0U) {
+      const std::size_t tile = word * 64U + static_cast<std::size_t>(std::countr_zero(bits));
+      bits &= bits - 1U;
+      const int x = static_cast<int>(tile % tilesPerRow_) * tileSize;
+      const int y = static_cast<int>(tile / tilesPerRow_) * tileSize;
+      const GridRect cells{
+          .xBegin = x, .yBegin = y, .xEnd = std::min(x + tileSize, width_), .yEnd = std::min(y + tileSize, height_)};
+      if (maintainPyramid_) {
+        pyramid_.Refresh(cells, base);
+      }
+      if (maintainField_) {
+        for (int cellY = cells.yBegin; cellY < cells.yEnd; ++cellY) {
+          for (int cellX = cells.xBegin; cellX < cells.xEnd; ++cellX) {
+            const bool occupied = ClassifiedValueAt(cellX, cellY) == kOccupied;
+            if (occupied && !field_.IsObstacle(cellX, cellY)) {
+              field_.SetObstacle(cellX, cellY);
+            } else if (!occupied && field_.IsObstacle(cellX, cellY)) {
+              field_.RemoveObstacle(cellX, cellY);
+            }
+          }
+        }
+      }
+    }
+  }
+  if (maintainField_) {
+    field_.Update();
+  }
+}
+
+/**
+ * @brief Check whether a coordinate lies inside map bounds.
+ */
+bool OccupancyGridMap::InBounds(int x, int y) const {
+  return x >= 0 && x < width_ && y >= 0 && y < height_;
 }
 
 }  // namespace slam::core
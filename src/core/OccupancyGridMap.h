@@ -1,9 +1,21 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <span>
+#include <utility>
 #include <vector>
 
+#include "core/AtomicBitWords.h"
+#include "core/EpochMarks.h"
+#include "core/GridIndexer.h"
+#include "core/GridLine.h"
+#include "core/LikelihoodField.h"
+#include "core/MapPyramid.h"
+#include "core/ScanBuffer.h"
 #include "core/Types.h"
+#include "core/WorkerPool.h"
 
 /**
  * @file OccupancyGridMap.h
@@ -12,8 +24,27 @@
 
 namespace slam::core {
 
+/**
+ * @brief Cell counts of an occupancy map, classified as by ClassifiedValueAt().
+ */
+struct MapStats {
+  /// Width times height.
+  std::size_t totalCells = 0;
+  /// Cells classified free or occupied.
+  std::size_t knownCells = 0;
+  /// Cells classified kFree.
+  std::size_t freeCells = 0;
+  /// Cells classified kOccupied.
+  std::size_t occupiedCells = 0;
+  /// knownCells / totalCells, in [0, 1].
+  double exploredFraction = 0.0;
+};
+
 /**
  * @brief Reconstructed occupancy map updated by lidar scans.
+ * @note In MapUpdateMode::kOverwrite cells hold kUnknown, kFree, or kOccupied directly. In
+ * MapUpdateMode::kLogOdds they hold clamped log-odds in hundredths, and
+ * ClassifiedValueAt() thresholds them back to those three states.
  */
 class OccupancyGridMap {
  public:
@@ -21,40 +52,295 @@ class OccupancyGridMap {
    * @brief Construct an occupancy map initialized to unknown.
    * @param width Map width in cells.
    * @param height Map height in cells.
+   * @param mode Cell update rule.
+   * @param logOdds Increments, clamps, and thresholds for MapUpdateMode::kLogOdds.
+   * @throws std::invalid_argument when dimensions are not positive, or when log-odds mode gets
+   * non-positive increments, a clamp range that excludes 0, or thresholds outside it.
+   */
+  OccupancyGridMap(
+      int width, int height, MapUpdateMode mode = MapUpdateMode::kOverwrite, const LogOddsParams& logOdds = {});
+  /**
+   * @brief Copy every cell, counter, maintained layer, option, and pending dirty tile.
+   * @note A map must not be copied while a scan is integrated into it.
    */
-  OccupancyGridMap(int width, int height);
+  OccupancyGridMap(const OccupancyGridMap&) = default;
+  OccupancyGridMap& operator=(const OccupancyGridMap&) = default;
+  OccupancyGridMap(OccupancyGridMap&&) noexcept = default;
+  OccupancyGridMap& operator=(OccupancyGridMap&&) noexcept = default;
 
-  /// Reset all cells back to unknown.
+  /**
+   * @brief Reset all cells back to unknown.
+   * @note O(1) apart from marking the tile bitset dirty: rows carry an epoch stamp and a
+   * stale row is refilled lazily the first time a scan writes to it.
+   */
   void Reset();
-  /// Read one map cell value.
+  /// Read one raw map cell value; log-odds in hundredths in MapUpdateMode::kLogOdds.
   std::int16_t ValueAt(int x, int y) const;
+  /// Read one map cell as kUnknown, kFree, or kOccupied in either update mode.
+  std::int16_t ClassifiedValueAt(int x, int y) const;
   /**
    * @brief Integrate one lidar scan into the map.
    * @param pose Robot pose at scan time.
    * @param scan Beam samples.
    */
   void IntegrateScan(const RobotPose& pose, const std::vector<ScanSample>& scan);
+  /**
+   * @brief Integrate one lidar scan held in caller-owned storage.
+   * @param pose Robot pose at scan time.
+   * @param scan Beam samples.
+   */
+  void IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan);
+  /**
+   * @brief Integrate one lidar scan using its precomputed world-space endpoints.
+   * @param pose Robot pose at scan time.
+   * @param scan Struct-of-arrays scan with endpoints.
+   */
+  void IntegrateScan(const RobotPose& pose, const ScanBuffer& scan);
+  /**
+   * @brief Integrate one lidar scan with disjoint row bands updated in parallel.
+   * @param pose Robot pose at scan time.
+   * @param scan Struct-of-arrays scan with endpoints.
+   * @param pool Worker pool; each thread owns a band of rows, so the result matches the serial update.
+   */
+  void IntegrateScan(const RobotPose& pose, const ScanBuffer& scan, WorkerPool& pool);
 
   /// @return Map width in cells.
   int Width() const { return width_; }
   /// @return Map height in cells.
   int Height() const { return height_; }
-  /// @return Raw occupancy buffer in row-major order.
-  const std::vector<std::int16_t>& Data() const { return grid_; }
+  /**
+   * @brief Limit every cell to at most one free and one occupied update per integrated scan.
+   * @param enabled True to deduplicate; allocates two generation stamps per cell on first use.
+   * @note Off by default. Beams near the robot share their first cells, so a dense scan
+   * otherwise updates those cells once per beam, which over-counts evidence in log-odds mode.
+   * In overwrite mode a deduplicated cell keeps the first free and first occupied write of
+   * the scan instead of the last one.
+   */
+  void SetDeduplicateScanUpdates(bool enabled);
+  /// @return True when updates are deduplicated per scan.
+  bool DeduplicatesScanUpdates() const { return deduplicateScanUpdates_; }
+  /**
+   * @brief Choose how free space is rasterized.
+   * @param mode IntegrationMode::kBeams walks one line per beam. IntegrationMode::kVisibilityPolygon
+   * fills the polygon through consecutive beam endpoints, so each visible cell gets exactly
+   * one free update and gaps between sparse beams are covered.
+   * @note The polygon mode assumes beams sweep a full circle in angle order, as SimulatedLidar
+   * produces. Scans with fewer than three beams fall back to per-beam lines. Behind an
+   * occluder's silhouette the fill stops at the occluder's range; an obstacle corner that
+   * sticks out between two beams can still lose its outermost cells.
+   */
+  void SetIntegrationMode(IntegrationMode mode);
+  /// @return Free-space rasterization mode.
+  IntegrationMode ScanIntegrationMode() const { return integrationMode_; }
+  /**
+   * @brief Choose the memory order of the cells, moving existing cells over.
+   * @param layout MapLayout::kRowMajor, MapLayout::kTiled, or MapLayout::kMorton.
+   * @note Cell values and scan results do not depend on the layout. Tiled storage is padded
+   * to whole tiles and Morton storage to power-of-two sides, so a beam's cells share cache
+   * lines in both directions on large maps.
+   */
+  void SetLayout(MapLayout layout);
+  /// @return Cell memory order.
+  MapLayout Layout() const { return indexer_.Layout(); }
+  /**
+   * @brief Maintain a max-pooled pyramid (2x, 4x, 8x, ... coarser levels) alongside the cells.
+   * @param enabled True to build the pyramid from the current cells and keep it current;
+   * false to release it.
+   * @note Off by default. Scans refresh only the ancestors of the 16x16 tiles they changed,
+   * after the cells are written, and stop climbing at the first level that did not change.
+   * Reset() refills the pyramid with unknown, about a third of the map's cell count.
+   */
+  void SetMaintainPyramid(bool enabled);
+  /// @return True when the pyramid is maintained.
+  bool MaintainsPyramid() const { return maintainPyramid_; }
+  /// @return Pyramid levels including level 0 (the cells); 1 when no pyramid is maintained.
+  int PyramidLevels() const { return maintainPyramid_ ? pyramid_.LevelCount() : 1; }
+  /**
+   * @brief Largest raw value of the 2^level x 2^level block of cells at (x, y) of a level.
+   * @param level 0 for a single cell, up to PyramidLevels() - 1.
+   * @param x Block column at that level; covers cells [x << level, (x + 1) << level).
+   * @param y Block row at that level.
+   * @return The pooled value, or the unknown value for blocks outside the map.
+   */
+  std::int16_t PooledValueAt(int level, int x, int y) const;
+  /**
+   * @brief True when any cell of the 2^level x 2^level block at (x, y) of a level is occupied.
+   * @note O(1) per query at every level; blocks outside the map are never occupied.
+   */
+  bool AnyOccupied(int level, int x, int y) const;
+  /// @return Pooled levels 1 and up; empty unless MaintainsPyramid().
+  const MapPyramid& Pyramid() const { return pyramid_; }
+  /**
+   * @brief Maintain a likelihood field: the distance from every cell to the nearest occupied cell.
+   * @param enabled True to build the field from the current cells and keep it current;
+   * false to release it.
+   * @param options Distance range and likelihood spread of the field.
+   * @throws std::invalid_argument on invalid field options.
+   * @note Off by default. After each scan the cells of the 16x16 tiles it changed are
+   * compared with the field's obstacles, and only cells that became or stopped being
+   * occupied are fed to the field's incremental update. Reset() clears the field, O(cells).
+   */
+  void SetMaintainLikelihoodField(bool enabled, const LikelihoodFieldOptions& options = {});
+  /// @return True when the likelihood field is maintained.
+  bool MaintainsLikelihoodField() const { return maintainField_; }
+  /// @return Likelihood field over the occupied cells; empty unless MaintainsLikelihoodField().
+  const LikelihoodField& Field() const { return field_; }
+  /// @return Cell update rule.
+  MapUpdateMode UpdateMode() const { return mode_; }
+  /// @return Log-odds parameters; only used in MapUpdateMode::kLogOdds.
+  const LogOddsParams& LogOdds() const { return logOdds_; }
+  /**
+   * @brief Known, free, and occupied cell counts in O(1).
+   * @note Counters are adjusted on every classification change inside IntegrateScan and
+   * Reset, so reading them never walks the grid. Row bands collect their own changes and
+   * the scan folds them in afterwards.
+   */
+  MapStats Stats() const;
+  /**
+   * @brief Hand over the cells changed since the last call and start tracking afresh.
+   * @param regions Cleared, then filled with disjoint rectangles covering every changed cell:
+   * runs of adjacent dirty 16x16 tiles along a tile row, clipped to the map.
+   * @return Bounding box of the regions; all zero when nothing changed.
+   * @note Scans record a tile when one of its cell values actually changes, so a scan that
+   * only confirms known cells leaves nothing to redraw. A cell that one beam frees and a
+   * later beam of the same scan marks occupied again still counts as changed. Reset() dirties the whole map; a
+   * new map starts clean because consumers start from an all-unknown view anyway. Cost is
+   * one pass over the tile bitset (one bit per tile) plus the dirty tiles. Must not run
+   * concurrently with IntegrateScan.
+   */
+  GridRect ConsumeDirtyRegions(std::vector<GridRect>& regions);
+
+  /// @return Raw occupancy buffer in Layout() order, including padding; refills rows stale since Reset().
+  const std::vector<std::int16_t>& Data();
+
+  /// Edge length of tiled-layout and dirty-region tiles is 1 << kTileShift cells.
+  static constexpr int kTileShift = GridIndexer::kTileShift;
 
  private:
+  /**
+   * @brief Change in free and occupied cell counts collected while updating cells.
+   */
+  struct CellCountDelta {
+    std::int64_t freeCells = 0;
+    std::int64_t occupiedCells = 0;
+  };
+
+  /**
+   * @brief Integrate every beam of a scan, writing only rows [rowBegin, rowEnd).
+   */
+  CellCountDelta IntegrateScanRows(const RobotPose& pose, const ScanBuffer& scan, int rowBegin, int rowEnd);
+  /**
+   * @brief Free cells from the robot cell toward a beam end cell and mark the end on hits.
+   * @note Only cells in rows [rowBegin, rowEnd) are written.
+   */
+  void IntegrateBeam(
+      std::pair<int, int> start, int endX, int endY, bool hit, int rowBegin, int rowEnd, CellCountDelta& counts);
+  /**
+   * @brief Call fn(miss, hit) with the cell update callables of the current update mode.
+   * @note Both callables take (index, x, y); when a cell's value changes they record its tile
+   * and its classification change in counts.
+   */
+  template <typename Fn>
+  void WithCellUpdates(CellCountDelta& counts, Fn&& fn);
+  /**
+   * @brief Walk one clipped beam, calling miss(index, x, y) for ray cells and onHit(index, x, y) for a hit's end cell.
+   */
+  template <typename MissFn, typename HitFn>
+  void ApplyBeam(std::pair<int, int> start, int endX, int endY, bool hit, const GridRect& band, MissFn&& miss, HitFn&& onHit);
+  /**
+   * @brief Advance the scan generation used by per-scan deduplication and polygon fills.
+   */
+  void BeginScan();
+  /**
+   * @brief Allocate the per-cell generation stamps on first use.
+   */
+  void EnsureScanStamps();
+  /**
+   * @brief True when a scan of beamCount beams is integrated as a visibility polygon.
+   */
+  bool UsesVisibilityPolygon(std::size_t beamCount) const;
+  /**
+   * @brief Collect polygon vertices and hit cells, and bucket the polygon's row crossings.
+   * @param endpoint Callable returning {x, y, hit} for a beam index.
+   */
+  template <typename EndpointFn>
+  void BuildVisibilityPolygon(const RobotPose& pose, std::size_t beamCount, EndpointFn&& endpoint);
+  /**
+   * @brief Apply hit updates and fill the built polygon's interior, only in rows [rowBegin, rowEnd).
+   */
+  CellCountDelta FillVisibilityRows(const RobotPose& pose, int rowBegin, int rowEnd);
+  /**
+   * @brief Add one cell's classification change to a count delta.
+   */
+  void CountTransition(CellCountDelta& counts, std::int16_t before, std::int16_t after) const;
+  /**
+   * @brief Apply a count delta to the map counters.
+   */
+  void ApplyCountDelta(const CellCountDelta& counts);
+  /**
+   * @brief Refill row y with unknown when it is stale since the last Reset().
+   */
+  void EnsureRowCurrent(int y);
+  /**
+   * @brief Mark every row as holding valid cells, e.g. after the buffer was rebuilt.
+   */
+  void MarkAllRowsCurrent();
+  /**
+   * @brief Record that a cell's value changed; safe to call from concurrent row bands.
+   */
+  void MarkDirty(int x, int y);
+  /**
+   * @brief Refresh the pyramid and the likelihood field over the tiles changed since the last refresh.
+   */
+  void UpdateLayers();
+  /**
+   * @brief Allocate or release the layer tile bitset to match the maintained layers.
+   */
+  void SizeLayerTiles();
   /**
    * @brief Check whether a coordinate is inside map bounds.
    */
   bool InBounds(int x, int y) const;
   /**
-   * @brief Convert 2D coordinate to row-major index.
+   * @brief Convert 2D coordinate to a buffer index in the current layout.
    */
-  int Index(int x, int y) const;
+  std::size_t Index(int x, int y) const { return indexer_.Index(x, y); }
 
   int width_ = 0;
   int height_ = 0;
+  MapUpdateMode mode_ = MapUpdateMode::kOverwrite;
+  LogOddsParams logOdds_{};
+  GridIndexer indexer_;
+  /// Dirty-tile grid dimensions.
+  std::size_t tilesPerRow_ = 0;
+  std::size_t tileRows_ = 0;
   std::vector<std::int16_t> grid_;
+  /// Rows written since the last Reset(); cells of unmarked rows read as unknown.
+  EpochMarks<std::uint32_t> currentRows_;
+  std::int64_t freeCells_ = 0;
+  std::int64_t occupiedCells_ = 0;
+  /// Per-band count deltas of the last parallel scan, kept to avoid reallocating.
+  std::vector<CellCountDelta> bandCounts_;
+  /// One bit per 16x16 tile, tiles in row-major order; atomic because row bands share tiles.
+  AtomicBitWords dirtyTiles_;
+  bool maintainPyramid_ = false;
+  MapPyramid pyramid_;
+  bool maintainField_ = false;
+  LikelihoodField field_;
+  /// Tiles changed since the pyramid and field were last refreshed; same bit order as
+  /// dirtyTiles_, empty while neither is maintained.
+  AtomicBitWords layerTiles_;
+  bool deduplicateScanUpdates_ = false;
+  std::uint32_t scanGeneration_ = 0;
+  std::vector<std::uint32_t> missStamps_;
+  std::vector<std::uint32_t> hitStamps_;
+  IntegrationMode integrationMode_ = IntegrationMode::kBeams;
+  std::vector<double> polygonX_;
+  std::vector<double> polygonY_;
+  std::vector<std::pair<int, int>> polygonHits_;
+  /// Row r's polygon crossings are rowCrossings_[rowCrossingOffsets_[r], rowCrossingOffsets_[r + 1]).
+  std::vector<int> rowCrossingOffsets_;
+  std::vector<double> rowCrossings_;
 };
 
 }  // namespace slam::core
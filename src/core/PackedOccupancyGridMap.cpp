@@ -0,0 +1,314 @@
+/**
+ * @file PackedOccupancyGridMap.cpp
+ * @brief Two-bit occupancy storage with word-parallel fills, counts, and pixel expansion.
+ */
+
+#include "core/PackedOccupancyGridMap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "core/GridLine.h"
+
+namespace slam::core {
+namespace {
+
+/// Low bit of every two-bit cell in a word.
+constexpr std::uint64_t kLowBits = 0x5555555555555555ULL;
+/// Mask of a coordinate's cell slot within its word.
+constexpr int kSlotMask = PackedOccupancyGridMap::kCellsPerWord - 1;
+
+/**
+ * @brief Two-bit code of a kUnknown/kFree/kOccupied value.
+ */
+constexpr std::uint8_t CodeOf(std::int16_t value) {
+  if (value == kFree) {
+    return PackedOccupancyGridMap::kFreeCode;
+  }
+  return (value == kOccupied) ? PackedOccupancyGridMap::kOccupiedCode : PackedOccupancyGridMap::kUnknownCode;
+}
+
+/**
+ * @brief Word with every cell set to code.
+ */
+constexpr std::uint64_t Broadcast(std::uint8_t code) {
+  return kLowBits * code;
+}
+
+/**
+ * @brief Mask covering cell slots [slotBegin, slotEnd) of a word.
+ */
+constexpr std::uint64_t SlotMask(int slotBegin, int slotEnd) {
+  const std::uint64_t high = (slotEnd == PackedOccupancyGridMap::kCellsPerWord)
+                                 ? ~std::uint64_t{0}
+                                 : ((std::uint64_t{1} << (2 * slotEnd)) - 1U);
+  return high & ~((std::uint64_t{1} << (2 * slotBegin)) - 1U);
+}
+
+}  // namespace
+
+/**
+ * @brief Construct a packed map initialized to unknown.
+ * @param width Map width in cells.
+ * @param height Map height in cells.
+ */
+PackedOccupancyGridMap::PackedOccupancyGridMap(int width, int height) : width_(width), height_(height) {
+  if (width <= 0 || height <= 0) {
+    throw std::invalid_argument("PackedOccupancyGridMap dimensions must be positive");
+  }
+  wordsPerRow_ = (static_cast<std::size_t>(width) + kSlotMask) / kCellsPerWord;
+  words_.assign(wordsPerRow_ * static_cast<std::size_t>(height), 0U);
+}
+
+/**
+ * @brief Reset all cells to unknown state.
+ */
+void PackedOccupancyGridMap::Reset() {
+  std::fill(words_.begin(), words_.end(), 0U);
+}
+
+/**
+ * @brief Read map value at a coordinate.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return Occupancy state value.
+ */
+std::int16_t PackedOccupancyGridMap::ValueAt(int x, int y) const {
+  switch (CodeAt(x, y)) {
+    case kFreeCode:
+      return kFree;
+    case kOccupiedCode:
+      return kOccupied;
+    default:
+      return kUnknown;
+  }
+}
+
+/**
+ * @brief Read a cell's two-bit code.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return kUnknownCode, kFreeCode, or kOccupiedCode.
+ */
+std::uint8_t PackedOccupancyGridMap::CodeAt(int x, int y) const {
+  if (!InBounds(x, y)) {
+    return kUnknownCode;
+  }
+  const std::uint64_t word = words_[static_cast<std::size_t>(y) * wordsPerRow_ + static_cast<std::size_t>(x / kCellsPerWord)];
+  return static_cast<std::uint8_t>((word >> (2 * (x & kSlotMask))) & 3U);
+}
+
+/**
+ * @brief Overwrite one cell.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @param value kUnknown, kFree, or kOccupied.
+ */
+void PackedOccupancyGridMap::Set(int x, int y, std::int16_t value) {
+  if (InBounds(x, y)) {
+    SetCode(x, y, CodeOf(value));
+  }
+}
+
+/**
+ * @brief Overwrite a run of cells in one row.
+ * @param y Row.
+ * @param xBegin First cell written.
+ * @param xEnd One past the last cell written.
+ * @param value kUnknown, kFree, or kOccupied.
+ * @note Partial words at either end are blended under a mask; whole words in between are
+ * stored directly.
+ */
+void PackedOccupancyGridMap::FillSpan(int y, int xBegin, int xEnd, std::int16_t value) {
+  xBegin = std::max(xBegin, 0);
+  xEnd = std::min(xEnd, width_);
+  if (y < 0 || y >= height_ || xBegin >= xEnd) {
+    return;
+  }
+  const std::uint64_t pattern = Broadcast(CodeOf(value));
+  std::uint64_t* row = words_.data() + static_cast<std::size_t>(y) * wordsPerRow_;
+  const int firstWord = xBegin / kCellsPerWord;
+  const int lastWord = (xEnd - 1) / kCellsPerWord;
+  const auto blend = [&](int word, std::uint64_t mask) { row[word] = (row[word] & ~mask) | (pattern & mask); };
+  if (firstWord == lastWord) {
+    blend(firstWord, SlotMask(xBegin & kSlotMask, ((xEnd - 1) & kSlotMask) + 1));
+    return;
+  }
+  blend(firstWord, SlotMask(xBegin & kSlotMask, kCellsPerWord));
+  std::fill(row + firstWord + 1, row + lastWord, pattern);
+  blend(lastWord, SlotMask(0, ((xEnd - 1) & kSlotMask) + 1));
+}
+
+/**
+ * @brief Integrate one lidar scan held in caller-owned storage.
+ * @param pose Robot pose.
+ * @param scan Scan samples to fuse.
+ */
+void PackedOccupancyGridMap::IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan) {
+  const int startX = static_cast<int>(pose.x);
+  const int startY = static_cast<int>(pose.y);
+  for (const ScanSample& sample : scan) {
+    const double angle = pose.theta + sample.relativeAngle;
+    IntegrateBeam(startX, startY, static_cast<int>(pose.x + std::cos(angle) * sample.distance),
+                  static_cast<int>(pose.y + std::sin(angle) * sample.distance), sample.hit);
+  }
+}
+
+/**
+ * @brief Integrate one struct-of-arrays scan from its stored endpoints.
+ * @param pose Robot pose.
+ * @param scan Scan with world-space endpoints.
+ */
+void PackedOccupancyGridMap::IntegrateScan(const RobotPose& pose, const ScanBuffer& scan) {
+  const int startX = static_cast<int>(pose.x);
+  const int startY = static_cast<int>(pose.y);
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    IntegrateBeam(startX, startY, static_cast<int>(scan.EndX()[i]), static_cast<int>(scan.EndY()[i]), scan.Hit(i));
+  }
+}
+
+/**
+ * @brief Pack another map's classified cells.
+ * @param map Source map.
+ */
+void PackedOccupancyGridMap::Assign(const OccupancyGridMap& map) {
+  width_ = map.Width();
+  height_ = map.Height();
+  wordsPerRow_ = (static_cast<std::size_t>(width_) + kSlotMask) / kCellsPerWord;
+  words_.assign(wordsPerRow_ * static_cast<std::size_t>(height_), 0U);
+  for (int y = 0; y < height_; ++y) {
+    std::uint64_t* row = words_.data() + static_cast<std::size_t>(y) * wordsPerRow_;
+    for (int x = 0; x < width_; ++x) {
+      row[x / kCellsPerWord] |= static_cast<std::uint64_t>(CodeOf(map.ClassifiedValueAt(x, y))) << (2 * (x & kSlotMask));
+    }
+  }
+}
+
+/**
+ * @brief Count free and occupied cells a word at a time.
+ * @return Cell counts; padding cells are unknown and never counted.
+ */
+MapStats PackedOccupancyGridMap::Stats() const {
+  std::size_t freeCells = 0;
+  std::size_t occupiedCells = 0;
+  for (const std::uint64_t word : words_) {
+    const std::uint64_t low = word & kLowBits;
+    const std::uint64_t high = (word >> 1U) & kLowBits;
+    freeCells += static_cast<std::size_t>(std::popcount(low & ~high));
+    occupiedCells += static_cast<std::size_t>(std::popcount(high & ~low));
+  }
+  const std::size_t total = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+  return MapStats{
+      .totalCells = total,
+      .knownCells = freeCells + occupiedCells,
+      .freeCells = freeCells,
+      .occupiedCells = occupiedCells,
+      .exploredFraction = static_cast<double>(freeCells + occupiedCells) / static_cast<double>(total),
+  };
+}
+
+/**
+ * @brief Expand cells to one code byte each.
+ * @param out Destination, row-major.
+ */
+void PackedOccupancyGridMap::ExpandToPaletteIndices(std::span<std::uint8_t> out) const {
+  const std::size_t width = static_cast<std::size_t>(width_);
+  if (out.size() < width * static_cast<std::size_t>(height_)) {
+    throw std::invalid_argument("PackedOccupancyGridMap palette output is smaller than the map");
+  }
+  // Entry b holds the four codes packed in byte b, in cell order.
+  std::array<std::array<std::uint8_t, 4>, 256> table{};
+  for (std::size_t b = 0; b < table.size(); ++b) {
+    for (std::size_t cell = 0; cell < 4U; ++cell) {
+      table[b][cell] = static_cast<std::uint8_t>((b >> (2U * cell)) & 3U);
+    }
+  }
+  const std::size_t wholeBytes = width / 4U;
+  for (std::size_t y = 0; y < static_cast<std::size_t>(height_); ++y) {
+    const std::uint64_t* row = words_.data() + y * wordsPerRow_;
+    std::uint8_t* pixels = out.data() + y * width;
+    for (std::size_t b = 0; b < wholeBytes; ++b) {
+      const std::size_t packed = (row[b / 8U] >> (8U * (b % 8U))) & 0xFFU;
+      std::memcpy(pixels + 4U * b, table[packed].data(), 4U);
+    }
+    for (std::size_t x = 4U * wholeBytes; x < width; ++x) {
+      pixels[x] = static_cast<std::uint8_t>((row[x / kCellsPerWord] >> (2U * (x % kCellsPerWord))) & 3U);
+    }
+  }
+}
+
+/**
+ * @brief Expand cells to RGBA bytes.
+ * @param palette Colors indexed by code.
+ * @param out Destination, row-major, four bytes per cell.
+ * @note The table is rebuilt per call (4 KiB), which is small next to any map worth packing.
+ */
+void PackedOccupancyGridMap::ExpandToRgba(const RgbaPalette& palette, std::span<std::uint8_t> out) const {
+  const std::size_t width = static_cast<std::size_t>(width_);
+  if (out.size() < 4U * width * static_cast<std::size_t>(height_)) {
+    throw std::invalid_argument("PackedOccupancyGridMap RGBA output is smaller than the map");
+  }
+  // Entry b holds the 16 RGBA bytes of the four cells packed in byte b; the unused code 3
+  // maps to the unknown color.
+  std::array<std::array<std::uint8_t, 16>, 256> table{};
+  for (std::size_t b = 0; b < table.size(); ++b) {
+    for (std::size_t cell = 0; cell < 4U; ++cell) {
+      const std::size_t code = (b >> (2U * cell)) & 3U;
+      std::memcpy(table[b].data() + 4U * cell, palette[(code < palette.size()) ? code : 0U].data(), 4U);
+    }
+  }
+  const std::size_t wholeBytes = width / 4U;
+  for (std::size_t y = 0; y < static_cast<std::size_t>(height_); ++y) {
+    const std::uint64_t* row = words_.data() + y * wordsPerRow_;
+    std::uint8_t* pixels = out.data() + 4U * y * width;
+    for (std::size_t b = 0; b < wholeBytes; ++b) {
+      const std::size_t packed = (row[b / 8U] >> (8U * (b % 8U))) & 0xFFU;
+      std::memcpy(pixels + 16U * b, table[packed].data(), 16U);
+    }
+    for (std::size_t x = 4U * wholeBytes; x < width; ++x) {
+      const std::size_t code = (row[x / kCellsPerWord] >> (2U * (x % kCellsPerWord))) & 3U;
+      std::memcpy(pixels + 4U * x, palette[(code < palette.size()) ? code : 0U].data(), 4U);
+    }
+  }
+}
+
+/**
+ * @brief Overwrite the cells of one beam.
+ * @param startX Robot cell X.
+ * @param startY Robot cell Y.
+ * @param endX Beam end cell X.
+ * @param endY Beam end cell Y.
+ * @param hit True when the beam terminated on an obstacle.
+ * @note Same cells as OccupancyGridMap's per-beam walk: the robot cell is never freed and
+ * a hit's end cell is marked occupied instead.
+ */
+void PackedOccupancyGridMap::IntegrateBeam(int startX, int startY, int endX, int endY, bool hit) {
+  const int length = GridLineLength(startX, startY, endX, endY);
+  const GridRect bounds{.xBegin = 0, .yBegin = 0, .xEnd = width_, .yEnd = height_};
+  VisitGridLine(startX, startY, endX, endY, 1, hit ? length : length + 1, bounds,
+                [&](int x, int y) { SetCode(x, y, kFreeCode); });
+  if (hit && InBounds(endX, endY)) {
+    SetCode(endX, endY, kOccupiedCode);
+  }
+}
+
+/**
+ * @brief Write one cell's code.
+ */
+void PackedOccupancyGridMap::SetCode(int x, int y, std::uint8_t code) {
+  std::uint64_t& word = words_[static_cast<std::size_t>(y) * wordsPerRow_ + static_cast<std::size_t>(x / kCellsPerWord)];
+  const int shift = 2 * (x & kSlotMask);
+  word = (word & ~(std::uint64_t{3} << shift)) | (static_cast<std::uint64_t>(code) << shift);
+}
+
+/**
+ * @brief Check whether a coordinate is inside map bounds.
+ */
+bool PackedOccupancyGridMap::InBounds(int x, int y) const {
+  return x >= 0 && y >= 0 && x < width_ && y < height_;
+}
+
+}  // namespace slam::core
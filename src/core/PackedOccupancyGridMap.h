@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/Types.h"
+
+/**
+ * @file PackedOccupancyGridMap.h
+ * @brief Three-state occupancy map stored at two bits per cell.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Overwrite-mode occupancy map packing 32 cells into each 64-bit word.
+ * @note Holds only kUnknown, kFree, and kOccupied, so it is 8x smaller than the int16
+ * OccupancyGridMap; log-odds evidence stays in OccupancyGridMap and can be packed with
+ * Assign() for display. Each row starts on a word boundary, which lets span fills, counts,
+ * and expansion work a word (32 cells) or a byte (4 cells) at a time.
+ */
+class PackedOccupancyGridMap {
+ public:
+  /// Cells per storage word.
+  static constexpr int kCellsPerWord = 32;
+  /// Two-bit code of a never-observed cell; zeroed storage reads unknown.
+  static constexpr std::uint8_t kUnknownCode = 0;
+  /// Two-bit code of a free cell.
+  static constexpr std::uint8_t kFreeCode = 1;
+  /// Two-bit code of an occupied cell.
+  static constexpr std::uint8_t kOccupiedCode = 2;
+
+  /// RGBA bytes for kUnknownCode, kFreeCode, and kOccupiedCode, in that order.
+  using RgbaPalette = std::array<std::array<std::uint8_t, 4>, 3>;
+
+  /**
+   * @brief Construct a map initialized to unknown.
+   * @param width Map width in cells.
+   * @param height Map height in cells.
+   * @throws std::invalid_argument when dimensions are not positive.
+   */
+  PackedOccupancyGridMap(int width, int height);
+
+  /// Reset all cells back to unknown.
+  void Reset();
+  /// Read one cell as kUnknown, kFree, or kOccupied; unknown outside the map.
+  std::int16_t ValueAt(int x, int y) const;
+  /// Read one cell's two-bit code; kUnknownCode outside the map.
+  std::uint8_t CodeAt(int x, int y) const;
+  /**
+   * @brief Overwrite one cell.
+   * @param value kUnknown, kFree, or kOccupied; cells outside the map are ignored.
+   */
+  void Set(int x, int y, std::int16_t value);
+  /**
+   * @brief Overwrite cells [xBegin, xEnd) of row y, whole words at a time.
+   * @param value kUnknown, kFree, or kOccupied; the span is clipped to the map.
+   */
+  void FillSpan(int y, int xBegin, int xEnd, std::int16_t value);
+  /**
+   * @brief Integrate one lidar scan; free and hit cells match OccupancyGridMap's kOverwrite beams.
+   * @param pose Robot pose at scan time.
+   * @param scan Beam samples.
+   */
+  void IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan);
+  /**
+   * @brief Integrate one lidar scan using its precomputed world-space endpoints.
+   * @param pose Robot pose at scan time.
+   * @param scan Struct-of-arrays scan with endpoints.
+   */
+  void IntegrateScan(const RobotPose& pose, const ScanBuffer& scan);
+  /**
+   * @brief Replace the contents with another map's classified cells, resizing to match.
+   * @param map Map in either update mode; each cell is packed from ClassifiedValueAt().
+   */
+  void Assign(const OccupancyGridMap& map);
+
+  /**
+   * @brief Known, free, and occupied cell counts.
+   * @note One pass over the words with two popcounts each, 32 cells per step.
+   */
+  MapStats Stats() const;
+  /**
+   * @brief Expand every cell to one palette index (its two-bit code) per byte, row-major.
+   * @param out At least Width() * Height() bytes.
+   * @throws std::invalid_argument when out is too small.
+   */
+  void ExpandToPaletteIndices(std::span<std::uint8_t> out) const;
+  /**
+   * @brief Expand every cell to four RGBA bytes, row-major, ready for a texture upload.
+   * @param palette Colors of unknown, free, and occupied cells.
+   * @param out At least 4 * Width() * Height() bytes.
+   * @throws std::invalid_argument when out is too small.
+   * @note Looks up 4 cells (one packed byte) at a time in a 256-entry table of 16-byte runs.
+   */
+  void ExpandToRgba(const RgbaPalette& palette, std::span<std::uint8_t> out) const;
+
+  /// @return Map width in cells.
+  int Width() const { return width_; }
+  /// @return Map height in cells.
+  int Height() const { return height_; }
+  /// @return Words per row; row y occupies Words()[y * WordsPerRow(), (y + 1) * WordsPerRow()).
+  std::size_t WordsPerRow() const { return wordsPerRow_; }
+  /// @return Packed cells; cell x of a row sits at bits 2 * (x % 32) of word x / 32.
+  std::span<const std::uint64_t> Words() const { return words_; }
+  /// @return Bytes of cell storage.
+  std::size_t CellBytes() const { return words_.size() * sizeof(std::uint64_t); }
+
+ private:
+  /**
+   * @brief Overwrite cells along one beam: free up to the end cell, occupied on a hit.
+   */
+  void IntegrateBeam(int startX, int startY, int endX, int endY, bool hit);
+  /**
+   * @brief Write one in-bounds cell's code.
+   */
+  void SetCode(int x, int y, std::uint8_t code);
+  /**
+   * @brief Check whether a coordinate is inside map bounds.
+   */
+  bool InBounds(int x, int y) const;
+
+  int width_ = 0;
+  int height_ = 0;
+  std::size_t wordsPerRow_ = 0;
+  std::vector<std::uint64_t> words_;
+};
+
+}  // namespace slam::core
@@ -0,0 +1,226 @@
+/**
+ * @file ParticleFilterSlam.cpp
+ * @brief Rao-Blackwellized particle filter SLAM implementation.
+ */
+
+#include "core/ParticleFilterSlam.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "core/OccupancyCell.h"
+#include "core/ScanMatcher.h"
+
+namespace slam::core {
+
+/**
+ * @brief Construct a particle filter.
+ * @param width Map width in cells.
+ * @param height Map height in cells.
+ * @param options Filter parameters.
+ * @param start Initial pose.
+ */
+ParticleFilterSlam::ParticleFilterSlam(int width, int height, const ParticleFilterOptions& options, const RobotPose& start)
+    : options_(options), rng_(options.seed) {
+  if (options.particleCount <= 0 || options.beamStride <= 0) {
+    throw std::invalid_argument("ParticleFilterSlam particle count and beam stride must be positive");
+  }
+  if (options.translationNoise < 0.0 || options.headingNoise < 0.0 || options.turnNoise < 0.0) {
+    throw std::invalid_argument("ParticleFilterSlam noise levels must be non-negative");
+  }
+  if (!(options.hitSigma > 0.0) || !(options.missLikelihood > 0.0) || !(options.resampleThreshold >= 0.0) ||
+      options.resampleThreshold > 1.0) {
+    throw std::invalid_argument("ParticleFilterSlam needs a positive sigma and miss likelihood and a threshold in [0, 1]");
+  }
+  for (int squared = 0; squared < 3; ++squared) {
+    const double hit = std::exp(-static_cast<double>(squared) / (2.0 * options.hitSigma * options.hitSigma));
+    endpointLog_[static_cast<std::size_t>(squared)] = std::log(std::max(hit, options.missLikelihood));
+  }
+  endpointLog_[3] = std::log(options.missLikelihood);
+  const CowOccupancyGridMap empty(width, height, options.mode, options.logOdds);
+  particles_.assign(static_cast<std::size_t>(options.particleCount), Particle{start, 0.0, empty});
+  weights_.resize(particles_.size());
+  Reset(start);
+}
+
+/**
+ * @brief Put every particle back at a pose with an unknown map.
+ * @param start Pose to restart from.
+ */
+void ParticleFilterSlam::Reset(const RobotPose& start) {
+  for (Particle& particle : particles_) {
+    particle.pose = start;
+    particle.logWeight = 0.0;
+    particle.map.Reset();
+  }
+  odometry_ = start;
+  best_ = 0;
+  effectiveSampleSize_ = static_cast<double>(particles_.size());
+  resampleCount_ = 0;
+  rng_.seed(options_.seed);
+}
+
+/**
+ * @brief Update serially.
+ * @param odometry Odometry pose.
+ * @param scan Scan at the true pose.
+ * @return Best particle pose.
+ */
+const RobotPose& ParticleFilterSlam::Update(const RobotPose& odometry, const ScanBuffer& scan) {
+  return UpdateWith(odometry, scan, [](std::size_t count, auto&& fn) {
+    for (std::size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+  });
+}
+
+/**
+ * @brief Update with particles split across a worker pool.
+ * @param odometry Odometry pose.
+ * @param scan Scan at the true pose.
+ * @param pool Worker pool that weights and integrates the particles.
+ * @return Best particle pose.
+ */
+const RobotPose& ParticleFilterSlam::Update(const RobotPose& odometry, const ScanBuffer& scan, WorkerPool& pool) {
+  return UpdateWith(odometry, scan, [&pool](std::size_t count, auto&& fn) { pool.ParallelFor(count, fn); });
+}
+
+/**
+ * @brief Sum map memory over the particles.
+ * @return Bytes of distinct tiles plus the particles' tile tables.
+ */
+double ParticleFilterSlam::MapBytes() const {
+  double bytes = 0.0;
+  for (const Particle& particle : particles_) {
+    bytes += particle.map.SharedCellBytes() + static_cast<double>(particle.map.TableBytes());
+  }
+  return bytes;
+}
+
+/**
+ * @brief Move, weight, resample, and integrate.
+ * @param odometry Odometry pose.
+ * @param scan Scan at the true pose.
+ * @param forEach Runs a callable over particle indices, serially or on a pool.
+ * @return Best particle pose.
+ */
+template <typename ForEach>
+const RobotPose& ParticleFilterSlam::UpdateWith(const RobotPose& odometry, const ScanBuffer& scan, ForEach&& forEach) {
+  const RobotPose motion = RelativePose(odometry_, odometry);
+  odometry_ = odometry;
+  samples_.resize(scan.Size());
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    samples_[i] = scan.Sample(i);
+  }
+
+  if (motion.x != 0.0 || motion.y != 0.0 || motion.theta != 0.0) {
+    const double distance = std::hypot(motion.x, motion.y);
+    const double translationSigma = options_.translationNoise * distance;
+    const double headingSigma = options_.headingNoise * distance + options_.turnNoise * std::abs(motion.theta);
+    std::normal_distribution<double> unit(0.0, 1.0);
+    for (Particle& particle : particles_) {
+      const RobotPose noisy{.x = motion.x + translationSigma * unit(rng_),
+                            .y = motion.y + translationSigma * unit(rng_),
+                            .theta = motion.theta + headingSigma * unit(rng_)};
+      particle.pose = ComposePose(particle.pose, noisy);
+    }
+    points_.Assign(scan);
+    forEach(particles_.size(), [this](std::size_t i) { particles_[i].logWeight += LogLikelihood(particles_[i]); });
+    WeighAndResample();
+  }
+
+  forEach(particles_.size(), [this](std::size_t i) { particles_[i].map.IntegrateScan(particles_[i].pose, samples_); });
+  return Estimate();
+}
+
+/**
+ * @brief Score a particle's scan endpoints against its own map.
+ * @param particle Particle to score.
+ * @return Sum of endpoint log-likelihoods.
+ * @note An endpoint scores by the nearest occupied cell among its cell, the 4 edge
+ * neighbours, and the 4 corner neighbours, checked in that order; cells are snapped like
+ * the map's own beam endpoints.
+ */
+double ParticleFilterSlam::LogLikelihood(const Particle& particle) const {
+  const CowOccupancyGridMap& map = particle.map;
+  const auto occupied = [&map](int x, int y) { return map.ClassifiedValueAt(x, y) == kOccupied; };
+  const double c = std::cos(particle.pose.theta);
+  const double s = std::sin(particle.pose.theta);
+  double logLikelihood = 0.0;
+  for (std::size_t i = 0; i < points_.Size(); i += static_cast<std::size_t>(options_.beamStride)) {
+    const double px = points_.X()[i];
+    const double py = points_.Y()[i];
+    const int x = static_cast<int>(particle.pose.x + c * px - s * py);
+    const int y = static_cast<int>(particle.pose.y + s * px + c * py);
+    std::size_t squared = 3;
+    if (occupied(x, y)) {
+      squared = 0;
+    } else if (occupied(x - 1, y) || occupied(x + 1, y) || occupied(x, y - 1) || occupied(x, y + 1)) {
+      squared = 1;
+    } else if (occupied(x - 1, y - 1) || occupied(x + 1, y - 1) || occupied(x - 1, y + 1) || occupied(x + 1, y + 1)) {
+      squared = 2;
+    }
+    logLikelihood += endpointLog_[squared];
+  }
+  return logLikelihood;
+}
+
+/**
+ * @brief Normalize weights and resample by low-variance sampling when they degenerate.
+ * @note Systematic resampling gives every particle with weight w between floor(N w) and
+ * ceil(N w) copies, so the best particle always survives and stays the estimate.
+ */
+void ParticleFilterSlam::WeighAndResample() {
+  const std::size_t count = particles_.size();
+  best_ = 0;
+  for (std::size_t i = 1; i < count; ++i) {
+    if (particles_[i].logWeight > particles_[best_].logWeight) {
+      best_ = i;
+    }
+  }
+  const double largest = particles_[best_].logWeight;
+  double total = 0.0;
+  for (std::size_t i = 0; i < count; ++i) {
+    weights_[i] = std::exp(particles_[i].logWeight - largest);
+    total += weights_[i];
+  }
+  double squares = 0.0;
+  for (double& weight : weights_) {
+    weight /= total;
+    squares += weight * weight;
+  }
+  effectiveSampleSize_ = 1.0 / squares;
+  if (effectiveSampleSize_ >= options_.resampleThreshold * static_cast<double>(count)) {
+    return;
+  }
+
+  const double step = 1.0 / static_cast<double>(count);
+  std::uniform_real_distribution<double> offset(0.0, step);
+  const double start = offset(rng_);
+  resampled_.clear();
+  std::size_t parent = 0;
+  double cumulative = weights_[0];
+  std::size_t newBest = 0;
+  bool bestPlaced = false;
+  for (std::size_t m = 0; m < count; ++m) {
+    const double target = start + static_cast<double>(m) * step;
+    while (target > cumulative && parent + 1 < count) {
+      ++parent;
+      cumulative += weights_[parent];
+    }
+    if (parent == best_ && !bestPlaced) {
+      newBest = m;
+      bestPlaced = true;
+    }
+    resampled_.push_back(particles_[parent]);
+    resampled_.back().logWeight = 0.0;
+  }
+  particles_.swap(resampled_);
+  // Release the old generation's tile references now rather than holding them until the next resampling.
+  resampled_.clear();
+  best_ = newBest;
+  ++resampleCount_;
+}
+
+}  // namespace slam::core
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "core/CowOccupancyGridMap.h"
+#include "core/LikelihoodField.h"
+#include "core/ScanBuffer.h"
+#include "core/Types.h"
+#include "core/WorkerPool.h"
+
+/**
+ * @file ParticleFilterSlam.h
+ * @brief Rao-Blackwellized particle filter SLAM where every particle carries its own map.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Parameters of the particle filter.
+ */
+struct ParticleFilterOptions {
+  /// Number of particles, each with a pose hypothesis and its own map.
+  int particleCount = 30;
+  /// Standard deviation of sampled translation noise per grid unit travelled.
+  double translationNoise = 0.1;
+  /// Standard deviation of sampled heading noise per grid unit travelled, in radians.
+  double headingNoise = 0.02;
+  /// Standard deviation of sampled heading noise per radian turned.
+  double turnNoise = 0.1;
+  /// Standard deviation of an endpoint's likelihood around the nearest occupied cell, in cells.
+  double hitSigma = 0.8;
+  /// Likelihood of an endpoint with no occupied cell in its 3x3 neighbourhood.
+  double missLikelihood = 0.1;
+  /// Weight every beamStride-th hit beam; thins out correlated neighbouring beams.
+  int beamStride = 2;
+  /// Resample when the effective sample size drops below this fraction of the particle count.
+  double resampleThreshold = 0.5;
+  /// Cell update rule of the particle maps.
+  MapUpdateMode mode = MapUpdateMode::kLogOdds;
+  /// Log-odds parameters for MapUpdateMode::kLogOdds.
+  LogOddsParams logOdds{};
+  /// Seed of the motion-noise and resampling generator.
+  std::uint32_t seed = 1U;
+};
+
+/**
+ * @brief One pose hypothesis with the map built along its trajectory.
+ */
+struct Particle {
+  RobotPose pose{};
+  /// Log of the importance weight accumulated since the last resampling.
+  double logWeight = 0.0;
+  CowOccupancyGridMap map;
+};
+
+/**
+ * @brief FastSLAM-style SLAM: particles sample the motion, are weighted by their own map, and resample.
+ * @note Each update moves every particle by the odometry increment plus sampled noise,
+ * weights it by how well the scan's hit endpoints land on occupied cells of that particle's
+ * map, resamples with low-variance sampling once the weights degenerate, and integrates the
+ * scan into every particle's map at its pose. Maps are CowOccupancyGridMap, so a resampled
+ * particle shares all tiles with its parent and only duplicates the tiles the next scans
+ * change; resampling costs O(particles x tiles) pointer copies instead of O(particles x cells).
+ */
+class ParticleFilterSlam {
+ public:
+  /**
+   * @brief Construct a filter with every particle at the start pose and an unknown map.
+   * @param width Map width in cells.
+   * @param height Map height in cells.
+   * @param options Particle count, noise, and weighting parameters.
+   * @param start Initial pose; odometry is measured from here.
+   * @throws std::invalid_argument on a non-positive particle count, beam stride, sigma, or miss
+   * likelihood, negative noise, a resample threshold outside [0, 1], or invalid map parameters.
+   */
+  ParticleFilterSlam(int width, int height, const ParticleFilterOptions& options, const RobotPose& start);
+
+  /**
+   * @brief Restart at a known pose with unknown maps.
+   */
+  void Reset(const RobotPose& start);
+  /**
+   * @brief Advance by one odometry reading and its scan.
+   * @param odometry Pose reported by odometry; only its change since the last update is used.
+   * @param scan Scan taken at the true pose; only distances, angles, and hits are read.
+   * @return Pose of the highest-weighted particle.
+   * @note Particles are only moved, weighted, and resampled when the odometry changed; the
+   * scan is integrated into every map either way.
+   */
+  const RobotPose& Update(const RobotPose& odometry, const ScanBuffer& scan);
+  /**
+   * @brief Advance by one odometry reading, weighting and integrating particles across a worker pool.
+   * @note Noise is sampled on the calling thread, so results match the serial update.
+   */
+  const RobotPose& Update(const RobotPose& odometry, const ScanBuffer& scan, WorkerPool& pool);
+
+  /// @return Pose of the highest-weighted particle.
+  const RobotPose& Estimate() const { return particles_[best_].pose; }
+  /// @return Highest-weighted particle, whose map is the current map estimate.
+  const Particle& Best() const { return particles_[best_]; }
+  /// @return Every particle.
+  std::span<const Particle> Particles() const { return particles_; }
+  /// @return Effective sample size of the last weighting, before any resampling.
+  double EffectiveSampleSize() const { return effectiveSampleSize_; }
+  /// @return Resampling steps since construction or Reset().
+  std::size_t ResampleCount() const { return resampleCount_; }
+  /**
+   * @brief Map memory of all particles: shared tiles counted once plus every tile table.
+   */
+  double MapBytes() const;
+  /// @return Filter parameters.
+  const ParticleFilterOptions& Options() const { return options_; }
+
+ private:
+  /**
+   * @brief Shared body of both Update overloads; forEach(count, fn) runs fn over particle indices.
+   */
+  template <typename ForEach>
+  const RobotPose& UpdateWith(const RobotPose& odometry, const ScanBuffer& scan, ForEach&& forEach);
+  /**
+   * @brief Log-likelihood of the scan's hit endpoints at a particle's pose in its map.
+   */
+  double LogLikelihood(const Particle& particle) const;
+  /**
+   * @brief Normalize the weights, record the effective sample size, and resample if it is low.
+   */
+  void WeighAndResample();
+
+  ParticleFilterOptions options_;
+  std::vector<Particle> particles_;
+  std::vector<Particle> resampled_;
+  std::vector<double> weights_;
+  std::vector<ScanSample> samples_;
+  ScanPoints points_;
+  /// Log-likelihood of an endpoint at squared distance 0, 1, and 2 from an occupied cell, then of a miss.
+  std::array<double, 4> endpointLog_{};
+  RobotPose odometry_{};
+  std::size_t best_ = 0;
+  double effectiveSampleSize_ = 0.0;
+  std::size_t resampleCount_ = 0;
+  std::mt19937 rng_;
+};
+
+}  // namespace slam::core
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @file ScanBatchBuffer.h
+ * @brief Reusable storage for scans of many poses, laid out pose-major.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Scans of a whole pose batch in contiguous pose-major arrays.
+ * @note Pose p's beams occupy [p * BeamCount(), (p + 1) * BeamCount()) of each field, and
+ * its hit flags start on a fresh 64-bit word, so poses can be filled from different
+ * threads. Resizing never releases capacity, so reusing one buffer per frame is
+ * allocation-free once the largest batch has been seen.
+ */
+class ScanBatchBuffer {
+ public:
+  /**
+   * @brief Set the batch shape, allocating only when capacity must grow.
+   * @param poseCount Number of poses.
+   * @param beamCount Beams per pose.
+   */
+  void Resize(std::size_t poseCount, std::size_t beamCount) {
+    poseCount_ = poseCount;
+    beamCount_ = beamCount;
+    hitWordsPerPose_ = (beamCount + 63U) / 64U;
+    const std::size_t total = poseCount * beamCount;
+    distances_.resize(total);
+    endX_.resize(total);
+    endY_.resize(total);
+    hitWords_.assign(poseCount * hitWordsPerPose_, 0U);
+    castOrder_.resize(poseCount);
+  }
+
+  /**
+   * @brief Store one beam of one pose.
+   * @param pose Pose index in the batch.
+   * @param beam Beam index.
+   * @param distance Measured distance in grid units.
+   * @param hit True when the beam terminated on an obstacle.
+   * @param endX Endpoint X in grid units.
+   * @param endY Endpoint Y in grid units.
+   */
+  void Store(std::size_t pose, std::size_t beam, double distance, bool hit, double endX, double endY) {
+    const std::size_t index = pose * beamCount_ + beam;
+    distances_[index] = distance;
+    endX_[index] = endX;
+    endY_[index] = endY;
+    const std::uint64_t mask = std::uint64_t{1} << (beam & 63U);
+    std::uint64_t& word = hitWords_[pose * hitWordsPerPose_ + (beam >> 6U)];
+    word = hit ? (word | mask) : (word & ~mask);
+  }
+
+  /// @return Number of poses in the batch.
+  std::size_t PoseCount() const { return poseCount_; }
+  /// @return Beams per pose.
+  std::size_t BeamCount() const { return beamCount_; }
+  /// @return Distances of one pose's beams.
+  std::span<const double> Distances(std::size_t pose) const { return Row(distances_, pose); }
+  /// @return World-space endpoint X coordinates of one pose's beams.
+  std::span<const double> EndX(std::size_t pose) const { return Row(endX_, pose); }
+  /// @return World-space endpoint Y coordinates of one pose's beams.
+  std::span<const double> EndY(std::size_t pose) const { return Row(endY_, pose); }
+  /// @return True when beam of pose terminated on an obstacle.
+  bool Hit(std::size_t pose, std::size_t beam) const {
+    return ((hitWords_[pose * hitWordsPerPose_ + (beam >> 6U)] >> (beam & 63U)) & 1U) != 0U;
+  }
+  /// @return Number of one pose's beams that terminated on an obstacle.
+  std::size_t HitCount(std::size_t pose) const {
+    std::size_t count = 0;
+    for (std::size_t w = 0; w < hitWordsPerPose_; ++w) {
+      count += static_cast<std::size_t>(std::popcount(hitWords_[pose * hitWordsPerPose_ + w]));
+    }
+    return count;
+  }
+
+  /// @return Scratch cast order, one entry per pose, owned here so batches do not allocate.
+  std::span<std::uint64_t> CastOrder() { return castOrder_; }
+
+ private:
+  std::span<const double> Row(const std::vector<double>& field, std::size_t pose) const {
+    return std::span<const double>(field).subspan(pose * beamCount_, beamCount_);
+  }
+
+  std::size_t poseCount_ = 0;
+  std::size_t beamCount_ = 0;
+  std::size_t hitWordsPerPose_ = 0;
+  std::vector<double> distances_;
+  std::vector<double> endX_;
+  std::vector<double> endY_;
+  std::vector<std::uint64_t> hitWords_;
+  std::vector<std::uint64_t> castOrder_;
+};
+
+}  // namespace slam::core
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "core/Types.h"
+
+/**
+ * @file ScanBuffer.h
+ * @brief Reusable caller-owned struct-of-arrays storage for lidar scans.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Scan storage reused across frames, laid out as parallel arrays.
+ * @note Angles, distances, and world-space endpoints are contiguous per field and hit
+ * flags are packed 64 per word, so per-beam consumer loops stream only what they read.
+ * Resizing never releases capacity, so a buffer sized once for the lidar beam count
+ * makes every later scan allocation-free. The buffer also caches the absolute beam
+ * directions for the last scanned heading, so scans that only translate reuse them.
+ */
+class ScanBuffer {
+ public:
+  ScanBuffer() = default;
+  /**
+   * @brief Construct a buffer sized for a beam count.
+   * @param beamCount Number of beams per scan.
+   */
+  explicit ScanBuffer(int beamCount) { Resize(beamCount); }
+
+  /**
+   * @brief Set the beam count, allocating only when capacity must grow.
+   * @param beamCount Number of beams per scan.
+   */
+  void Resize(int beamCount) {
+    const std::size_t count = static_cast<std::size_t>(beamCount > 0 ? beamCount : 0);
+    if (count != distances_.size()) {
+      directionsValid_ = false;
+    }
+    relativeAngles_.resize(count);
+    distances_.resize(count);
+    endX_.resize(count);
+    endY_.resize(count);
+    dirX_.resize(count);
+    dirY_.resize(count);
+    hitWords_.resize((count + 63U) / 64U);
+    if ((count & 63U) != 0U) {
+      // Drop stale flags past the new end so HitCount stays exact after shrinking.
+      hitWords_.back() &= (std::uint64_t{1} << (count & 63U)) - 1U;
+    }
+  }
+
+  /**
+   * @brief Store one beam measurement and derive its world-space endpoint.
+   * @param index Beam index.
+   * @param pose Robot pose at scan time.
+   * @param sample Beam measurement relative to the pose.
+   */
+  void Store(std::size_t index, const RobotPose& pose, const ScanSample& sample) {
+    const double angle = pose.theta + sample.relativeAngle;
+    Store(index, sample, pose.x + std::cos(angle) * sample.distance, pose.y + std::sin(angle) * sample.distance);
+  }
+  /**
+   * @brief Store one beam measurement with a precomputed world-space endpoint.
+   * @param index Beam index.
+   * @param sample Beam measurement relative to the pose.
+   * @param endX Endpoint X in grid units.
+   * @param endY Endpoint Y in grid units.
+   */
+  void Store(std::size_t index, const ScanSample& sample, double endX, double endY) {
+    relativeAngles_[index] = sample.relativeAngle;
+    distances_[index] = sample.distance;
+    endX_[index] = endX;
+    endY_[index] = endY;
+    const std::uint64_t mask = std::uint64_t{1} << (index & 63U);
+    std::uint64_t& word = hitWords_[index >> 6U];
+    word = sample.hit ? (word | mask) : (word & ~mask);
+  }
+
+  /**
+   * @brief Check whether the cached beam directions were computed for a heading.
+   * @param heading Robot heading in radians.
+   * @return True when Directions*() hold the beams for exactly this heading.
+   */
+  bool HasDirectionsFor(double heading) const { return directionsValid_ && directionHeading_ == heading; }
+  /**
+   * @brief Store one absolute beam direction in the cache.
+   * @param index Beam index.
+   * @param dirX Direction X component.
+   * @param dirY Direction Y component.
+   */
+  void SetDirection(std::size_t index, double dirX, double dirY) {
+    dirX_[index] = dirX;
+    dirY_[index] = dirY;
+  }
+  /**
+   * @brief Mark every cached direction as belonging to a heading.
+   * @param heading Robot heading in radians the directions were computed for.
+   */
+  void MarkDirectionsFor(double heading) {
+    directionHeading_ = heading;
+    directionsValid_ = true;
+  }
+
+  /// @return Number of beams stored.
+  std::size_t Size() const { return distances_.size(); }
+  /// @return Beam angles relative to the robot heading in radians.
+  std::span<const double> RelativeAngles() const { return relativeAngles_; }
+  /// @return Measured distances in grid units.
+  std::span<const double> Distances() const { return distances_; }
+  /// @return World-space endpoint X coordinates in grid units.
+  std::span<const double> EndX() const { return endX_; }
+  /// @return World-space endpoint Y coordinates in grid units.
+  std::span<const double> EndY() const { return endY_; }
+  /// @return Cached absolute beam direction X components.
+  std::span<const double> DirectionsX() const { return dirX_; }
+  /// @return Cached absolute beam direction Y components.
+  std::span<const double> DirectionsY() const { return dirY_; }
+  /// @return Packed hit flags, bit (i % 64) of word (i / 64) for beam i.
+  std::span<const std::uint64_t> HitWords() const { return hitWords_; }
+  /// @return True when beam index terminated on an obstacle.
+  bool Hit(std::size_t index) const { return ((hitWords_[index >> 6U] >> (index & 63U)) & 1U) != 0U; }
+  /// @return Number of beams that terminated on an obstacle.
+  std::size_t HitCount() const {
+    std::size_t count = 0;
+    for (const std::uint64_t word : hitWords_) {
+      count += static_cast<std::size_t>(std::popcount(word));
+    }
+    return count;
+  }
+  /// @return Beam index as an array-of-structs sample.
+  ScanSample Sample(std::size_t index) const {
+    return ScanSample{.relativeAngle = relativeAngles_[index], .distance = distances_[index], .hit = Hit(index)};
+  }
+
+ private:
+  std::vector<double> relativeAngles_;
+  std::vector<double> distances_;
+  std::vector<double> endX_;
+  std::vector<double> endY_;
+  std::vector<double> dirX_;
+  std::vector<double> dirY_;
+  std::vector<std::uint64_t> hitWords_;
+  double directionHeading_ = std::numeric_limits<double>::quiet_NaN();
+  bool directionsValid_ = false;
+};
+
+}  // namespace slam::core
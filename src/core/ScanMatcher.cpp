@@ -0,0 +1,380 @@
+/**
+ * @file ScanMatcher.cpp
+ * @brief Branch-and-bound correlative scan matching and pose tracking implementation.
+ */
+
+#include "core/ScanMatcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+
+namespace slam::core {
+namespace {
+
+/**
+ * @brief Wrap an angle to [-pi, pi].
+ */
+double NormalizeAngle(double angle) {
+  return std::remainder(angle, 2.0 * std::numbers::pi);
+}
+
+}  // namespace
+
+/**
+ * @brief Compose a pose with a robot-frame motion.
+ */
+RobotPose ComposePose(const RobotPose& pose, const RobotPose& motion) {
+  const double c = std::cos(pose.theta);
+  const double s = std::sin(pose.theta);
+  return RobotPose{.x = pose.x + c * motion.x - s * motion.y,
+                   .y = pose.y + s * motion.x + c * motion.y,
+                   .theta = NormalizeAngle(pose.theta + motion.theta)};
+}
+
+/**
+ * @brief Express the motion between two poses in the first pose's frame.
+ */
+RobotPose RelativePose(const RobotPose& from, const RobotPose& to) {
+  const double c = std::cos(from.theta);
+  const double s = std::sin(from.theta);
+  const double dx = to.x - from.x;
+  const double dy = to.y - from.y;
+  return RobotPose{.x = c * dx + s * dy, .y = -s * dx + c * dy, .theta = NormalizeAngle(to.theta - from.theta)};
+}
+
+/**
+ * @brief Construct a correlative scan matcher.
+ * @param options Search window.
+ */
+CorrelativeScanMatcher::CorrelativeScanMatcher(const ScanMatcherOptions& options) : options_(options) {
+  if (options.linearWindow < 0 || options.angularWindow < 0.0 || options.angularStep < 0.0) {
+    throw std::invalid_argument("CorrelativeScanMatcher window and step must be non-negative");
+  }
+}
+
+/**
+ * @brief Branch-and-bound search over rotations and cell offsets.
+ * @param map Map with a maintained pyramid.
+ * @param predicted Window center.
+ * @param scan Scan to place.
+ * @return Best candidate.
+ */
+ScanMatchResult CorrelativeScanMatcher::Match(const OccupancyGridMap& map, const RobotPose& predicted,
+                                              const ScanBuffer& scan) {
+  if (!map.MaintainsPyramid()) {
+    throw std::invalid_argument("CorrelativeScanMatcher needs a map that maintains its pyramid");
+  }
+  const int zeroRotation = PrepareRotations(predicted, scan);
+  ScanMatchResult result{.pose = predicted, .hitCount = static_cast<int>(pointX_.size())};
+  if (pointX_.empty()) {
+    return result;
+  }
+  const int window = options_.linearWindow;
+  Candidate best{.rotation = zeroRotation, .bound = Bound(map, zeroRotation, 0, 0, 0)};
+  result.predictedScore = best.bound;
+  std::size_t visited = 1;
+
+  // The coarsest level whose nodes cover the whole window, or the pyramid's top.
+  int topLevel = 0;
+  while ((1 << topLevel) < 2 * window + 1 && topLevel + 1 < map.PyramidLevels()) {
+    ++topLevel;
+  }
+  const int topStep = 1 << topLevel;
+  stack_.clear();
+  for (int rotation = 0; rotation < static_cast<int>(rotations_.size()); ++rotation) {
+    for (int y = -window; y <= window; y += topStep) {
+      for (int x = -window; x <= window; x += topStep) {
+        const int bound = Bound(map, rotation, x, y, topLevel);
+        ++visited;
+        if (bound > best.bound) {
+          stack_.push_back(Candidate{.rotation = rotation, .x = x, .y = y, .level = topLevel, .bound = bound});
+        }
+      }
+    }
+  }
+  const auto byBound = [](const Candidate& a, const Candidate& b) { return a.bound < b.bound; };
+  std::stable_sort(stack_.begin(), stack_.end(), byBound);
+
+  // Depth-first, highest bound on top of the stack; level-0 bounds are exact scores.
+  while (!stack_.empty()) {
+    const Candidate node = stack_.back();
+    stack_.pop_back();
+    if (node.bound <= best.bound) {
+      continue;
+    }
+    if (node.level == 0) {
+      best = node;
+      continue;
+    }
+    const int half = 1 << (node.level - 1);
+    children_.clear();
+    for (int dy = 0; dy < 2 * half; dy += half) {
+      for (int dx = 0; dx < 2 * half; dx += half) {
+        const int x = node.x + dx;
+        const int y = node.y + dy;
+        if (x > window || y > window) {
+          continue;
+        }
+        const int bound = Bound(map, node.rotation, x, y, node.level - 1);
+        ++visited;
+        if (bound > best.bound) {
+          children_.push_back(Candidate{.rotation = node.rotation, .x = x, .y = y, .level = node.level - 1, .bound = bound});
+        }
+      }
+    }
+    std::stable_sort(children_.begin(), children_.end(), byBound);
+    stack_.insert(stack_.end(), children_.begin(), children_.end());
+  }
+
+  result.pose = RefinedPose(map, predicted, best);
+  result.score = best.bound;
+  result.nodesVisited = visited;
+  return result;
+}
+
+/**
+ * @brief Score every rotation and cell offset of the window.
+ * @param map Map to match against.
+ * @param predicted Window center.
+ * @param scan Scan to place.
+ * @return Best candidate.
+ */
+ScanMatchResult CorrelativeScanMatcher::MatchExhaustive(const OccupancyGridMap& map, const RobotPose& predicted,
+                                                        const ScanBuffer& scan) {
+  const int zeroRotation = PrepareRotations(predicted, scan);
+  ScanMatchResult result{.pose = predicted, .hitCount = static_cast<int>(pointX_.size())};
+  if (pointX_.empty()) {
+    return result;
+  }
+  const int window = options_.linearWindow;
+  Candidate best{.rotation = zeroRotation, .bound = Bound(map, zeroRotation, 0, 0, 0)};
+  result.predictedScore = best.bound;
+  for (int rotation = 0; rotation < static_cast<int>(rotations_.size()); ++rotation) {
+    for (int y = -window; y <= window; ++y) {
+      for (int x = -window; x <= window; ++x) {
+        const int score = Bound(map, rotation, x, y, 0);
+        if (score > best.bound) {
+          best = Candidate{.rotation = rotation, .x = x, .y = y, .bound = score};
+        }
+      }
+    }
+  }
+  result.pose = RefinedPose(map, predicted, best);
+  result.score = best.bound;
+  result.nodesVisited = rotations_.size() * static_cast<std::size_t>(2 * window + 1) *
+                        static_cast<std::size_t>(2 * window + 1);
+  return result;
+}
+
+/**
+ * @brief Rotate the hit points once per rotation and snap them to cells at the prediction.
+ * @param predicted Window center.
+ * @param scan Scan to place.
+ * @return Index of the zero rotation in rotations_.
+ */
+int CorrelativeScanMatcher::PrepareRotations(const RobotPose& predicted, const ScanBuffer& scan) {
+  pointX_.clear();
+  pointY_.clear();
+  double farthest = 0.0;
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    if (!scan.Hit(i)) {
+      continue;
+    }
+    const double distance = scan.Distances()[i];
+    const double angle = scan.RelativeAngles()[i];
+    pointX_.push_back(std::cos(angle) * distance);
+    pointY_.push_back(std::sin(angle) * distance);
+    farthest = std::max(farthest, distance);
+  }
+
+  // A step of acos(1 - 1 / (2 r^2)) moves a point at range r by one cell.
+  double step = options_.angularStep;
+  if (step == 0.0) {
+    step = (farthest > 1.0) ? std::acos(1.0 - 1.0 / (2.0 * farthest * farthest)) : options_.angularWindow;
+  }
+  const int steps = (step > 0.0) ? static_cast<int>(std::floor(options_.angularWindow / step)) : 0;
+  rotations_.clear();
+  for (int k = -steps; k <= steps; ++k) {
+    rotations_.push_back(static_cast<double>(k) * step);
+  }
+
+  const std::size_t hits = pointX_.size();
+  cellX_.resize(rotations_.size() * hits);
+  cellY_.resize(rotations_.size() * hits);
+  for (std::size_t r = 0; r < rotations_.size(); ++r) {
+    const double c = std::cos(predicted.theta + rotations_[r]);
+    const double s = std::sin(predicted.theta + rotations_[r]);
+    int* const xs = cellX_.data() + r * hits;
+    int* const ys = cellY_.data() + r * hits;
+    for (std::size_t i = 0; i < hits; ++i) {
+      xs[i] = static_cast<int>(std::floor(predicted.x + c * pointX_[i] - s * pointY_[i]));
+      ys[i] = static_cast<int>(std::floor(predicted.y + s * pointX_[i] + c * pointY_[i]));
+    }
+  }
+  return steps;
+}
+
+/**
+ * @brief Upper bound on the score of every offset in a node, exact at level 0.
+ * @param map Map with a maintained pyramid for level > 0.
+ * @param rotation Rotation index.
+ * @param x Smallest X offset of the node.
+ * @param y Smallest Y offset of the node.
+ * @param level Node level; the node spans 2^level offsets per axis.
+ */
+int CorrelativeScanMatcher::Bound(const OccupancyGridMap& map, int rotation, int x, int y, int level) const {
+  const std::size_t hits = pointX_.size();
+  const int* const xs = cellX_.data() + static_cast<std::size_t>(rotation) * hits;
+  const int* const ys = cellY_.data() + static_cast<std::size_t>(rotation) * hits;
+  int bound = 0;
+  if (level == 0) {
+    for (std::size_t i = 0; i < hits; ++i) {
+      const int cellX = xs[i] + x;
+      const int cellY = ys[i] + y;
+      if (cellX >= 0 && cellY >= 0 && cellX < map.Width() && cellY < map.Height()) {
+        bound += Evidence(map, map.ValueAt(cellX, cellY));
+      }
+    }
+    return bound;
+  }
+
+  const MapPyramid& pyramid = map.Pyramid();
+  const int width = pyramid.LevelWidth(level);
+  const int height = pyramid.LevelHeight(level);
+  // Blocks outside the map hold no evidence.
+  const auto pooled = [&](int blockX, int blockY) {
+    return (blockX >= 0 && blockY >= 0 && blockX < width && blockY < height) ? pyramid.MaxAt(level, blockX, blockY)
+                                                                              : std::numeric_limits<std::int16_t>::min();
+  };
+  const int span = (1 << level) - 1;
+  for (std::size_t i = 0; i < hits; ++i) {
+    // Cells [first, first + 2^level) per axis straddle at most two aligned blocks.
+    const int firstX = xs[i] + x;
+    const int firstY = ys[i] + y;
+    const int blockX0 = firstX >> level;
+    const int blockY0 = firstY >> level;
+    const int blockX1 = (firstX + span) >> level;
+    const int blockY1 = (firstY + span) >> level;
+    std::int16_t largest = pooled(blockX0, blockY0);
+    if (blockX1 != blockX0) {
+      largest = std::max(largest, pooled(blockX1, blockY0));
+    }
+    if (blockY1 != blockY0) {
+      largest = std::max(largest, pooled(blockX0, blockY1));
+      if (blockX1 != blockX0) {
+        largest = std::max(largest, pooled(blockX1, blockY1));
+      }
+    }
+    bound += Evidence(map, largest);
+  }
+  return bound;
+}
+
+/**
+ * @brief Score of one hit landing on a cell with a raw value.
+ * @return 0 unless the value classifies as occupied; then 1 in overwrite mode and the
+ * log-odds value itself in log-odds mode, which never decreases with the value.
+ */
+int CorrelativeScanMatcher::Evidence(const OccupancyGridMap& map, std::int16_t value) {
+  if (map.UpdateMode() == MapUpdateMode::kOverwrite) {
+    return (value == kOccupied) ? 1 : 0;
+  }
+  return (value >= map.LogOdds().occupiedThreshold) ? static_cast<int>(value) : 0;
+}
+
+/**
+ * @brief Pose of the best candidate, moved toward the score peak between its neighbours.
+ * @param map Map the candidate was scored on.
+ * @param predicted Window center.
+ * @param best Best level-0 candidate.
+ * @return Candidate pose plus a fit offset of at most half a cell or half a rotation step per axis.
+ * @note Each axis fits a parabola through the scores one step below, at, and above the
+ * best candidate (six extra scores), which undoes most of the half-cell quantization a
+ * cell-stepped search leaves. Rotations at the window edge are not refined.
+ */
+RobotPose CorrelativeScanMatcher::RefinedPose(const OccupancyGridMap& map, const RobotPose& predicted,
+                                              const Candidate& best) const {
+  const auto peak = [center = static_cast<double>(best.bound)](int below, int above) {
+    const double curvature = static_cast<double>(below) - 2.0 * center + static_cast<double>(above);
+    return (curvature < 0.0) ? std::clamp(0.5 * static_cast<double>(below - above) / curvature, -0.5, 0.5) : 0.0;
+  };
+  const std::size_t rotation = static_cast<std::size_t>(best.rotation);
+  double theta = predicted.theta + rotations_[rotation];
+  if (rotation > 0 && rotation + 1 < rotations_.size()) {
+    const double step = rotations_[rotation + 1] - rotations_[rotation];
+    theta += step * peak(Bound(map, best.rotation - 1, best.x, best.y, 0), Bound(map, best.rotation + 1, best.x, best.y, 0));
+  }
+  return RobotPose{
+      .x = predicted.x + static_cast<double>(best.x) +
+           peak(Bound(map, best.rotation, best.x - 1, best.y, 0), Bound(map, best.rotation, best.x + 1, best.y, 0)),
+      .y = predicted.y + static_cast<double>(best.y) +
+           peak(Bound(map, best.rotation, best.x, best.y - 1, 0), Bound(map, best.rotation, best.x, best.y + 1, 0)),
+      .theta = NormalizeAngle(theta)};
+}
+
+/**
+ * @brief Construct a pose tracker.
+ * @param options Matcher window and odometry noise.
+ * @param start Initial pose.
+ */
+PoseTracker::PoseTracker(const PoseTrackerOptions& options, const RobotPose& start)
+    : options_(options), matcher_(options.matcher), noise_(options.seed) {
+  if (options.odometryNoise < 0.0 || options.headingNoise < 0.0) {
+    throw std::invalid_argument("PoseTracker noise levels must be non-negative");
+  }
+  Reset(start);
+}
+
+/**
+ * @brief Restart from a known pose.
+ * @param start Pose for both the estimate and the odometry reference.
+ */
+void PoseTracker::Reset(const RobotPose& start) {
+  odometry_ = start;
+  prediction_ = start;
+  estimate_ = start;
+  lastMatch_ = ScanMatchResult{.pose = start};
+}
+
+/**
+ * @brief Predict from the odometry increment, then match the scan around the prediction.
+ * @param map Map to match against.
+ * @param odometry Current odometry pose.
+ * @param scan Scan taken at the true pose.
+ * @return Updated estimate.
+ */
+const RobotPose& PoseTracker::Track(const OccupancyGridMap& map, const RobotPose& odometry, const ScanBuffer& scan) {
+  RobotPose motion = RelativePose(odometry_, odometry);
+  odometry_ = odometry;
+  // Noise only accompanies motion: standing wheels report no slip.
+  if (motion.x != 0.0 || motion.y != 0.0 || motion.theta != 0.0) {
+    if (options_.odometryNoise > 0.0) {
+      std::normal_distribution<double> translation(0.0, options_.odometryNoise);
+      motion.x += translation(noise_);
+      motion.y += translation(noise_);
+    }
+    if (options_.headingNoise > 0.0) {
+      std::normal_distribution<double> heading(0.0, options_.headingNoise);
+      motion.theta += heading(noise_);
+    }
+  }
+  prediction_ = ComposePose(estimate_, motion);
+
+  if (map.Stats().occupiedCells == 0) {
+    lastMatch_ = ScanMatchResult{.pose = prediction_};
+  } else {
+    lastMatch_ = matcher_.Match(map, prediction_, scan);
+  }
+  estimate_ = lastMatch_.pose;
+
+  corrected_.Resize(static_cast<int>(scan.Size()));
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    corrected_.Store(i, estimate_, scan.Sample(i));
+  }
+  return estimate_;
+}
+
+}  // namespace slam::core
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/Types.h"
+
+/**
+ * @file ScanMatcher.h
+ * @brief Correlative scan-to-map matching and odometry-plus-matching pose tracking.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Apply a robot-frame motion to a pose.
+ * @param pose Starting pose.
+ * @param motion Translation along and across the starting heading, and heading change.
+ * @return Pose after the motion.
+ */
+RobotPose ComposePose(const RobotPose& pose, const RobotPose& motion);
+/**
+ * @brief Robot-frame motion that takes one pose to another; the inverse of ComposePose.
+ * @param from Starting pose.
+ * @param to Final pose.
+ * @return Motion with ComposePose(from, motion) == to up to rounding.
+ */
+RobotPose RelativePose(const RobotPose& from, const RobotPose& to);
+
+/**
+ * @brief Search window of the correlative scan matcher.
+ */
+struct ScanMatcherOptions {
+  /// Translation search half-width in grid cells; candidates step one cell at a time.
+  int linearWindow = 4;
+  /// Rotation search half-width in radians.
+  double angularWindow = 0.2;
+  /// Rotation step in radians; 0 picks the step that moves the farthest hit by about one cell.
+  double angularStep = 0.0;
+};
+
+/**
+ * @brief Best pose found by one match.
+ */
+struct ScanMatchResult {
+  /// Matched pose: the best cell offset and rotation step from the prediction, refined by a peak fit.
+  RobotPose pose{};
+  /// Occupancy evidence of the cells the scan hits land on at the matched pose (see CorrelativeScanMatcher).
+  int score = 0;
+  /// Scan hits considered.
+  int hitCount = 0;
+  /// Score of the unshifted prediction; the match only moves for a strictly higher score.
+  int predictedScore = 0;
+  /// Candidates whose score or bound was evaluated.
+  std::size_t nodesVisited = 0;
+};
+
+/**
+ * @brief Exhaustive-quality (x, y, theta) scan-to-map search with branch-and-bound pruning.
+ * @note The score of a pose sums the evidence of the occupied map cells its scan hits land
+ * on: one per hit in overwrite mode, and the cell's log-odds value in log-odds mode, so
+ * walls confirmed by many scans outweigh ones drawn by the last few. For every
+ * rotation the hit points are rotated once and snapped to cells, so a candidate translation
+ * is an integer offset added to each cell. Translations are searched coarse to fine: a node
+ * at level h covers 2^h x 2^h offsets, and its bound scores each hit by the largest value
+ * in its 2^h-wide window, read from the map's max pyramid; evidence never decreases with
+ * the raw value, so this bounds every offset below the node. A window that is not aligned
+ * to the pyramid's blocks straddles at most 2 x 2 of them, so each hit costs up to four
+ * lookups per node. Nodes are expanded best bound first and dropped once their bound cannot
+ * beat the best score so far, which starts at the prediction's own score. The result has
+ * the same score as scoring every candidate; its pose is then refined by a per-axis peak
+ * fit over the neighbouring candidates.
+ */
+class CorrelativeScanMatcher {
+ public:
+  /**
+   * @brief Construct a matcher with a search window.
+   * @param options Window half-widths and rotation step.
+   * @throws std::invalid_argument on a negative window or step.
+   */
+  explicit CorrelativeScanMatcher(const ScanMatcherOptions& options = {});
+
+  /**
+   * @brief Find the best-scoring pose in the window around a prediction.
+   * @param map Map to match against; must maintain its pyramid (SetMaintainPyramid(true)).
+   * @param predicted Window center, normally the odometry prediction.
+   * @param scan Scan taken at the unknown true pose; only distances, angles, and hits are read.
+   * @return Best pose and its score; the prediction itself when nothing scores higher.
+   * @throws std::invalid_argument when the map keeps no pyramid.
+   */
+  ScanMatchResult Match(const OccupancyGridMap& map, const RobotPose& predicted, const ScanBuffer& scan);
+  /**
+   * @brief Score every candidate of the window; the reference the pruned search must agree with.
+   * @param map Map to match against.
+   * @param predicted Window center.
+   * @param scan Scan taken at the unknown true pose.
+   * @return Best pose and its score; ties keep the prediction, then the first candidate found.
+   */
+  ScanMatchResult MatchExhaustive(const OccupancyGridMap& map, const RobotPose& predicted, const ScanBuffer& scan);
+
+  /// @return Search window.
+  const ScanMatcherOptions& Options() const { return options_; }
+
+ private:
+  /**
+   * @brief One translation node: offsets [x, x + 2^level) x [y, y + 2^level) of one rotation.
+   */
+  struct Candidate {
+    int rotation = 0;
+    int x = 0;
+    int y = 0;
+    int level = 0;
+    int bound = 0;
+  };
+
+  /**
+   * @brief Rotate and snap the scan's hit points for every rotation of the window.
+   * @return Index of the zero rotation.
+   */
+  int PrepareRotations(const RobotPose& predicted, const ScanBuffer& scan);
+  /**
+   * @brief Score each hit by the largest cell value in its 2^level-wide window from the offset.
+   * @note Level 0 is the exact score of the offset.
+   */
+  int Bound(const OccupancyGridMap& map, int rotation, int x, int y, int level) const;
+  /**
+   * @brief Score of one hit landing on a cell, monotone in the cell's raw value.
+   */
+  static int Evidence(const OccupancyGridMap& map, std::int16_t value);
+  /**
+   * @brief Build the matched pose of the best candidate, refined between grid steps.
+   */
+  RobotPose RefinedPose(const OccupancyGridMap& map, const RobotPose& predicted, const Candidate& best) const;
+
+  ScanMatcherOptions options_;
+  std::vector<double> pointX_;
+  std::vector<double> pointY_;
+  std::vector<double> rotations_;
+  /// Hit cells, rotation-major: rotation r owns [r * hits, (r + 1) * hits).
+  std::vector<int> cellX_;
+  std::vector<int> cellY_;
+  std::vector<Candidate> stack_;
+  std::vector<Candidate> children_;
+};
+
+/**
+ * @brief Parameters of odometry-plus-scan-matching pose tracking.
+ */
+struct PoseTrackerOptions {
+  /// Search window around each odometry prediction.
+  ScanMatcherOptions matcher{};
+  /// Standard deviation of simulated odometry translation noise per update, in grid units.
+  double odometryNoise = 0.0;
+  /// Standard deviation of simulated odometry heading noise per update, in radians.
+  double headingNoise = 0.0;
+  /// Seed of the odometry noise generator.
+  std::uint32_t seed = 1U;
+};
+
+/**
+ * @brief Tracks the robot pose by dead reckoning from odometry and correcting against the map.
+ * @note The simulator's odometry is exact, so each motion increment can be perturbed with
+ * Gaussian noise to model wheel slip. The corrected scan holds the input scan's beams with
+ * endpoints recomputed from the estimated pose, ready for OccupancyGridMap::IntegrateScan.
+ */
+class PoseTracker {
+ public:
+  /**
+   * @brief Construct a tracker.
+   * @param options Matcher window and odometry noise.
+   * @param start Initial pose; the estimate and the odometry both begin here.
+   * @throws std::invalid_argument on a negative noise level or an invalid matcher window.
+   */
+  PoseTracker(const PoseTrackerOptions& options, const RobotPose& start);
+
+  /**
+   * @brief Restart tracking at a known pose, e.g. after the map was reset.
+   */
+  void Reset(const RobotPose& start);
+  /**
+   * @brief Advance by one odometry reading and match its scan.
+   * @param map Map built from earlier estimates; must maintain its pyramid.
+   * @param odometry Pose reported by odometry; only its change since the last update is used.
+   * @param scan Scan taken at the true pose.
+   * @return Updated estimate.
+   * @note While the map holds no occupied cells there is nothing to match, and the
+   * prediction is kept.
+   */
+  const RobotPose& Track(const OccupancyGridMap& map, const RobotPose& odometry, const ScanBuffer& scan);
+
+  /// @return Current pose estimate.
+  const RobotPose& Estimate() const { return estimate_; }
+  /// @return Last odometry prediction, before matching.
+  const RobotPose& Prediction() const { return prediction_; }
+  /// @return Last match result.
+  const ScanMatchResult& LastMatch() const { return lastMatch_; }
+  /// @return Last tracked scan with endpoints at the estimated pose.
+  const ScanBuffer& CorrectedScan() const { return corrected_; }
+
+ private:
+  PoseTrackerOptions options_;
+  CorrelativeScanMatcher matcher_;
+  RobotPose odometry_{};
+  RobotPose prediction_{};
+  RobotPose estimate_{};
+  ScanMatchResult lastMatch_{};
+  ScanBuffer corrected_;
+  std::mt19937 noise_;
+};
+
+}  // namespace slam::core
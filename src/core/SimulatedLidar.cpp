@@ -1,23 +1,151 @@
 /**
  * @file SimulatedLidar.cpp
- * @brief Ray-march lidar simulation implementation.
+ * @brief Ray-march, batched ray-march, grid-traversal, and sphere-trace lidar simulation implementation.
  */
 
 #include "core/SimulatedLidar.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
+#include <tuple>
+
+#include "core/BatchedRayMarch.h"
 
 namespace slam::core {
+namespace {
+
+/**
+ * @brief Amanatides-Woo cell walker along one beam.
+ * @note Boundary distances are recomputed from the beam origin instead of accumulated,
+ * so reported distances stay exact regardless of how many cells were crossed.
+ */
+class CellWalker {
+ public:
+  CellWalker(const RobotPose& pose, double dirX, double dirY)
+      : originX_(pose.x),
+        originY_(pose.y),
+        stepX_((dirX > 0.0) ? 1 : ((dirX < 0.0) ? -1 : 0)),
+        stepY_((dirY > 0.0) ? 1 : ((dirY < 0.0) ? -1 : 0)),
+        invDirX_((stepX_ != 0) ? 1.0 / dirX : 0.0),
+        invDirY_((stepY_ != 0) ? 1.0 / dirY : 0.0),
+        dirX_(dirX),
+        dirY_(dirY) {
+    MoveTo(0.0);
+  }
+
+  /**
+   * @brief Reposition the walker on the cell containing the beam point at distance t.
+   */
+  void MoveTo(double t) {
+    cellX_ = static_cast<int>(std::floor(originX_ + dirX_ * t));
+    cellY_ = static_cast<int>(std::floor(originY_ + dirY_ * t));
+    tMaxX_ = NextBoundaryX();
+    tMaxY_ = NextBoundaryY();
+  }
+
+  /**
+   * @brief Step into the next cell crossed by the beam.
+   * @return Beam distance at which the new cell is entered.
+   */
+  double Step() {
+    if (tMaxX_ < tMaxY_) {
+      const double distance = tMaxX_;
+      cellX_ += stepX_;
+      tMaxX_ = NextBoundaryX();
+      return distance;
+    }
+    const double distance = tMaxY_;
+    cellY_ += stepY_;
+    tMaxY_ = NextBoundaryY();
+    return distance;
+  }
+
+  /**
+   * @brief Resolve the remaining beam with one word-level row query if it never leaves its row.
+   * @param world Ground-truth world grid.
+   * @param maxRange Maximum beam range.
+   * @param result Receives distance and hit flag when resolved.
+   * @return True when the beam stays in the current row for the whole range.
+   * @note Reports the same cells and distances Step() would, since entry distances use
+   * the same boundary formula.
+   */
+  bool TryResolveWithinRow(const WorldGrid& world, double maxRange, std::pair<double, bool>& result) const {
+    if (stepX_ == 0 || tMaxY_ <= maxRange) {
+      return false;
+    }
+    const auto entryDistance = [&](int cell) {
+      return (static_cast<double>(cell + (stepX_ > 0 ? 0 : 1)) - originX_) * invDirX_;
+    };
+    int lastCell = static_cast<int>(std::floor(originX_ + dirX_ * maxRange));
+    while (entryDistance(lastCell + stepX_) <= maxRange) {
+      lastCell += stepX_;
+    }
+    while (lastCell != cellX_ && entryDistance(lastCell) > maxRange) {
+      lastCell -= stepX_;
+    }
+    if (lastCell == cellX_) {
+      result = {maxRange, false};
+      return true;
+    }
+
+    const int blocked = (stepX_ > 0) ? world.FirstObstacleInRow(cellY_, cellX_ + 1, lastCell + 1)
+                                     : world.LastObstacleInRow(cellY_, lastCell, cellX_);
+    const bool hit = (stepX_ > 0) ? (blocked <= lastCell) : (blocked >= lastCell);
+    result = hit ? std::pair<double, bool>{entryDistance(blocked), true} : std::pair<double, bool>{maxRange, false};
+    return true;
+  }
+
+  int CellX() const { return cellX_; }
+  int CellY() const { return cellY_; }
+
+ private:
+  double NextBoundaryX() const {
+    return (stepX_ == 0) ? std::numeric_limits<double>::infinity()
+                         : (static_cast<double>(cellX_ + (stepX_ > 0 ? 1 : 0)) - originX_) * invDirX_;
+  }
+  double NextBoundaryY() const {
+    return (stepY_ == 0) ? std::numeric_limits<double>::infinity()
+                         : (static_cast<double>(cellY_ + (stepY_ > 0 ? 1 : 0)) - originY_) * invDirY_;
+  }
+
+  double originX_ = 0.0;
+  double originY_ = 0.0;
+  int stepX_ = 0;
+  int stepY_ = 0;
+  double invDirX_ = 0.0;
+  double invDirY_ = 0.0;
+  double dirX_ = 0.0;
+  double dirY_ = 0.0;
+  int cellX_ = 0;
+  int cellY_ = 0;
+  double tMaxX_ = 0.0;
+  double tMaxY_ = 0.0;
+};
+
+}  // namespace
 
 /**
  * @brief Construct a lidar model with fixed scan parameters.
  */
-SimulatedLidar::SimulatedLidar(double maxRange, int beamCount, double stepSize)
-    : maxRange_(maxRange), beamCount_(beamCount), stepSize_(stepSize) {
+SimulatedLidar::SimulatedLidar(double maxRange, int beamCount, double stepSize, LidarMode mode)
+    : maxRange_(maxRange), beamCount_(beamCount), stepSize_(stepSize), mode_(mode) {
   if (maxRange <= 0.0 || beamCount <= 0 || stepSize <= 0.0) {
     throw std::invalid_argument("SimulatedLidar parameters must be positive");
   }
+
+  constexpr double kTwoPi = 6.28318530717958647692;
+  relativeAngles_.resize(static_cast<std::size_t>(beamCount_));
+  relativeCos_.resize(relativeAngles_.size());
+  relativeSin_.resize(relativeAngles_.size());
+  for (std::size_t i = 0; i < relativeAngles_.size(); ++i) {
+    relativeAngles_[i] = (kTwoPi * static_cast<double>(i)) / static_cast<double>(beamCount_);
+    relativeCos_[i] = std::cos(relativeAngles_[i]);
+    relativeSin_[i] = std::sin(relativeAngles_[i]);
+  }
 }
 
 /**
@@ -27,36 +155,302 @@ SimulatedLidar::SimulatedLidar(double maxRange, int beamCount, double stepSize)
  * @return Beam samples containing distance and hit state.
  */
 std::vector<ScanSample> SimulatedLidar::Scan(const WorldGrid& world, const RobotPose& pose) const {
-  std::vector<ScanSample> samples;
-  samples.reserve(static_cast<std::size_t>(beamCount_));
+  std::vector<ScanSample> samples(static_cast<std::size_t>(beamCount_));
+  ScanInto(world, pose, samples);
+  return samples;
+}
 
-  constexpr double kTwoPi = 6.28318530717958647692;
-  for (int beamIndex = 0; beamIndex < beamCount_; ++beamIndex) {
-    const double relativeAngle = (kTwoPi * static_cast<double>(beamIndex)) / static_cast<double>(beamCount_);
-    const double absoluteAngle = pose.theta + relativeAngle;
-    const auto [distance, hit] = CastBeam(world, pose, absoluteAngle);
-    samples.push_back(ScanSample{
-        .relativeAngle = relativeAngle,
-        .distance = distance,
-        .hit = hit,
-    });
+/**
+ * @brief Execute a full scan into a reusable buffer.
+ * @param world Ground-truth world grid.
+ * @param pose Robot pose.
+ * @param buffer Destination buffer.
+ */
+void SimulatedLidar::Scan(const WorldGrid& world, const RobotPose& pose, ScanBuffer& buffer) const {
+  buffer.Resize(beamCount_);
+  const bool fillDirections = !buffer.HasDirectionsFor(pose.theta);
+  ScanBeamRange(world, pose, buffer, 0, relativeAngles_.size(), fillDirections);
+  buffer.MarkDirectionsFor(pose.theta);
+}
+
+/**
+ * @brief Execute a full scan into a reusable buffer, casting angular sectors in parallel.
+ * @param world Ground-truth world grid.
+ * @param pose Robot pose.
+ * @param buffer Destination buffer.
+ * @param pool Worker pool that casts the sectors.
+ */
+void SimulatedLidar::Scan(const WorldGrid& world, const RobotPose& pose, ScanBuffer& buffer, WorkerPool& pool) const {
+  buffer.Resize(beamCount_);
+  const bool fillDirections = !buffer.HasDirectionsFor(pose.theta);
+
+  // A few sectors per thread balances long open-space beams against short ones. Sector
+  // bounds are multiples of 64 so no two sectors share a packed hit word.
+  const std::size_t beams = relativeAngles_.size();
+  const std::size_t targetSectors = static_cast<std::size_t>(pool.ThreadCount()) * 4U;
+  const std::size_t sectorSize = std::max<std::size_t>(64U, ((beams / targetSectors) + 63U) & ~std::size_t{63});
+  const std::size_t sectorCount = (beams + sectorSize - 1U) / sectorSize;
+  pool.ParallelFor(sectorCount, [&](std::size_t sector) {
+    const std::size_t begin = sector * sectorSize;
+    ScanBeamRange(world, pose, buffer, begin, std::min(beams, begin + sectorSize), fillDirections);
+  });
+  buffer.MarkDirectionsFor(pose.theta);
+}
+
+/**
+ * @brief Cast one contiguous beam range into a buffer.
+ * @param fillDirections True to compute the range's cached directions first.
+ */
+void SimulatedLidar::ScanBeamRange(
+    const WorldGrid& world,
+    const RobotPose& pose,
+    ScanBuffer& buffer,
+    std::size_t begin,
+    std::size_t end,
+    bool fillDirections) const {
+  if (fillDirections) {
+    // Absolute-angle trig rather than rotating a relative table keeps axis-aligned beams
+    // bit-identical to the reference simulator.
+    for (std::size_t i = begin; i < end; ++i) {
+      const double angle = pose.theta + relativeAngles_[i];
+      buffer.SetDirection(i, std::cos(angle), std::sin(angle));
+    }
   }
-  return samples;
+
+  const std::span<const double> dirX = buffer.DirectionsX();
+  const std::span<const double> dirY = buffer.DirectionsY();
+  CastBeamRange(
+      world,
+      pose,
+      begin,
+      end,
+      [&](std::size_t i) { return std::pair<double, double>{dirX[i], dirY[i]}; },
+      [&](std::size_t i, const ScanSample& sample, double beamDirX, double beamDirY) {
+        buffer.Store(i, sample, pose.x + beamDirX * sample.distance, pose.y + beamDirY * sample.distance);
+      });
 }
 
 /**
- * @brief Cast one beam by ray-marching through the world.
+ * @brief Execute a full scan into caller-owned samples.
+ * @param world Ground-truth world grid.
+ * @param pose Robot pose.
+ * @param output Destination samples.
+ */
+void SimulatedLidar::ScanInto(const WorldGrid& world, const RobotPose& pose, std::span<ScanSample> output) const {
+  if (output.size() < static_cast<std::size_t>(beamCount_)) {
+    throw std::invalid_argument("ScanInto output is smaller than the beam count");
+  }
+  CastBeamRange(
+      world,
+      pose,
+      0,
+      relativeAngles_.size(),
+      [&](std::size_t i) {
+        const double angle = pose.theta + relativeAngles_[i];
+        return std::pair<double, double>{std::cos(angle), std::sin(angle)};
+      },
+      [&](std::size_t i, const ScanSample& sample, double, double) { output[i] = sample; });
+}
+
+/**
+ * @brief Scan a pose batch on the calling thread.
+ * @param world Ground-truth world grid.
+ * @param poses Poses to scan.
+ * @param output Destination batch.
+ */
+void SimulatedLidar::ScanBatch(
+    const WorldGrid& world, std::span<const RobotPose> poses, ScanBatchBuffer& output) const {
+  PrepareBatch(poses, output);
+  for (const std::uint64_t entry : output.CastOrder()) {
+    const std::size_t poseIndex = static_cast<std::size_t>(entry & 0xFFFFFFFFU);
+    ScanBatchPose(world, poses[poseIndex], poseIndex, output);
+  }
+}
+
+/**
+ * @brief Scan a pose batch with runs of the tile-sorted order spread across a pool.
+ * @param world Ground-truth world grid.
+ * @param poses Poses to scan.
+ * @param output Destination batch.
+ * @param pool Worker pool that casts the pose runs.
+ */
+void SimulatedLidar::ScanBatch(
+    const WorldGrid& world, std::span<const RobotPose> poses, ScanBatchBuffer& output, WorkerPool& pool) const {
+  PrepareBatch(poses, output);
+  const std::span<const std::uint64_t> order = output.CastOrder();
+  const std::size_t runSize =
+      std::max<std::size_t>(1U, order.size() / (static_cast<std::size_t>(pool.ThreadCount()) * 4U));
+  pool.ParallelFor((order.size() + runSize - 1U) / runSize, [&](std::size_t run) {
+    const std::size_t end = std::min(order.size(), (run + 1U) * runSize);
+    for (std::size_t i = run * runSize; i < end; ++i) {
+      const std::size_t poseIndex = static_cast<std::size_t>(order[i] & 0xFFFFFFFFU);
+      ScanBatchPose(world, poses[poseIndex], poseIndex, output);
+    }
+  });
+}
+
+/**
+ * @brief Size the batch and sort pose indices by the Morton code of their 16-cell tile.
+ * @param poses Poses to scan.
+ * @param output Destination batch whose cast order is rewritten.
+ */
+void SimulatedLidar::PrepareBatch(std::span<const RobotPose> poses, ScanBatchBuffer& output) const {
+  if (poses.size() > 0xFFFFFFFFU) {
+    throw std::invalid_argument("ScanBatch supports at most 2^32 - 1 poses");
+  }
+  output.Resize(poses.size(), relativeAngles_.size());
+
+  // Spread the low 16 bits of v to even bit positions.
+  const auto spread = [](std::uint64_t v) {
+    v &= 0xFFFFU;
+    v = (v | (v << 8U)) & 0x00FF00FFU;
+    v = (v | (v << 4U)) & 0x0F0F0F0FU;
+    v = (v | (v << 2U)) & 0x33333333U;
+    v = (v | (v << 1U)) & 0x55555555U;
+    return v;
+  };
+  constexpr double kTileSize = 16.0;
+  const std::span<std::uint64_t> order = output.CastOrder();
+  for (std::size_t i = 0; i < poses.size(); ++i) {
+    const std::uint64_t tileX = static_cast<std::uint64_t>(std::clamp(poses[i].x / kTileSize, 0.0, 65535.0));
+    const std::uint64_t tileY = static_cast<std::uint64_t>(std::clamp(poses[i].y / kTileSize, 0.0, 65535.0));
+    order[i] = ((spread(tileX) | (spread(tileY) << 1U)) << 32U) | static_cast<std::uint64_t>(i);
+  }
+  std::sort(order.begin(), order.end());
+}
+
+/**
+ * @brief Cast one batch pose with the relative direction table rotated by its heading.
+ * @param world Ground-truth world grid.
+ * @param pose Pose to scan.
+ * @param poseIndex Output slot of the pose.
+ * @param output Destination batch.
+ */
+void SimulatedLidar::ScanBatchPose(
+    const WorldGrid& world, const RobotPose& pose, std::size_t poseIndex, ScanBatchBuffer& output) const {
+  const double headingCos = std::cos(pose.theta);
+  const double headingSin = std::sin(pose.theta);
+  CastBeamRange(
+      world,
+      pose,
+      0,
+      relativeAngles_.size(),
+      [&](std::size_t i) {
+        return std::pair<double, double>{
+            headingCos * relativeCos_[i] - headingSin * relativeSin_[i],
+            headingSin * relativeCos_[i] + headingCos * relativeSin_[i],
+        };
+      },
+      [&](std::size_t i, const ScanSample& sample, double dirX, double dirY) {
+        output.Store(poseIndex, i, sample.distance, sample.hit, pose.x + dirX * sample.distance,
+                     pose.y + dirY * sample.distance);
+      });
+}
+
+/**
+ * @brief Cast the beams with indices in [begin, end).
  * @param world Ground-truth world grid.
  * @param pose Robot pose.
- * @param angle Absolute beam angle in radians.
+ * @param begin First beam index.
+ * @param end One past the last beam index.
+ * @param direction Returns the absolute direction of each beam index.
+ * @param sink Receives each beam index, sample, and direction.
+ */
+template <typename DirectionFn, typename Sink>
+void SimulatedLidar::CastBeamRange(
+    const WorldGrid& world,
+    const RobotPose& pose,
+    std::size_t begin,
+    std::size_t end,
+    DirectionFn&& direction,
+    Sink&& sink) const {
+  if (mode_ == LidarMode::kBatchedRayMarch) {
+    // Stage directions in fixed chunks so the lockstep kernel runs without heap storage.
+    constexpr std::size_t kChunk = 64;
+    std::array<double, kChunk> dirX{};
+    std::array<double, kChunk> dirY{};
+    std::array<double, kChunk> distances{};
+    std::array<bool, kChunk> hits{};
+    for (std::size_t chunk = begin; chunk < end; chunk += kChunk) {
+      const std::size_t count = std::min(kChunk, end - chunk);
+      for (std::size_t j = 0; j < count; ++j) {
+        std::tie(dirX[j], dirY[j]) = direction(chunk + j);
+      }
+      RayMarchBeams(
+          world,
+          pose.x,
+          pose.y,
+          std::span<const double>(dirX.data(), count),
+          std::span<const double>(dirY.data(), count),
+          stepSize_,
+          maxRange_,
+          std::span<double>(distances.data(), count),
+          std::span<bool>(hits.data(), count));
+      for (std::size_t j = 0; j < count; ++j) {
+        sink(chunk + j,
+             ScanSample{
+                 .relativeAngle = relativeAngles_[chunk + j],
+                 .distance = distances[j],
+                 .hit = hits[j],
+             },
+             dirX[j],
+             dirY[j]);
+      }
+    }
+    return;
+  }
+
+  for (std::size_t i = begin; i < end; ++i) {
+    const auto [dirX, dirY] = direction(i);
+    const auto [distance, hit] = CastBeam(world, pose, dirX, dirY);
+    sink(i,
+         ScanSample{
+             .relativeAngle = relativeAngles_[i],
+             .distance = distance,
+             .hit = hit,
+         },
+         dirX,
+         dirY);
+  }
+}
+
+/**
+ * @brief Cast one beam with the configured strategy.
+ * @param world Ground-truth world grid.
+ * @param pose Robot pose.
+ * @param dirX Beam direction X component.
+ * @param dirY Beam direction Y component.
  * @return Pair of measured distance and hit flag.
  */
 std::pair<double, bool> SimulatedLidar::CastBeam(
-    const WorldGrid& world, const RobotPose& pose, double angle) const {
+    const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const {
+  switch (mode_) {
+    case LidarMode::kGridTraversal:
+      return CastBeamGridTraversal(world, pose, dirX, dirY);
+    case LidarMode::kSphereTrace:
+      return CastBeamSphereTrace(world, pose, dirX, dirY);
+    case LidarMode::kRayMarch:
+    case LidarMode::kBatchedRayMarch:
+      break;
+  }
+  return CastBeamRayMarch(world, pose, dirX, dirY);
+}
+
+/**
+ * @brief Cast one beam by ray-marching through the world.
+ * @param world Ground-truth world grid.
+ * @param pose Robot pose.
+ * @param dirX Beam direction X component.
+ * @param dirY Beam direction Y component.
+ * @return Pair of measured distance and hit flag.
+ * @note Samples every stepSize_ units, so coarse steps can skip thin walls.
+ */
+std::pair<double, bool> SimulatedLidar::CastBeamRayMarch(
+    const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const {
   double distance = stepSize_;
   while (distance <= maxRange_) {
-    const int x = static_cast<int>(pose.x + std::cos(angle) * distance);
-    const int y = static_cast<int>(pose.y + std::sin(angle) * distance);
+    const int x = static_cast<int>(pose.x + dirX * distance);
+    const int y = static_cast<int>(pose.y + dirY * distance);
     if (world.IsObstacle(x, y)) {
       return {distance, true};
     }
@@ -65,4 +459,77 @@ std::pair<double, bool> SimulatedLidar::CastBeam(
   return {maxRange_, false};
 }
 
+/**
+ * @brief Cast one beam with Amanatides-Woo voxel traversal.
+ * @param world Ground-truth world grid.
+ * @param pose Robot pose.
+ * @param dirX Beam direction X component.
+ * @param dirY Beam direction Y component.
+ * @return Pair of exact entry distance into the first blocked cell and hit flag.
+ * @note The robot's own cell is not tested, matching the ray-march behavior.
+ */
+std::pair<double, bool> SimulatedLidar::CastBeamGridTraversal(
+    const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const {
+  CellWalker walker(pose, dirX, dirY);
+  std::pair<double, bool> rowResult;
+  if (walker.TryResolveWithinRow(world, maxRange_, rowResult)) {
+    return rowResult;
+  }
+  while (true) {
+    const double distance = walker.Step();
+    if (distance > maxRange_) {
+      return {maxRange_, false};
+    }
+    if (world.IsObstacle(walker.CellX(), walker.CellY())) {
+      return {distance, true};
+    }
+  }
+}
+
+/**
+ * @brief Cast one beam by sphere tracing over the world clearance field.
+ * @param world Ground-truth world grid with a built distance field.
+ * @param pose Robot pose.
+ * @param dirX Beam direction X component.
+ * @param dirY Beam direction Y component.
+ * @return Pair of exact entry distance into the first blocked cell and hit flag.
+ * @note Jumps while the clearance guarantees empty space, then single-steps cells near walls.
+ */
+std::pair<double, bool> SimulatedLidar::CastBeamSphereTrace(
+    const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const {
+  if (!world.HasDistanceField()) {
+    return CastBeamGridTraversal(world, pose, dirX, dirY);
+  }
+
+  // Clearance is measured between cell centers; the beam point and the nearest
+  // blocked cell boundary can each be half a diagonal closer than that.
+  constexpr double kCenterSlack = 1.41421356237309504880;
+  constexpr double kMinJump = 1.0;
+  CellWalker walker(pose, dirX, dirY);
+  std::pair<double, bool> rowResult;
+  if (walker.TryResolveWithinRow(world, maxRange_, rowResult)) {
+    return rowResult;
+  }
+  double travelled = 0.0;
+  while (true) {
+    const double jump = world.ClearanceAt(walker.CellX(), walker.CellY()) - kCenterSlack;
+    if (jump > kMinJump) {
+      travelled += jump;
+      if (travelled > maxRange_) {
+        return {maxRange_, false};
+      }
+      walker.MoveTo(travelled);
+      continue;
+    }
+
+    travelled = walker.Step();
+    if (travelled > maxRange_) {
+      return {maxRange_, false};
+    }
+    if (world.IsObstacle(walker.CellX(), walker.CellY())) {
+      return {travelled, true};
+    }
+  }
+}
+
 }  // namespace slam::core
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <span>
 #include <utility>
 #include <vector>
 
+#include "core/ScanBatchBuffer.h"
+#include "core/ScanBuffer.h"
 #include "core/Types.h"
+#include "core/WorkerPool.h"
 #include "core/WorldGrid.h"
 
 /**
@@ -14,7 +18,7 @@
 namespace slam::core {
 
 /**
- * @brief Performs ray-march lidar scans over a WorldGrid.
+ * @brief Performs lidar scans over a WorldGrid using a selectable beam caster.
  */
 class SimulatedLidar {
  public:
@@ -23,8 +27,9 @@ class SimulatedLidar {
    * @param maxRange Maximum sensing range in grid units.
    * @param beamCount Number of beams per 360-degree scan.
    * @param stepSize Step size for beam marching.
+   * @param mode Beam casting strategy.
    */
-  SimulatedLidar(double maxRange, int beamCount, double stepSize);
+  SimulatedLidar(double maxRange, int beamCount, double stepSize, LidarMode mode = LidarMode::kRayMarch);
 
   /**
    * @brief Run a full scan from the given robot pose.
@@ -33,20 +38,122 @@ class SimulatedLidar {
    * @return Per-beam measurements.
    */
   std::vector<ScanSample> Scan(const WorldGrid& world, const RobotPose& pose) const;
+  /**
+   * @brief Run a full scan into a reusable buffer without allocating in steady state.
+   * @param world Ground-truth world.
+   * @param pose Robot pose.
+   * @param buffer Destination buffer, resized to the beam count; endpoints are filled too.
+   * @note Beam directions are evaluated once per heading and cached in the buffer, so
+   * consumers read world-space endpoints instead of repeating the trigonometry.
+   */
+  void Scan(const WorldGrid& world, const RobotPose& pose, ScanBuffer& buffer) const;
+  /**
+   * @brief Run a full scan into a reusable buffer, casting angular sectors on a worker pool.
+   * @param world Ground-truth world.
+   * @param pose Robot pose.
+   * @param buffer Destination buffer, resized to the beam count; endpoints are filled too.
+   * @param pool Worker pool; results are identical to the single-threaded scan.
+   */
+  void Scan(const WorldGrid& world, const RobotPose& pose, ScanBuffer& buffer, WorkerPool& pool) const;
+  /**
+   * @brief Run a full scan into caller-owned storage.
+   * @param world Ground-truth world.
+   * @param pose Robot pose.
+   * @param output Destination holding at least BeamCount() samples; the first BeamCount() are written.
+   * @throws std::invalid_argument when output is too small.
+   */
+  void ScanInto(const WorldGrid& world, const RobotPose& pose, std::span<ScanSample> output) const;
+  /**
+   * @brief Scan many poses into one pose-major buffer.
+   * @param world Ground-truth world.
+   * @param poses Poses to scan; output pose i belongs to poses[i].
+   * @param output Destination batch, resized to poses.size() x BeamCount().
+   * @note Poses are cast in spatial tile order so consecutive poses touch the same world
+   * words. Beam directions come from the shared relative table rotated per pose, which
+   * can differ from Scan in the last bit of a direction.
+   */
+  void ScanBatch(const WorldGrid& world, std::span<const RobotPose> poses, ScanBatchBuffer& output) const;
+  /**
+   * @brief Scan many poses into one pose-major buffer, spreading poses across a worker pool.
+   * @param pool Worker pool; results are identical to the single-threaded batch.
+   */
+  void ScanBatch(
+      const WorldGrid& world, std::span<const RobotPose> poses, ScanBatchBuffer& output, WorkerPool& pool) const;
+
+  /// @return Number of beams per scan.
+  int BeamCount() const { return beamCount_; }
+  /// @return Active beam casting strategy.
+  LidarMode Mode() const { return mode_; }
+  /// @return Beam angles relative to the robot heading, shared by every scan.
+  std::span<const double> RelativeAngles() const { return relativeAngles_; }
 
  private:
   /**
-   * @brief Cast one beam at an absolute angle.
+   * @brief Size a batch buffer and fill its cast order with poses sorted by spatial tile.
+   */
+  void PrepareBatch(std::span<const RobotPose> poses, ScanBatchBuffer& output) const;
+  /**
+   * @brief Cast every beam of one batch pose.
+   */
+  void ScanBatchPose(const WorldGrid& world, const RobotPose& pose, std::size_t poseIndex, ScanBatchBuffer& output)
+      const;
+  /**
+   * @brief Cast beams [begin, end) into a buffer, optionally computing their directions first.
+   */
+  void ScanBeamRange(
+      const WorldGrid& world,
+      const RobotPose& pose,
+      ScanBuffer& buffer,
+      std::size_t begin,
+      std::size_t end,
+      bool fillDirections) const;
+  /**
+   * @brief Cast beams [begin, end) and hand each measurement to a sink.
+   * @param direction Callable taking a beam index and returning its absolute (x, y) direction.
+   * @param sink Callable taking (beam index, sample, direction x, direction y).
+   */
+  template <typename DirectionFn, typename Sink>
+  void CastBeamRange(
+      const WorldGrid& world,
+      const RobotPose& pose,
+      std::size_t begin,
+      std::size_t end,
+      DirectionFn&& direction,
+      Sink&& sink) const;
+
+  /**
+   * @brief Cast one beam along an absolute unit direction using the active mode.
    * @param world Ground-truth world.
    * @param pose Robot pose.
-   * @param angle Absolute beam angle in radians.
+   * @param dirX Beam direction X component.
+   * @param dirY Beam direction Y component.
    * @return Pair of measured distance and hit flag.
    */
-  std::pair<double, bool> CastBeam(const WorldGrid& world, const RobotPose& pose, double angle) const;
+  std::pair<double, bool> CastBeam(const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const;
+  /**
+   * @brief Cast one beam by fixed-step ray marching.
+   */
+  std::pair<double, bool> CastBeamRayMarch(
+      const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const;
+  /**
+   * @brief Cast one beam by visiting every grid cell it crosses exactly once.
+   */
+  std::pair<double, bool> CastBeamGridTraversal(
+      const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const;
+  /**
+   * @brief Cast one beam by jumping through open space with the world clearance field.
+   * @note Falls back to grid traversal when the world has no distance field.
+   */
+  std::pair<double, bool> CastBeamSphereTrace(
+      const WorldGrid& world, const RobotPose& pose, double dirX, double dirY) const;
 
   double maxRange_ = 0.0;
   int beamCount_ = 0;
   double stepSize_ = 0.0;
+  LidarMode mode_ = LidarMode::kRayMarch;
+  std::vector<double> relativeAngles_;
+  std::vector<double> relativeCos_;
+  std::vector<double> relativeSin_;
 };
 
 }  // namespace slam::core
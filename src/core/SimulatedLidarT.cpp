@@ -0,0 +1,17 @@
+/**
+ * @file SimulatedLidarT.cpp
+ * @brief Explicit instantiations of the compile-time lidar presets.
+ */
+
+#include "core/SimulatedLidarT.h"
+
+namespace slam::core {
+
+template class SimulatedLidarT<72, double>;
+template class SimulatedLidarT<72, float>;
+template class SimulatedLidarT<360, double>;
+template class SimulatedLidarT<360, float>;
+template class SimulatedLidarT<1080, double>;
+template class SimulatedLidarT<1080, float>;
+
+}  // namespace slam::core
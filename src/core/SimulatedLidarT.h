@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "core/ScanBuffer.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+/**
+ * @file SimulatedLidarT.h
+ * @brief Ray-march lidar specialized at compile time for a beam count and precision.
+ */
+
+namespace slam::core {
+namespace detail {
+
+/// 2*pi in double precision, shared by the table builders.
+inline constexpr double kTwoPi = 6.28318530717958647692;
+
+/**
+ * @brief Taylor-series sine and cosine of an angle within [-pi/4, pi/4].
+ * @return Pair of (cos, sin), accurate to double rounding on that interval.
+ */
+constexpr std::pair<double, double> ReducedCosSin(double r) {
+  const double r2 = r * r;
+  double cosTerm = 1.0;
+  double sinTerm = r;
+  double cosSum = cosTerm;
+  double sinSum = sinTerm;
+  for (int n = 1; n <= 12; ++n) {
+    cosTerm *= -r2 / static_cast<double>((2 * n - 1) * (2 * n));
+    sinTerm *= -r2 / static_cast<double>((2 * n) * (2 * n + 1));
+    cosSum += cosTerm;
+    sinSum += sinTerm;
+  }
+  return {cosSum, sinSum};
+}
+
+/**
+ * @brief Direction of beam index out of beamCount, evaluated at compile time.
+ * @return Pair of (cos, sin) of 2*pi*index/beamCount.
+ * @note Reduces by quadrant with integer arithmetic first, so axis-aligned beams are exact.
+ */
+constexpr std::pair<double, double> BeamCosSin(int index, int beamCount) {
+  // Nearest quadrant k and remainder r = 2*pi*(4*index - k*beamCount) / (4*beamCount).
+  const int quadrant = (8 * index + beamCount) / (2 * beamCount);
+  const double remainder =
+      (kTwoPi * static_cast<double>(4 * index - quadrant * beamCount)) / static_cast<double>(4 * beamCount);
+  const auto [c, s] = ReducedCosSin(remainder);
+  switch (quadrant % 4) {
+    case 1:
+      return {-s, c};
+    case 2:
+      return {-c, -s};
+    case 3:
+      return {s, -c};
+    default:
+      return {c, s};
+  }
+}
+
+/**
+ * @brief Per-beam relative angle and direction table built at compile time.
+ */
+template <int BeamCount, typename Real>
+struct BeamTable {
+  std::array<double, BeamCount> angle{};
+  std::array<Real, BeamCount> cos{};
+  std::array<Real, BeamCount> sin{};
+
+  static constexpr BeamTable Build() {
+    BeamTable table;
+    for (int i = 0; i < BeamCount; ++i) {
+      const auto [c, s] = BeamCosSin(i, BeamCount);
+      table.angle[static_cast<std::size_t>(i)] = (kTwoPi * static_cast<double>(i)) / static_cast<double>(BeamCount);
+      table.cos[static_cast<std::size_t>(i)] = static_cast<Real>(c);
+      table.sin[static_cast<std::size_t>(i)] = static_cast<Real>(s);
+    }
+    return table;
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Fixed-step ray-march lidar with the beam count and arithmetic precision baked in.
+ * @tparam BeamCount Number of beams per 360-degree scan.
+ * @tparam Real Beam arithmetic type, float or double.
+ * @note The relative direction table is a compile-time constant rotated once per scan by
+ * the heading, so a scan costs two trig calls regardless of beam count. Directions can
+ * differ from SimulatedLidar's absolute-angle trig in the last bit, so beams that graze
+ * a cell boundary exactly may resolve differently; use SimulatedLidar where bit parity
+ * with the reference simulator matters. Common presets are instantiated once in
+ * SimulatedLidarT.cpp; other counts instantiate on use.
+ */
+template <int BeamCount, std::floating_point Real = double>
+class SimulatedLidarT {
+  static_assert(BeamCount > 0, "SimulatedLidarT needs at least one beam");
+
+ public:
+  /// Number of beams per scan.
+  static constexpr int kBeamCount = BeamCount;
+  /// Compile-time relative angle and direction per beam.
+  static constexpr detail::BeamTable<BeamCount, Real> kTable = detail::BeamTable<BeamCount, Real>::Build();
+
+  /**
+   * @brief Construct a lidar model.
+   * @param maxRange Maximum sensing range in grid units.
+   * @param stepSize Step size for beam marching.
+   * @throws std::invalid_argument when either parameter is not positive.
+   */
+  SimulatedLidarT(Real maxRange, Real stepSize);
+
+  /**
+   * @brief Run a full scan from the given robot pose.
+   * @param world Ground-truth world.
+   * @param pose Robot pose.
+   * @return Per-beam measurements.
+   */
+  std::array<ScanSample, BeamCount> Scan(const WorldGrid& world, const RobotPose& pose) const;
+  /**
+   * @brief Run a full scan into a reusable buffer, including world-space endpoints.
+   * @param world Ground-truth world.
+   * @param pose Robot pose.
+   * @param buffer Destination buffer, resized to the beam count.
+   */
+  void Scan(const WorldGrid& world, const RobotPose& pose, ScanBuffer& buffer) const;
+  /**
+   * @brief Run a full scan into caller-owned storage sized at compile time.
+   * @param world Ground-truth world.
+   * @param pose Robot pose.
+   * @param output Destination samples.
+   */
+  void ScanInto(const WorldGrid& world, const RobotPose& pose, std::span<ScanSample, BeamCount> output) const;
+
+ private:
+  /**
+   * @brief Cast every beam and hand each measurement to a sink.
+   * @param sink Callable taking (beam index, distance, hit, direction x, direction y).
+   */
+  template <typename Sink>
+  void CastAllBeams(const WorldGrid& world, const RobotPose& pose, Sink&& sink) const;
+
+  Real maxRange_;
+  Real stepSize_;
+};
+
+template <int BeamCount, std::floating_point Real>
+SimulatedLidarT<BeamCount, Real>::SimulatedLidarT(Real maxRange, Real stepSize)
+    : maxRange_(maxRange), stepSize_(stepSize) {
+  if (maxRange <= Real{0} || stepSize <= Real{0}) {
+    throw std::invalid_argument("SimulatedLidarT parameters must be positive");
+  }
+}
+
+template <int BeamCount, std::floating_point Real>
+std::array<ScanSample, BeamCount> SimulatedLidarT<BeamCount, Real>::Scan(
+    const WorldGrid& world, const RobotPose& pose) const {
+  std::array<ScanSample, BeamCount> samples{};
+  ScanInto(world, pose, samples);
+  return samples;
+}
+
+template <int BeamCount, std::floating_point Real>
+void SimulatedLidarT<BeamCount, Real>::Scan(const WorldGrid& world, const RobotPose& pose, ScanBuffer& buffer) const {
+  buffer.Resize(BeamCount);
+  CastAllBeams(world, pose, [&](std::size_t i, Real distance, bool hit, Real dirX, Real dirY) {
+    buffer.Store(
+        i,
+        ScanSample{.relativeAngle = kTable.angle[i], .distance = static_cast<double>(distance), .hit = hit},
+        pose.x + static_cast<double>(dirX * distance),
+        pose.y + static_cast<double>(dirY * distance));
+  });
+}
+
+template <int BeamCount, std::floating_point Real>
+void SimulatedLidarT<BeamCount, Real>::ScanInto(
+    const WorldGrid& world, const RobotPose& pose, std::span<ScanSample, BeamCount> output) const {
+  CastAllBeams(world, pose, [&](std::size_t i, Real distance, bool hit, Real, Real) {
+    output[i] = ScanSample{.relativeAngle = kTable.angle[i], .distance = static_cast<double>(distance), .hit = hit};
+  });
+}
+
+template <int BeamCount, std::floating_point Real>
+template <typename Sink>
+void SimulatedLidarT<BeamCount, Real>::CastAllBeams(
+    const WorldGrid& world, const RobotPose& pose, Sink&& sink) const {
+  const Real headingCos = static_cast<Real>(std::cos(pose.theta));
+  const Real headingSin = static_cast<Real>(std::sin(pose.theta));
+  const Real originX = static_cast<Real>(pose.x);
+  const Real originY = static_cast<Real>(pose.y);
+  for (std::size_t i = 0; i < static_cast<std::size_t>(BeamCount); ++i) {
+    const Real dirX = headingCos * kTable.cos[i] - headingSin * kTable.sin[i];
+    const Real dirY = headingSin * kTable.cos[i] + headingCos * kTable.sin[i];
+    Real distance = stepSize_;
+    bool hit = false;
+    while (distance <= maxRange_) {
+      const int x = static_cast<int>(originX + dirX * distance);
+      const int y = static_cast<int>(originY + dirY * distance);
+      if (world.IsObstacle(x, y)) {
+        hit = true;
+        break;
+      }
+      distance += stepSize_;
+    }
+    sink(i, hit ? distance : maxRange_, hit, dirX, dirY);
+  }
+}
+
+/// Default 72-beam lidar.
+using SimulatedLidar72 = SimulatedLidarT<72>;
+/// One-degree 360-beam lidar.
+using SimulatedLidar360 = SimulatedLidarT<360>;
+/// Third-of-a-degree 1080-beam lidar.
+using SimulatedLidar1080 = SimulatedLidarT<1080>;
+
+extern template class SimulatedLidarT<72, double>;
+extern template class SimulatedLidarT<72, float>;
+extern template class SimulatedLidarT<360, double>;
+extern template class SimulatedLidarT<360, float>;
+extern template class SimulatedLidarT<1080, double>;
+extern template class SimulatedLidarT<1080, float>;
+
+}  // namespace slam::core
@@ -0,0 +1,198 @@
+/**
+ * @file SparseOccupancyGridMap.cpp
+ * @brief Chunk-hashed occupancy integration over an unbounded cell plane.
+ */
+
+#include "core/SparseOccupancyGridMap.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "core/OccupancyCell.h"
+
+namespace slam::core {
+namespace {
+
+/// Mask of a coordinate's offset within its chunk.
+constexpr int kChunkMask = SparseOccupancyGridMap::kChunkSize - 1;
+
+/**
+ * @brief Cell containing a world coordinate; floors so negative coordinates map correctly.
+ */
+int CellOf(double coordinate) {
+  return static_cast<int>(std::floor(coordinate));
+}
+
+}  // namespace
+
+/**
+ * @brief Construct an empty sparse map.
+ * @param mode Cell update rule.
+ * @param logOdds Log-odds parameters used by MapUpdateMode::kLogOdds.
+ */
+SparseOccupancyGridMap::SparseOccupancyGridMap(MapUpdateMode mode, const LogOddsParams& logOdds)
+    : mode_(mode), logOdds_(logOdds) {
+  if (mode == MapUpdateMode::kLogOdds) {
+    ValidateLogOddsParams(logOdds, "SparseOccupancyGridMap");
+  }
+}
+
+/**
+ * @brief Release every chunk so all cells read as unknown again.
+ */
+void SparseOccupancyGridMap::Reset() {
+  chunks_.clear();
+  chunkIndex_.clear();
+  cachedCells_ = nullptr;
+}
+
+/**
+ * @brief Read map value at a coordinate.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return Raw cell value, or the unknown value when the chunk was never written.
+ */
+std::int16_t SparseOccupancyGridMap::ValueAt(int x, int y) const {
+  const auto found = chunkIndex_.find(ChunkKey(x >> kChunkShift, y >> kChunkShift));
+  if (found == chunkIndex_.end()) {
+    return UnknownCellValue(mode_);
+  }
+  return (*chunks_[found->second].cells)[static_cast<std::size_t>(((y & kChunkMask) << kChunkShift) | (x & kChunkMask))];
+}
+
+/**
+ * @brief Read a map cell thresholded to kUnknown, kFree, or kOccupied.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return Occupancy state value.
+ */
+std::int16_t SparseOccupancyGridMap::ClassifiedValueAt(int x, int y) const {
+  return Classify(ValueAt(x, y));
+}
+
+/**
+ * @brief Threshold a raw value to kUnknown, kFree, or kOccupied.
+ * @param value Raw cell value.
+ * @return Occupancy state value.
+ */
+std::int16_t SparseOccupancyGridMap::Classify(std::int16_t value) const {
+  return ClassifyCellValue(mode_, logOdds_, value);
+}
+
+/**
+ * @brief Integrate one lidar scan into the sparse map.
+ * @param pose Robot pose.
+ * @param scan Scan samples to fuse.
+ */
+void SparseOccupancyGridMap::IntegrateScan(const RobotPose& pose, const std::vector<ScanSample>& scan) {
+  IntegrateScan(pose, std::span<const ScanSample>(scan));
+}
+
+/**
+ * @brief Integrate one lidar scan held in caller-owned storage.
+ * @param pose Robot pose.
+ * @param scan Scan samples to fuse.
+ */
+void SparseOccupancyGridMap::IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan) {
+  const int startX = CellOf(pose.x);
+  const int startY = CellOf(pose.y);
+  WithCellUpdateRules(mode_, logOdds_, [&](auto miss, auto onHit) {
+    for (const ScanSample& sample : scan) {
+      const double angle = pose.theta + sample.relativeAngle;
+      IntegrateBeam(startX, startY, CellOf(pose.x + std::cos(angle) * sample.distance),
+                    CellOf(pose.y + std::sin(angle) * sample.distance), sample.hit, miss, onHit);
+    }
+  });
+}
+
+/**
+ * @brief Integrate one struct-of-arrays scan from its stored endpoints.
+ * @param pose Robot pose.
+ * @param scan Scan with world-space endpoints.
+ */
+void SparseOccupancyGridMap::IntegrateScan(const RobotPose& pose, const ScanBuffer& scan) {
+  const int startX = CellOf(pose.x);
+  const int startY = CellOf(pose.y);
+  WithCellUpdateRules(mode_, logOdds_, [&](auto miss, auto onHit) {
+    for (std::size_t i = 0; i < scan.Size(); ++i) {
+      IntegrateBeam(startX, startY, CellOf(scan.EndX()[i]), CellOf(scan.EndY()[i]), scan.Hit(i), miss, onHit);
+    }
+  });
+}
+
+/**
+ * @brief Smallest cell rectangle covering every allocated chunk.
+ * @return Half-open cell rectangle; all zero when no chunk is allocated.
+ */
+GridRect SparseOccupancyGridMap::Bounds() const {
+  if (chunks_.empty()) {
+    return {};
+  }
+  GridRect bounds{.xBegin = INT_MAX, .yBegin = INT_MAX, .xEnd = INT_MIN, .yEnd = INT_MIN};
+  for (const Chunk& chunk : chunks_) {
+    bounds.xBegin = std::min(bounds.xBegin, chunk.chunkX * kChunkSize);
+    bounds.yBegin = std::min(bounds.yBegin, chunk.chunkY * kChunkSize);
+    bounds.xEnd = std::max(bounds.xEnd, (chunk.chunkX + 1) * kChunkSize);
+    bounds.yEnd = std::max(bounds.yEnd, (chunk.chunkY + 1) * kChunkSize);
+  }
+  return bounds;
+}
+
+/**
+ * @brief Walk one beam and apply the given cell updates.
+ * @param startX Robot cell X.
+ * @param startY Robot cell Y.
+ * @param endX Beam end cell X.
+ * @param endY Beam end cell Y.
+ * @param hit True when the beam terminated on an obstacle.
+ * @param miss Called with every ray cell.
+ * @param onHit Called with the end cell when the beam hit.
+ * @note Same cells as OccupancyGridMap's per-beam walk: the robot cell is never freed and
+ * a hit's end cell gets the hit update instead.
+ */
+template <typename MissFn, typename HitFn>
+void SparseOccupancyGridMap::IntegrateBeam(
+    int startX, int startY, int endX, int endY, bool hit, MissFn&& miss, HitFn&& onHit) {
+  const int length = GridLineLength(startX, startY, endX, endY);
+  const GridRect everywhere{.xBegin = std::min(startX, endX),
+                            .yBegin = std::min(startY, endY),
+                            .xEnd = std::max(startX, endX) + 1,
+                            .yEnd = std::max(startY, endY) + 1};
+  VisitGridLine(startX, startY, endX, endY, 1, hit ? length : length + 1, everywhere,
+                [&](int x, int y) { miss(CellAt(x, y)); });
+  if (hit) {
+    onHit(CellAt(endX, endY));
+  }
+}
+
+/**
+ * @brief Return a writable cell, allocating its chunk filled with unknown on first use.
+ * @param x X coordinate.
+ * @param y Y coordinate.
+ * @return Reference into the chunk storage.
+ */
+std::int16_t& SparseOccupancyGridMap::CellAt(int x, int y) {
+  const std::uint64_t key = ChunkKey(x >> kChunkShift, y >> kChunkShift);
+  if (cachedCells_ == nullptr || key != cachedKey_) {
+    const auto [found, inserted] = chunkIndex_.try_emplace(key, chunks_.size());
+    if (inserted) {
+      auto cells = std::make_unique<ChunkCellArray>();
+      cells->fill(UnknownCellValue(mode_));
+      chunks_.push_back(Chunk{x >> kChunkShift, y >> kChunkShift, std::move(cells)});
+    }
+    cachedKey_ = key;
+    cachedCells_ = chunks_[found->second].cells->data();
+  }
+  return cachedCells_[((y & kChunkMask) << kChunkShift) | (x & kChunkMask)];
+}
+
+/**
+ * @brief Pack a chunk coordinate into one 64-bit hash key.
+ */
+std::uint64_t SparseOccupancyGridMap::ChunkKey(int chunkX, int chunkY) {
+  return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32U) |
+         static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkY));
+}
+
+}  // namespace slam::core
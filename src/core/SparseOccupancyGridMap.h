@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "core/GridLine.h"
+#include "core/ScanBuffer.h"
+#include "core/Types.h"
+
+/**
+ * @file SparseOccupancyGridMap.h
+ * @brief Unbounded occupancy map that allocates fixed-size chunks on first write.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Occupancy map over the whole int cell plane, stored as chunks in a hash map.
+ * @note Cells are addressed by signed coordinates with no bounds. A 32x32-cell chunk is
+ * allocated the first time a scan writes into it, so never-observed space costs nothing
+ * and memory grows with the explored area rather than its bounding box. Values follow
+ * OccupancyGridMap: kUnknown/kFree/kOccupied in MapUpdateMode::kOverwrite, clamped log-odds
+ * in hundredths in MapUpdateMode::kLogOdds.
+ */
+class SparseOccupancyGridMap {
+ public:
+  /// Chunk edge length is 1 << kChunkShift cells.
+  static constexpr int kChunkShift = 5;
+  /// Chunk edge length in cells.
+  static constexpr int kChunkSize = 1 << kChunkShift;
+  /// Cells per chunk.
+  static constexpr std::size_t kChunkCells = static_cast<std::size_t>(kChunkSize) * kChunkSize;
+
+  /**
+   * @brief One allocated chunk.
+   */
+  struct ChunkView {
+    /// Chunk column; its first cell X is chunkX * kChunkSize.
+    int chunkX = 0;
+    /// Chunk row; its first cell Y is chunkY * kChunkSize.
+    int chunkY = 0;
+    /// kChunkCells raw values in row-major order within the chunk.
+    std::span<const std::int16_t> cells;
+  };
+
+  /**
+   * @brief Construct an empty map; every cell reads as unknown.
+   * @param mode Cell update rule.
+   * @param logOdds Increments, clamps, and thresholds for MapUpdateMode::kLogOdds.
+   * @throws std::invalid_argument when log-odds mode gets invalid parameters.
+   */
+  explicit SparseOccupancyGridMap(MapUpdateMode mode = MapUpdateMode::kOverwrite, const LogOddsParams& logOdds = {});
+
+  /// Release every chunk.
+  void Reset();
+  /// Read one raw cell value; unknown outside allocated chunks.
+  std::int16_t ValueAt(int x, int y) const;
+  /// Read one cell as kUnknown, kFree, or kOccupied in either update mode.
+  std::int16_t ClassifiedValueAt(int x, int y) const;
+  /// Threshold a raw value from ValueAt() or ChunkView::cells with this map's rule.
+  std::int16_t Classify(std::int16_t value) const;
+  /**
+   * @brief Integrate one lidar scan into the map.
+   * @param pose Robot pose at scan time.
+   * @param scan Beam samples.
+   */
+  void IntegrateScan(const RobotPose& pose, const std::vector<ScanSample>& scan);
+  /**
+   * @brief Integrate one lidar scan held in caller-owned storage.
+   * @param pose Robot pose at scan time.
+   * @param scan Beam samples.
+   */
+  void IntegrateScan(const RobotPose& pose, std::span<const ScanSample> scan);
+  /**
+   * @brief Integrate one lidar scan using its precomputed world-space endpoints.
+   * @param pose Robot pose at scan time.
+   * @param scan Struct-of-arrays scan with endpoints.
+   */
+  void IntegrateScan(const RobotPose& pose, const ScanBuffer& scan);
+
+  /// @return Number of allocated chunks.
+  std::size_t ChunkCount() const { return chunks_.size(); }
+  /// @return Bytes of cell storage held by allocated chunks.
+  std::size_t CellBytes() const { return chunks_.size() * sizeof(ChunkCellArray); }
+  /// @return Smallest cell rectangle covering every allocated chunk; empty when none are.
+  GridRect Bounds() const;
+  /**
+   * @brief Visit every allocated chunk in allocation order.
+   * @param visit Callable taking a ChunkView.
+   */
+  template <typename Visitor>
+  void ForEachChunk(Visitor&& visit) const {
+    for (const Chunk& chunk : chunks_) {
+      visit(ChunkView{chunk.chunkX, chunk.chunkY, std::span<const std::int16_t>(*chunk.cells)});
+    }
+  }
+  /// @return Cell update rule.
+  MapUpdateMode UpdateMode() const { return mode_; }
+  /// @return Log-odds parameters; only used in MapUpdateMode::kLogOdds.
+  const LogOddsParams& LogOdds() const { return logOdds_; }
+
+ private:
+  using ChunkCellArray = std::array<std::int16_t, kChunkCells>;
+
+  /**
+   * @brief Allocated chunk and its chunk coordinates.
+   */
+  struct Chunk {
+    int chunkX = 0;
+    int chunkY = 0;
+    std::unique_ptr<ChunkCellArray> cells;
+  };
+
+  /**
+   * @brief Free cells toward a beam end cell and mark the end on hits.
+   */
+  template <typename MissFn, typename HitFn>
+  void IntegrateBeam(int startX, int startY, int endX, int endY, bool hit, MissFn&& miss, HitFn&& onHit);
+  /**
+   * @brief Return the cell reference at a coordinate, allocating its chunk when needed.
+   */
+  std::int16_t& CellAt(int x, int y);
+  /**
+   * @brief Hash key of a chunk coordinate.
+   */
+  static std::uint64_t ChunkKey(int chunkX, int chunkY);
+
+  MapUpdateMode mode_ = MapUpdateMode::kOverwrite;
+  LogOddsParams logOdds_{};
+  std::vector<Chunk> chunks_;
+  /// Chunk key to index in chunks_.
+  std::unordered_map<std::uint64_t, std::size_t> chunkIndex_;
+  /// Most recently used chunk; consecutive cells of a beam usually share it.
+  std::uint64_t cachedKey_ = 0;
+  std::int16_t* cachedCells_ = nullptr;
+};
+
+}  // namespace slam::core
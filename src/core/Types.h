@@ -16,6 +16,72 @@ constexpr std::int16_t kFree = 0;
 /// Occupied occupancy state for map cells.
 constexpr std::int16_t kOccupied = 100;
 
+/**
+ * @brief Beam casting strategy used by the simulated lidar.
+ */
+enum class LidarMode {
+  /// Fixed-step ray marching (ref2 parity behavior).
+  kRayMarch,
+  /// Exact Amanatides-Woo cell traversal with sub-cell hit distance.
+  kGridTraversal,
+  /// Grid traversal that skips open space using the world clearance field.
+  kSphereTrace,
+  /// kRayMarch advancing several beams in lockstep with SIMD; bit-identical results.
+  kBatchedRayMarch,
+};
+
+/**
+ * @brief How lidar beams update occupancy map cells.
+ */
+enum class MapUpdateMode {
+  /// Beams overwrite cells with kFree / kOccupied (ref2 parity behavior).
+  kOverwrite,
+  /// Cells accumulate clamped log-odds evidence, see LogOddsParams.
+  kLogOdds,
+};
+
+/**
+ * @brief How a scan's free space is rasterized into the occupancy map.
+ */
+enum class IntegrationMode {
+  /// One Bresenham ray per beam (ref2 parity behavior).
+  kBeams,
+  /// Scanline fill of the polygon through the beam endpoints, every visible cell once.
+  kVisibilityPolygon,
+};
+
+/**
+ * @brief Memory order of occupancy-map cells.
+ */
+enum class MapLayout {
+  /// One contiguous row after another.
+  kRowMajor,
+  /// 16x16-cell tiles stored contiguously, tiles in row-major order.
+  kTiled,
+  /// Z-order: x and y bits interleaved, so every aligned power-of-two square is contiguous.
+  kMorton,
+};
+
+/**
+ * @brief Fixed-point log-odds update parameters in hundredths of a log-odds unit.
+ * @note A cell starts at 0 (p = 0.5). The defaults make one hit enough to show a cell as
+ * occupied, while a wall needs several misses before a single noisy beam can clear it.
+ */
+struct LogOddsParams {
+  /// Added to a beam's end cell when the beam hit an obstacle.
+  std::int16_t hitIncrement = 85;
+  /// Subtracted from every cell a beam passes through.
+  std::int16_t missDecrement = 40;
+  /// Lower clamp, so free cells can still turn occupied after a few hits.
+  std::int16_t clampMin = -200;
+  /// Upper clamp, so occupied cells can still be cleared after a few misses.
+  std::int16_t clampMax = 350;
+  /// Cells at or above this value classify as occupied.
+  std::int16_t occupiedThreshold = 50;
+  /// Cells at or below this value classify as free.
+  std::int16_t freeThreshold = -30;
+};
+
 /**
  * @brief Robot pose in world-grid coordinates.
  */
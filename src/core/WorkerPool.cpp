@@ -0,0 +1,105 @@
+/**
+ * @file WorkerPool.cpp
+ * @brief Worker thread lifecycle and task dispatch.
+ */
+
+#include "core/WorkerPool.h"
+
+#include <stdexcept>
+
+namespace slam::core {
+
+/**
+ * @brief Start threadCount - 1 workers; the caller is the remaining thread.
+ */
+WorkerPool::WorkerPool(int threadCount) {
+  if (threadCount <= 0) {
+    throw std::invalid_argument("WorkerPool thread count must be positive");
+  }
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  // Single-threaded wasm: every task runs inline.
+  threadCount = 1;
+#endif
+  threads_.reserve(static_cast<std::size_t>(threadCount - 1));
+  for (int i = 1; i < threadCount; ++i) {
+    threads_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+/**
+ * @brief Stop and join every worker.
+ */
+WorkerPool::~WorkerPool() {
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+/**
+ * @brief Publish a task batch, help drain it, and wait until every worker is idle again.
+ */
+void WorkerPool::Run(std::size_t taskCount, TaskRef task) {
+  if (threads_.empty() || taskCount <= 1) {
+    for (std::size_t i = 0; i < taskCount; ++i) {
+      task.invoke(task.context, i);
+    }
+    return;
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    task_ = task;
+    taskCount_ = taskCount;
+    nextTask_.store(0, std::memory_order_relaxed);
+    busyWorkers_ = threads_.size();
+    ++generation_;
+  }
+  wake_.notify_all();
+  DrainTasks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busyWorkers_ == 0; });
+}
+
+/**
+ * @brief Worker body: wait for a new batch generation, drain it, report idle.
+ */
+void WorkerPool::WorkerLoop() {
+  std::uint64_t seenGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&] { return stopping_ || generation_ != seenGeneration; });
+      if (stopping_) {
+        return;
+      }
+      seenGeneration = generation_;
+    }
+    DrainTasks();
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      --busyWorkers_;
+    }
+    done_.notify_one();
+  }
+}
+
+/**
+ * @brief Claim and run tasks until the batch is exhausted.
+ */
+void WorkerPool::DrainTasks() {
+  while (true) {
+    const std::size_t task = nextTask_.fetch_add(1, std::memory_order_relaxed);
+    if (task >= taskCount_) {
+      return;
+    }
+    task_.invoke(task_.context, task);
+  }
+}
+
+}  // namespace slam::core
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file WorkerPool.h
+ * @brief Fixed-size thread pool for splitting per-frame work across cores.
+ */
+
+namespace slam::core {
+
+/**
+ * @brief Persistent worker threads that run indexed tasks, with the caller joining in.
+ * @note Browser builds without pthreads and pools of one thread run every task inline on
+ * the calling thread, so callers never need a separate serial code path.
+ */
+class WorkerPool {
+ public:
+  /**
+   * @brief Start a pool.
+   * @param threadCount Total threads including the caller; 1 runs everything inline.
+   * @throws std::invalid_argument when threadCount is not positive.
+   */
+  explicit WorkerPool(int threadCount);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /// @return Threads that run tasks, including the calling thread.
+  int ThreadCount() const { return static_cast<int>(threads_.size()) + 1; }
+
+  /**
+   * @brief Run fn(task) for every task in [0, taskCount) and wait for all of them.
+   * @param taskCount Number of tasks.
+   * @param fn Callable taking a task index; must not throw.
+   * @note Tasks are claimed dynamically, so their order across threads is unspecified.
+   * Does not allocate.
+   */
+  template <typename Fn>
+  void ParallelFor(std::size_t taskCount, Fn&& fn) {
+    using Callable = std::remove_reference_t<Fn>;
+    Run(taskCount, TaskRef{
+                       .context = const_cast<void*>(static_cast<const void*>(&fn)),
+                       .invoke = [](void* context, std::size_t task) { (*static_cast<Callable*>(context))(task); },
+                   });
+  }
+
+ private:
+  /**
+   * @brief Non-owning type-erased reference to the active task callable.
+   */
+  struct TaskRef {
+    void* context = nullptr;
+    void (*invoke)(void*, std::size_t) = nullptr;
+  };
+
+  void Run(std::size_t taskCount, TaskRef task);
+  void WorkerLoop();
+  void DrainTasks();
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  TaskRef task_;
+  std::size_t taskCount_ = 0;
+  std::atomic<std::size_t> nextTask_{0};
+  std::size_t busyWorkers_ = 0;
+  std::uint64_t generation_ = 0;
+  bool stopping_ = false;
+};
+
+}  // namespace slam::core
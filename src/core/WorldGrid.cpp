@@ -6,9 +6,63 @@
 #include "core/WorldGrid.h"
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
 namespace slam::core {
+namespace {
+
+/**
+ * @brief One-dimensional squared distance transform (Felzenszwalb-Huttenlocher).
+ * @param input Squared distances sampled at integer positions.
+ * @param output Lower envelope of parabolas rooted at each input sample.
+ * @param vertices Scratch buffer for parabola vertices, sized input.size().
+ * @param bounds Scratch buffer for envelope boundaries, sized input.size() + 1.
+ */
+void DistanceTransform1D(
+    const std::vector<double>& input,
+    std::vector<double>& output,
+    std::vector<int>& vertices,
+    std::vector<double>& bounds) {
+  constexpr double kInfinity = std::numeric_limits<double>::infinity();
+  const int count = static_cast<int>(input.size());
+  int envelope = 0;
+  vertices[0] = 0;
+  bounds[0] = -kInfinity;
+  bounds[1] = kInfinity;
+  for (int q = 1; q < count; ++q) {
+    const auto intersection = [&](int v) {
+      const double dq = static_cast<double>(q);
+      const double dv = static_cast<double>(v);
+      return ((input[static_cast<std::size_t>(q)] + dq * dq) -
+              (input[static_cast<std::size_t>(v)] + dv * dv)) /
+             (2.0 * dq - 2.0 * dv);
+    };
+    double s = intersection(vertices[static_cast<std::size_t>(envelope)]);
+    while (s <= bounds[static_cast<std::size_t>(envelope)]) {
+      --envelope;
+      s = intersection(vertices[static_cast<std::size_t>(envelope)]);
+    }
+    ++envelope;
+    vertices[static_cast<std::size_t>(envelope)] = q;
+    bounds[static_cast<std::size_t>(envelope)] = s;
+    bounds[static_cast<std::size_t>(envelope + 1)] = kInfinity;
+  }
+
+  envelope = 0;
+  for (int q = 0; q < count; ++q) {
+    while (bounds[static_cast<std::size_t>(envelope + 1)] < static_cast<double>(q)) {
+      ++envelope;
+    }
+    const int v = vertices[static_cast<std::size_t>(envelope)];
+    const double delta = static_cast<double>(q - v);
+    output[static_cast<std::size_t>(q)] = delta * delta + input[static_cast<std::size_t>(v)];
+  }
+}
+
+}  // namespace
 
 /**
  * @brief Construct an empty obstacle grid.
@@ -18,10 +72,16 @@ namespace slam::core {
 WorldGrid::WorldGrid(int width, int height)
     : width_(width),
       height_(height),
-      obstacles_(static_cast<std::size_t>(std::max(width, 0) * std::max(height, 0)), 0U) {
+      wordsPerRow_((std::max(width, 0) + 2 + 63) / 64),
+      words_(static_cast<std::size_t>(wordsPerRow_ * (std::max(height, 0) + 2)), ~std::uint64_t{0}) {
   if (width <= 0 || height <= 0) {
     throw std::invalid_argument("WorldGrid dimensions must be positive");
   }
+  clearanceIndexer_ = GridIndexer(MapLayout::kRowMajor, width, height);
+  // Start fully blocked, then open the interior so the guard ring stays set.
+  for (int y = 0; y < height_; ++y) {
+    FillPaddedSpan(y + 1, 1, width_ + 1, false);
+  }
 }
 
 /**
@@ -57,7 +117,9 @@ void WorldGrid::SetObstacle(int x, int y) {
   if (!InBounds(x, y)) {
     return;
   }
-  obstacles_[static_cast<std::size_t>(Index(x, y))] = 1U;
+  const int paddedX = x + 1;
+  words_[static_cast<std::size_t>((y + 1) * wordsPerRow_ + (paddedX >> 6))] |= std::uint64_t{1} << (paddedX & 63);
+  clearance_.clear();
 }
 
 /**
@@ -68,30 +130,181 @@ void WorldGrid::AddRectangle(int x, int y, int width, int height) {
   const int yStart = std::max(0, y);
   const int xEnd = std::min(width_, x + width);
   const int yEnd = std::min(height_, y + height);
+  if (xStart >= xEnd || yStart >= yEnd) {
+    return;
+  }
 
   for (int row = yStart; row < yEnd; ++row) {
-    for (int col = xStart; col < xEnd; ++col) {
-      SetObstacle(col, row);
-    }
+    FillPaddedSpan(row + 1, xStart + 1, xEnd + 1, true);
   }
+  clearance_.clear();
 }
 
 /**
  * @brief Return whether a cell is blocked.
- * @note Out-of-bounds coordinates are treated as obstacles.
+ * @note Out-of-bounds coordinates clamp onto the blocked guard ring.
  */
 bool WorldGrid::IsObstacle(int x, int y) const {
-  if (!InBounds(x, y)) {
-    return true;
+  const int paddedX = std::clamp(x, -1, width_) + 1;
+  const int paddedY = std::clamp(y, -1, height_) + 1;
+  const std::uint64_t word = words_[static_cast<std::size_t>(paddedY * wordsPerRow_ + (paddedX >> 6))];
+  return ((word >> (paddedX & 63)) & 1U) != 0U;
+}
+
+/**
+ * @brief Find the first blocked cell in a row span using count-trailing-zeros.
+ */
+int WorldGrid::FirstObstacleInRow(int y, int xBegin, int xEnd) const {
+  if (xBegin >= xEnd) {
+    return xEnd;
+  }
+  if (y < 0 || y >= height_ || xBegin < 0 || xBegin > width_) {
+    return xBegin;
   }
-  return obstacles_[static_cast<std::size_t>(Index(x, y))] != 0U;
+
+  // The right guard column (x == width_) terminates every search inside the row.
+  const int paddedBegin = xBegin + 1;
+  const int paddedEnd = std::min(xEnd, width_ + 1) + 1;
+  const std::uint64_t* row = words_.data() + static_cast<std::size_t>((y + 1) * wordsPerRow_);
+  int wordIndex = paddedBegin >> 6;
+  std::uint64_t bits = row[wordIndex] & (~std::uint64_t{0} << (paddedBegin & 63));
+  while (bits == 0U) {
+    ++wordIndex;
+    if (wordIndex * 64 >= paddedEnd) {
+      return xEnd;
+    }
+    bits = row[wordIndex];
+  }
+  const int paddedX = wordIndex * 64 + std::countr_zero(bits);
+  return (paddedX < paddedEnd) ? paddedX - 1 : xEnd;
 }
 
 /**
- * @brief Convert a 2D coordinate to row-major index.
+ * @brief Find the last blocked cell in a row span using count-leading-zeros.
  */
-int WorldGrid::Index(int x, int y) const {
-  return y * width_ + x;
+int WorldGrid::LastObstacleInRow(int y, int xBegin, int xEnd) const {
+  if (xBegin >= xEnd) {
+    return xBegin - 1;
+  }
+  const int xLast = xEnd - 1;
+  if (y < 0 || y >= height_ || xLast < 0 || xLast >= width_) {
+    return xLast;
+  }
+
+  // The left guard column (x == -1) terminates every search inside the row.
+  const int paddedBegin = std::max(xBegin, -1) + 1;
+  const int paddedLast = xLast + 1;
+  const std::uint64_t* row = words_.data() + static_cast<std::size_t>((y + 1) * wordsPerRow_);
+  int wordIndex = paddedLast >> 6;
+  std::uint64_t bits = row[wordIndex] & (~std::uint64_t{0} >> (63 - (paddedLast & 63)));
+  while (bits == 0U) {
+    --wordIndex;
+    if (wordIndex < 0 || wordIndex * 64 + 63 < paddedBegin) {
+      return xBegin - 1;
+    }
+    bits = row[wordIndex];
+  }
+  const int paddedX = wordIndex * 64 + 63 - std::countl_zero(bits);
+  return (paddedX >= paddedBegin) ? paddedX - 1 : xBegin - 1;
+}
+
+/**
+ * @brief Build the clearance field with a separable exact Euclidean distance transform.
+ * @note The grid is padded by one obstacle ring so out-of-bounds space counts as blocked.
+ */
+void WorldGrid::BuildDistanceField() {
+  // Finite stand-in for "no obstacle yet" keeps the parabola intersections well-defined.
+  constexpr double kFar = 1e20;
+  const int paddedWidth = width_ + 2;
+  const int paddedHeight = height_ + 2;
+  std::vector<double> squared(static_cast<std::size_t>(paddedWidth * paddedHeight), 0.0);
+  for (int y = 0; y < height_; ++y) {
+    for (int x = 0; x < width_; ++x) {
+      squared[static_cast<std::size_t>((y + 1) * paddedWidth + (x + 1))] = IsObstacle(x, y) ? 0.0 : kFar;
+    }
+  }
+
+  const int longest = std::max(paddedWidth, paddedHeight);
+  std::vector<double> input(static_cast<std::size_t>(longest));
+  std::vector<double> output(static_cast<std::size_t>(longest));
+  std::vector<int> vertices(static_cast<std::size_t>(longest));
+  std::vector<double> bounds(static_cast<std::size_t>(longest + 1));
+
+  input.resize(static_cast<std::size_t>(paddedHeight));
+  output.resize(static_cast<std::size_t>(paddedHeight));
+  for (int x = 0; x < paddedWidth; ++x) {
+    for (int y = 0; y < paddedHeight; ++y) {
+      input[static_cast<std::size_t>(y)] = squared[static_cast<std::size_t>(y * paddedWidth + x)];
+    }
+    DistanceTransform1D(input, output, vertices, bounds);
+    for (int y = 0; y < paddedHeight; ++y) {
+      squared[static_cast<std::size_t>(y * paddedWidth + x)] = output[static_cast<std::size_t>(y)];
+    }
+  }
+
+  input.resize(static_cast<std::size_t>(paddedWidth));
+  output.resize(static_cast<std::size_t>(paddedWidth));
+  clearance_.assign(clearanceIndexer_.StorageSize(), 0.0F);
+  for (int y = 1; y <= height_; ++y) {
+    const std::size_t rowStart = static_cast<std::size_t>(y * paddedWidth);
+    std::copy(squared.begin() + static_cast<std::ptrdiff_t>(rowStart),
+              squared.begin() + static_cast<std::ptrdiff_t>(rowStart + static_cast<std::size_t>(paddedWidth)),
+              input.begin());
+    DistanceTransform1D(input, output, vertices, bounds);
+    for (int x = 1; x <= width_; ++x) {
+      clearance_[Index(x - 1, y - 1)] =
+          static_cast<float>(std::sqrt(output[static_cast<std::size_t>(x)]));
+    }
+  }
+}
+
+/**
+ * @brief Read the clearance of a cell.
+ */
+double WorldGrid::ClearanceAt(int x, int y) const {
+  if (clearance_.empty() || !InBounds(x, y)) {
+    return 0.0;
+  }
+  return static_cast<double>(clearance_[Index(x, y)]);
+}
+
+/**
+ * @brief Move the clearance field into another memory order.
+ * @param layout Target layout.
+ */
+void WorldGrid::SetLayout(MapLayout layout) {
+  if (layout == clearanceIndexer_.Layout()) {
+    return;
+  }
+  const GridIndexer target(layout, width_, height_);
+  if (!clearance_.empty()) {
+    std::vector<float> moved(target.StorageSize(), 0.0F);
+    for (int y = 0; y < height_; ++y) {
+      for (int x = 0; x < width_; ++x) {
+        moved[target.Index(x, y)] = clearance_[Index(x, y)];
+      }
+    }
+    clearance_.swap(moved);
+  }
+  clearanceIndexer_ = target;
+}
+
+/**
+ * @brief Set or clear padded-column bits of one padded row with per-word masks.
+ */
+void WorldGrid::FillPaddedSpan(int paddedY, int paddedBegin, int paddedEnd, bool blocked) {
+  std::uint64_t* row = words_.data() + static_cast<std::size_t>(paddedY * wordsPerRow_);
+  while (paddedBegin < paddedEnd) {
+    const int bit = paddedBegin & 63;
+    const int count = std::min(64 - bit, paddedEnd - paddedBegin);
+    const std::uint64_t mask = (count == 64) ? ~std::uint64_t{0} : (((std::uint64_t{1} << count) - 1U) << bit);
+    if (blocked) {
+      row[paddedBegin >> 6] |= mask;
+    } else {
+      row[paddedBegin >> 6] &= ~mask;
+    }
+    paddedBegin += count;
+  }
 }
 
 }  // namespace slam::core
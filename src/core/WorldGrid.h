@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include "core/GridIndexer.h"
+#include "core/Types.h"
+
 /**
  * @file WorldGrid.h
  * @brief Ground-truth obstacle grid utilities.
@@ -12,6 +16,9 @@ namespace slam::core {
 
 /**
  * @brief Obstacle grid used as the simulated environment.
+ * @note Cells are stored as one bit each in 64-bit words. Each row carries a blocked
+ * guard column on both sides and the grid has a blocked guard row above and below, so
+ * out-of-bounds reads resolve to obstacles by clamping instead of branching.
  */
 class WorldGrid {
  public:
@@ -46,23 +53,78 @@ class WorldGrid {
    * @brief Return true if the cell is blocked or outside the grid.
    */
   bool IsObstacle(int x, int y) const;
+  /**
+   * @brief Find the first blocked cell scanning a row span left to right.
+   * @param y Row to scan.
+   * @param xBegin First column (inclusive).
+   * @param xEnd Last column (exclusive).
+   * @return Column of the first blocked cell, or xEnd when the span is clear.
+   * @note Out-of-bounds cells count as blocked, like IsObstacle.
+   */
+  int FirstObstacleInRow(int y, int xBegin, int xEnd) const;
+  /**
+   * @brief Find the last blocked cell scanning a row span right to left.
+   * @param y Row to scan.
+   * @param xBegin First column (inclusive).
+   * @param xEnd Last column (exclusive).
+   * @return Column of the last blocked cell, or xBegin - 1 when the span is clear.
+   */
+  int LastObstacleInRow(int y, int xBegin, int xEnd) const;
+
+  /**
+   * @brief Compute the Euclidean distance transform of the obstacle layout.
+   * @note Call once after the world is fully built; any later obstacle edit drops the field.
+   */
+  void BuildDistanceField();
+  /// @return True when the distance field matches the current obstacle layout.
+  bool HasDistanceField() const { return !clearance_.empty(); }
+  /**
+   * @brief Distance from a cell center to the nearest obstacle cell center.
+   * @return Clearance in grid units; 0 for blocked/out-of-bounds cells or when no field is built.
+   * @note Cells outside the grid count as obstacles, like IsObstacle.
+   */
+  double ClearanceAt(int x, int y) const;
+  /**
+   * @brief Choose the memory order of the clearance field, moving a built field over.
+   * @param layout MapLayout::kRowMajor, MapLayout::kTiled, or MapLayout::kMorton.
+   * @note Sphere tracing reads one clearance per step along beams in every direction, so a
+   * 2D-local order keeps those reads within fewer cache lines. The obstacle bits stay
+   * row-major: a word already covers 64 cells, and the row queries and the batched ray
+   * march address words by row.
+   */
+  void SetLayout(MapLayout layout);
+  /// @return Memory order of the clearance field.
+  MapLayout Layout() const { return clearanceIndexer_.Layout(); }
 
   /// @return Grid width in cells.
   int Width() const { return width_; }
   /// @return Grid height in cells.
   int Height() const { return height_; }
-  /// @return Raw obstacle buffer in row-major order.
-  const std::vector<std::uint8_t>& ObstacleData() const { return obstacles_; }
+  /// @return Packed obstacle bits, row-major with guard cells (see WordsPerRow).
+  const std::vector<std::uint64_t>& ObstacleWords() const { return words_; }
+  /// @return Number of 64-bit words per padded row.
+  int WordsPerRow() const { return wordsPerRow_; }
 
  private:
   /**
-   * @brief Convert 2D coordinate to row-major index.
+   * @brief Convert 2D coordinate to a clearance-field index in the current layout.
+   */
+  std::size_t Index(int x, int y) const { return clearanceIndexer_.Index(x, y); }
+  /**
+   * @brief Set or clear a span of padded-column bits in one padded row, a word at a time.
+   * @param paddedY Padded row index.
+   * @param paddedBegin First padded column (inclusive).
+   * @param paddedEnd Last padded column (exclusive).
+   * @param blocked True to mark obstacles, false to clear them.
    */
-  int Index(int x, int y) const;
+  void FillPaddedSpan(int paddedY, int paddedBegin, int paddedEnd, bool blocked);
 
   int width_ = 0;
   int height_ = 0;
-  std::vector<std::uint8_t> obstacles_;
+  int wordsPerRow_ = 0;
+  std::vector<std::uint64_t> words_;
+  GridIndexer clearanceIndexer_;
+  std::vector<float> clearance_;
 };
 
 }  // namespace slam::core
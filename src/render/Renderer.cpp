@@ -6,6 +6,7 @@
 #include "render/Renderer.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 
 namespace slam::render {
@@ -14,13 +15,9 @@ namespace slam::render {
  * @brief Draw ground-truth world obstacles.
  */
 void DrawWorld(const core::WorldGrid& world, int cellSize, int offsetX) {
-  const auto& obstacles = world.ObstacleData();
   for (int y = 0; y < world.Height(); ++y) {
     for (int x = 0; x < world.Width(); ++x) {
-      const int index = y * world.Width() + x;
-      const Color color = obstacles[static_cast<std::size_t>(index)] != 0U
-                              ? Palette::kWorldObstacle
-                              : Palette::kBackground;
+      const Color color = world.IsObstacle(x, y) ? Palette::kWorldObstacle : Palette::kBackground;
       DrawRectangle(offsetX + x * cellSize, y * cellSize, cellSize, cellSize, color);
     }
   }
@@ -30,15 +27,71 @@ void DrawWorld(const core::WorldGrid& world, int cellSize, int offsetX) {
  * @brief Draw reconstructed occupancy map.
  */
 void DrawMap(const core::OccupancyGridMap& map, int cellSize, int offsetX) {
-  for (int y = 0; y < map.Height(); ++y) {
-    for (int x = 0; x < map.Width(); ++x) {
-      const auto value = map.ValueAt(x, y);
+  DrawMapRegion(map, cellSize, offsetX, core::GridRect{.xBegin = 0, .yBegin = 0, .xEnd = map.Width(), .yEnd = map.Height()});
+}
+
+/**
+ * @brief Draw the occupancy map cells inside one rectangle.
+ */
+void DrawMapRegion(const core::OccupancyGridMap& map, int cellSize, int offsetX, const core::GridRect& region) {
+  for (int y = region.yBegin; y < region.yEnd; ++y) {
+    for (int x = region.xBegin; x < region.xEnd; ++x) {
+      const auto value = map.ClassifiedValueAt(x, y);
       const Color color = (value == core::kOccupied) ? Palette::kMapObstacle : Palette::kBackground;
       DrawRectangle(offsetX + x * cellSize, y * cellSize, cellSize, cellSize, color);
     }
   }
 }
 
+/**
+ * @brief Draw occupied cells of a sparse map's allocated chunks that fall inside a view.
+ * @note The view is cleared to background once; unknown space is never visited.
+ */
+void DrawSparseMap(const core::SparseOccupancyGridMap& map, int cellSize, int offsetX, const core::GridRect& view) {
+  DrawRectangle(offsetX, 0, (view.xEnd - view.xBegin) * cellSize, (view.yEnd - view.yBegin) * cellSize,
+                Palette::kBackground);
+  constexpr int kChunkSize = core::SparseOccupancyGridMap::kChunkSize;
+  map.ForEachChunk([&](const core::SparseOccupancyGridMap::ChunkView& chunk) {
+    const int chunkLeft = chunk.chunkX * kChunkSize;
+    const int chunkTop = chunk.chunkY * kChunkSize;
+    const int xBegin = std::max(view.xBegin, chunkLeft);
+    const int xEnd = std::min(view.xEnd, chunkLeft + kChunkSize);
+    const int yBegin = std::max(view.yBegin, chunkTop);
+    const int yEnd = std::min(view.yEnd, chunkTop + kChunkSize);
+    for (int y = yBegin; y < yEnd; ++y) {
+      for (int x = xBegin; x < xEnd; ++x) {
+        const std::int16_t value =
+            chunk.cells[static_cast<std::size_t>((y - chunkTop) * kChunkSize + (x - chunkLeft))];
+        if (map.Classify(value) == core::kOccupied) {
+          DrawRectangle(offsetX + (x - view.xBegin) * cellSize, (y - view.yBegin) * cellSize, cellSize, cellSize,
+                        Palette::kMapObstacle);
+        }
+      }
+    }
+  });
+}
+
+/**
+ * @brief Expand a packed map to Palette colors; unknown and free cells share the background.
+ */
+void ExpandPackedMapToPixels(const core::PackedOccupancyGridMap& map, std::vector<Color>& pixels) {
+  static_assert(sizeof(Color) == 4, "Color must be four packed RGBA bytes");
+  constexpr auto rgba = [](Color color) { return std::array<std::uint8_t, 4>{color.r, color.g, color.b, color.a}; };
+  constexpr core::PackedOccupancyGridMap::RgbaPalette kPalette{
+      rgba(Palette::kBackground), rgba(Palette::kBackground), rgba(Palette::kMapObstacle)};
+  pixels.resize(static_cast<std::size_t>(map.Width()) * static_cast<std::size_t>(map.Height()));
+  map.ExpandToRgba(kPalette,
+                   std::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(pixels.data()), pixels.size() * sizeof(Color)));
+}
+
+/**
+ * @brief Expand a packed map and replace the texture contents with it.
+ */
+void UploadPackedMap(const core::PackedOccupancyGridMap& map, Texture2D texture, std::vector<Color>& pixels) {
+  ExpandPackedMapToPixels(map, pixels);
+  UpdateTexture(texture, pixels.data());
+}
+
 /**
  * @brief Convert scan samples to pixel-space ray endpoints.
  */
@@ -47,10 +100,24 @@ std::vector<PixelRay> ScanSamplesToPixels(
     const std::vector<core::ScanSample>& scan,
     int cellSize,
     int offsetX) {
+  std::vector<PixelRay> output;
+  ScanSamplesToPixels(pose, std::span<const core::ScanSample>(scan), cellSize, offsetX, output);
+  return output;
+}
+
+/**
+ * @brief Convert scan samples to pixel-space ray endpoints into reusable storage.
+ */
+void ScanSamplesToPixels(
+    const core::RobotPose& pose,
+    std::span<const core::ScanSample> scan,
+    int cellSize,
+    int offsetX,
+    std::vector<PixelRay>& output) {
   const Vector2 origin{
       static_cast<float>(static_cast<int>(pose.x * static_cast<double>(cellSize)) + offsetX),
       static_cast<float>(static_cast<int>(pose.y * static_cast<double>(cellSize)))};
-  std::vector<PixelRay> output;
+  output.clear();
   output.reserve(scan.size());
 
   for (const core::ScanSample& sample : scan) {
@@ -63,8 +130,31 @@ std::vector<PixelRay> ScanSamplesToPixels(
         .hit = sample.hit,
     });
   }
+}
 
-  return output;
+/**
+ * @brief Convert struct-of-arrays scan endpoints to pixel-space rays into reusable storage.
+ */
+void ScanSamplesToPixels(
+    const core::RobotPose& pose,
+    const core::ScanBuffer& scan,
+    int cellSize,
+    int offsetX,
+    std::vector<PixelRay>& output) {
+  const Vector2 origin{
+      static_cast<float>(static_cast<int>(pose.x * static_cast<double>(cellSize)) + offsetX),
+      static_cast<float>(static_cast<int>(pose.y * static_cast<double>(cellSize)))};
+  const std::span<const double> endX = scan.EndX();
+  const std::span<const double> endY = scan.EndY();
+  const double scale = static_cast<double>(cellSize);
+  output.resize(scan.Size());
+
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    output[i].start = origin;
+    output[i].end = {static_cast<float>(static_cast<int>(endX[i] * scale) + offsetX),
+                     static_cast<float>(static_cast<int>(endY[i] * scale))};
+    output[i].hit = scan.Hit(i);
+  }
 }
 
 /**
@@ -91,11 +181,11 @@ std::vector<Vector2> UpdateHitPointHistory(
   return merged;
 }
 
-bool TryMarkHitPixel(std::vector<unsigned char>& occupancy, int width, int height, Vector2 point) {
+bool TryMarkHitPixel(HitPixelCache& occupancy, int width, int height, Vector2 point) {
   if (width <= 0 || height <= 0) {
     return false;
   }
-  if (occupancy.size() < static_cast<std::size_t>(width * height)) {
+  if (occupancy.Size() < static_cast<std::size_t>(width) * static_cast<std::size_t>(height)) {
     return false;
   }
 
@@ -105,12 +195,7 @@ bool TryMarkHitPixel(std::vector<unsigned char>& occupancy, int width, int heigh
     return false;
   }
 
-  const std::size_t index = static_cast<std::size_t>(y * width + x);
-  if (occupancy[index] != 0U) {
-    return false;
-  }
-  occupancy[index] = 1U;
-  return true;
+  return occupancy.Mark(static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x));
 }
 
 }  // namespace slam::render
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
 #include <vector>
 
 #include <raylib.h>
 
+#include "core/EpochMarks.h"
 #include "core/OccupancyGridMap.h"
+#include "core/PackedOccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SparseOccupancyGridMap.h"
 #include "core/Types.h"
 #include "core/WorldGrid.h"
 
@@ -45,9 +51,29 @@ struct Palette {
  */
 void DrawWorld(const core::WorldGrid& world, int cellSize, int offsetX);
 /**
- * @brief Draw the reconstructed occupancy map.
+ * @brief Draw the reconstructed occupancy map, thresholded with ClassifiedValueAt().
  */
 void DrawMap(const core::OccupancyGridMap& map, int cellSize, int offsetX);
+/**
+ * @brief Redraw only the map cells inside a rectangle, e.g. one from ConsumeDirtyRegions().
+ */
+void DrawMapRegion(const core::OccupancyGridMap& map, int cellSize, int offsetX, const core::GridRect& region);
+/**
+ * @brief Draw the part of a sparse map inside a cell rectangle, visiting only allocated chunks.
+ * @param view Map cells shown; view.xBegin/view.yBegin lands at pixel (offsetX, 0).
+ */
+void DrawSparseMap(const core::SparseOccupancyGridMap& map, int cellSize, int offsetX, const core::GridRect& view);
+/**
+ * @brief Expand a packed map to one Palette color per cell, in DrawMap() colors.
+ * @param pixels Resized to Width() * Height() and filled row-major.
+ */
+void ExpandPackedMapToPixels(const core::PackedOccupancyGridMap& map, std::vector<Color>& pixels);
+/**
+ * @brief Upload a packed map into a texture of one texel per cell.
+ * @param texture RGBA8 texture of map.Width() x map.Height() texels.
+ * @param pixels Reusable staging buffer for the expanded colors.
+ */
+void UploadPackedMap(const core::PackedOccupancyGridMap& map, Texture2D texture, std::vector<Color>& pixels);
 /**
  * @brief Convert scan samples to pixel-space rays.
  */
@@ -56,6 +82,26 @@ std::vector<PixelRay> ScanSamplesToPixels(
     const std::vector<core::ScanSample>& scan,
     int cellSize,
     int offsetX);
+/**
+ * @brief Convert scan samples to pixel-space rays, reusing the output capacity.
+ * @param output Destination rays; cleared and refilled with one ray per sample.
+ */
+void ScanSamplesToPixels(
+    const core::RobotPose& pose,
+    std::span<const core::ScanSample> scan,
+    int cellSize,
+    int offsetX,
+    std::vector<PixelRay>& output);
+/**
+ * @brief Convert a struct-of-arrays scan to pixel-space rays from its stored endpoints.
+ * @param output Destination rays; cleared and refilled with one ray per beam.
+ */
+void ScanSamplesToPixels(
+    const core::RobotPose& pose,
+    const core::ScanBuffer& scan,
+    int cellSize,
+    int offsetX,
+    std::vector<PixelRay>& output);
 /**
  * @brief Update green-hit history in live or accumulate mode.
  */
@@ -64,14 +110,19 @@ std::vector<Vector2> UpdateHitPointHistory(
     const std::vector<Vector2>& currentHits,
     bool accumulate);
 
+/**
+ * @brief Per-pixel "hit already drawn" flags; Clear() is a counter bump, not a window-sized fill.
+ */
+using HitPixelCache = core::EpochMarks<std::uint8_t>;
+
 /**
  * @brief Mark a pixel-space hit in occupancy grid if not previously present.
- * @param occupancy Mutable occupancy buffer sized width*height.
+ * @param occupancy Hit cache sized width*height.
  * @param width Pixel width.
  * @param height Pixel height.
  * @param point Pixel-space point.
  * @return True when point was newly marked; false when out of bounds or duplicate.
  */
-bool TryMarkHitPixel(std::vector<unsigned char>& occupancy, int width, int height, Vector2 point);
+bool TryMarkHitPixel(HitPixelCache& occupancy, int width, int height, Vector2 point);
 
 }  // namespace slam::render
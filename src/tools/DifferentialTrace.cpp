@@ -10,6 +10,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -18,6 +19,7 @@
 
 #include "app/AssetPaths.h"
 #include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
 #include "core/SimulatedLidar.h"
 #include "core/Types.h"
 #include "input/Motion.h"
@@ -222,33 +224,44 @@ int CountChangedPixels(const FrameBuffer& previous, const FrameBuffer& current)
 }
 
 /**
- * @brief Render one simulation frame into an RGB framebuffer.
+ * @brief Repaint the map cells changed since the last call into a persistent map layer.
+ * @param layer RGB layer holding only map obstacles over black.
+ * @param regions Scratch storage for the consumed dirty regions.
  */
-FrameBuffer RenderSimulationFrame(
-    const slam::core::OccupancyGridMap& map,
-    const slam::core::RobotPose& pose,
-    const std::vector<slam::core::ScanSample>& scan) {
-  FrameBuffer frame(static_cast<std::size_t>(kImageWidth * kImageHeight * 3), 0);
-
-  for (int y = 0; y < map.Height(); ++y) {
-    for (int x = 0; x < map.Width(); ++x) {
-      if (map.ValueAt(x, y) == slam::core::kOccupied) {
-        DrawRect(frame, x * kCellSize, y * kCellSize, kCellSize, kCellSize, kMapObstacle);
+void UpdateMapLayer(FrameBuffer& layer, slam::core::OccupancyGridMap& map, std::vector<slam::core::GridRect>& regions) {
+  map.ConsumeDirtyRegions(regions);
+  for (const slam::core::GridRect& region : regions) {
+    for (int y = region.yBegin; y < region.yEnd; ++y) {
+      for (int x = region.xBegin; x < region.xEnd; ++x) {
+        const Rgb color = (map.ClassifiedValueAt(x, y) == slam::core::kOccupied) ? kMapObstacle : Rgb{};
+        DrawRect(layer, x * kCellSize, y * kCellSize, kCellSize, kCellSize, color);
       }
     }
   }
+}
+
+/**
+ * @brief Render one simulation frame into an RGB framebuffer.
+ * @param mapLayer Map obstacles kept current by UpdateMapLayer(); copied as the frame base.
+ */
+FrameBuffer RenderSimulationFrame(
+    const FrameBuffer& mapLayer,
+    const slam::core::RobotPose& pose,
+    const slam::core::ScanBuffer& scan) {
+  FrameBuffer frame = mapLayer;
 
   const int originX = static_cast<int>(pose.x * static_cast<double>(kCellSize));
   const int originY = static_cast<int>(pose.y * static_cast<double>(kCellSize));
   std::vector<std::pair<int, int>> currentHits;
-  currentHits.reserve(scan.size());
+  currentHits.reserve(scan.HitCount());
 
-  for (const slam::core::ScanSample& sample : scan) {
-    const double absoluteAngle = pose.theta + sample.relativeAngle;
-    const int endX = static_cast<int>((pose.x + std::cos(absoluteAngle) * sample.distance) * static_cast<double>(kCellSize));
-    const int endY = static_cast<int>((pose.y + std::sin(absoluteAngle) * sample.distance) * static_cast<double>(kCellSize));
+  const std::span<const double> worldEndX = scan.EndX();
+  const std::span<const double> worldEndY = scan.EndY();
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    const int endX = static_cast<int>(worldEndX[i] * static_cast<double>(kCellSize));
+    const int endY = static_cast<int>(worldEndY[i] * static_cast<double>(kCellSize));
     DrawLine(frame, originX, originY, endX, endY, kLaser);
-    if (sample.hit) {
+    if (scan.Hit(i)) {
       currentHits.emplace_back(endX, endY);
     }
   }
@@ -325,8 +338,11 @@ int main(int argc, char** argv) {
     slam::core::OccupancyGridMap map(kWorldWidth, kWorldHeight);
     slam::core::SimulatedLidar lidar(30.0, 72, 1.0);
     slam::core::RobotPose pose{10.0, 10.0, 0.0};
+    slam::core::ScanBuffer scan(lidar.BeamCount());
 
     FrameBuffer previousFrame(static_cast<std::size_t>(kImageWidth * kImageHeight * 3), 0);
+    FrameBuffer mapLayer(previousFrame.size(), 0);
+    std::vector<slam::core::GridRect> dirtyRegions;
 
     for (std::size_t frameIndex = 0; frameIndex < sequence.size(); ++frameIndex) {
       const std::string& token = sequence[frameIndex];
@@ -344,10 +360,11 @@ int main(int argc, char** argv) {
         }
       }
 
-      const std::vector<slam::core::ScanSample> scan = lidar.Scan(world, pose);
+      lidar.Scan(world, pose, scan);
       map.IntegrateScan(pose, scan);
 
-      const FrameBuffer frame = RenderSimulationFrame(map, pose, scan);
+      UpdateMapLayer(mapLayer, map, dirtyRegions);
+      const FrameBuffer frame = RenderSimulationFrame(mapLayer, pose, scan);
       const int changedPixels = CountChangedPixels(previousFrame, frame);
       const std::uint64_t hash = Fnv1a64(frame);
 
@@ -0,0 +1,180 @@
+/**
+ * @file LidarBenchmark.cpp
+ * @brief Offline throughput benchmark for simulated lidar beam casting modes.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+constexpr int kWorldWidth = 120;
+constexpr int kWorldHeight = 80;
+constexpr double kMaxRange = 30.0;
+constexpr double kStepSize = 1.0;
+constexpr int kPoseCount = 64;
+
+/**
+ * @brief One benchmarked lidar configuration.
+ */
+struct BenchCase {
+  const char* name = "";
+  slam::core::LidarMode mode = slam::core::LidarMode::kRayMarch;
+};
+
+/**
+ * @brief One benchmarked world layout.
+ */
+struct BenchWorld {
+  const char* name = "";
+  slam::core::WorldGrid grid;
+};
+
+/**
+ * @brief Build the demo world layout without the raylib-backed world loader.
+ */
+slam::core::WorldGrid BuildDemoLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(80, 55, 18, 10);
+  world.BuildDistanceField();
+  return world;
+}
+
+/**
+ * @brief Build an empty bordered world.
+ */
+slam::core::WorldGrid BuildOpenLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  world.BuildDistanceField();
+  return world;
+}
+
+/**
+ * @brief Build a bordered world scattered with small random blocks.
+ */
+slam::core::WorldGrid BuildClutteredLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  std::mt19937 rng(42U);
+  std::uniform_int_distribution<int> xDist(1, kWorldWidth - 2);
+  std::uniform_int_distribution<int> yDist(1, kWorldHeight - 2);
+  std::uniform_int_distribution<int> sizeDist(1, 3);
+  for (int i = 0; i < 320; ++i) {
+    world.AddRectangle(xDist(rng), yDist(rng), sizeDist(rng), sizeDist(rng));
+  }
+  world.BuildDistanceField();
+  return world;
+}
+
+/**
+ * @brief Sample deterministic collision-free poses inside the world.
+ */
+std::vector<slam::core::RobotPose> SampleFreePoses(const slam::core::WorldGrid& world, int count) {
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> xDist(1.0, static_cast<double>(world.Width() - 1));
+  std::uniform_real_distribution<double> yDist(1.0, static_cast<double>(world.Height() - 1));
+  std::uniform_real_distribution<double> thetaDist(-3.14159265358979323846, 3.14159265358979323846);
+
+  std::vector<slam::core::RobotPose> poses;
+  poses.reserve(static_cast<std::size_t>(count));
+  while (static_cast<int>(poses.size()) < count) {
+    const slam::core::RobotPose pose{xDist(rng), yDist(rng), thetaDist(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      poses.push_back(pose);
+    }
+  }
+  return poses;
+}
+
+/**
+ * @brief Measure beams per second for one lidar configuration.
+ */
+void RunCase(
+    const BenchCase& benchCase,
+    const BenchWorld& world,
+    const std::vector<slam::core::RobotPose>& poses,
+    int beamCount,
+    double minSeconds) {
+  const slam::core::SimulatedLidar lidar(kMaxRange, beamCount, kStepSize, benchCase.mode);
+  using Clock = std::chrono::steady_clock;
+
+  long long beams = 0;
+  double checksum = 0.0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < minSeconds) {
+    for (const slam::core::RobotPose& pose : poses) {
+      for (const slam::core::ScanSample& sample : lidar.Scan(world.grid, pose)) {
+        checksum += sample.distance;
+      }
+      beams += beamCount;
+    }
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  std::cout << "{\"world\":\"" << world.name << "\""
+            << ",\"mode\":\"" << benchCase.name << "\""
+            << ",\"beams\":" << beamCount
+            << ",\"beams_per_sec\":" << std::fixed << std::setprecision(0) << static_cast<double>(beams) / elapsed
+            << ",\"checksum\":" << std::setprecision(3) << checksum
+            << "}\n";
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Lidar benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const std::vector<BenchWorld> worlds = {
+      {"open", BuildOpenLayout()},
+      {"demo", BuildDemoLayout()},
+      {"cluttered", BuildClutteredLayout()},
+  };
+  const std::vector<BenchCase> cases = {
+      {"ray-march", slam::core::LidarMode::kRayMarch},
+      {"batched-ray-march", slam::core::LidarMode::kBatchedRayMarch},
+      {"grid-traversal", slam::core::LidarMode::kGridTraversal},
+      {"sphere-trace", slam::core::LidarMode::kSphereTrace},
+  };
+
+  for (const BenchWorld& world : worlds) {
+    const std::vector<slam::core::RobotPose> poses = SampleFreePoses(world.grid, kPoseCount);
+    for (const int beamCount : {72, 720, 3600}) {
+      for (const BenchCase& benchCase : cases) {
+        RunCase(benchCase, world, poses, beamCount, minSeconds);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file LidarPresetBenchmark.cpp
+ * @brief Offline throughput comparison of compile-time lidar presets against the dynamic lidar.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/SimulatedLidarT.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+constexpr int kWorldWidth = 120;
+constexpr int kWorldHeight = 80;
+constexpr double kMaxRange = 30.0;
+constexpr double kStepSize = 1.0;
+constexpr int kPoseCount = 64;
+
+/**
+ * @brief Build the demo world layout without the raylib-backed world loader.
+ */
+slam::core::WorldGrid BuildDemoLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(80, 55, 18, 10);
+  return world;
+}
+
+/**
+ * @brief Sample deterministic collision-free poses with random headings.
+ */
+std::vector<slam::core::RobotPose> SampleFreePoses(const slam::core::WorldGrid& world) {
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> xDist(1.0, static_cast<double>(world.Width() - 1));
+  std::uniform_real_distribution<double> yDist(1.0, static_cast<double>(world.Height() - 1));
+  std::uniform_real_distribution<double> thetaDist(-3.14159265358979323846, 3.14159265358979323846);
+
+  std::vector<slam::core::RobotPose> poses;
+  while (static_cast<int>(poses.size()) < kPoseCount) {
+    const slam::core::RobotPose pose{xDist(rng), yDist(rng), thetaDist(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      poses.push_back(pose);
+    }
+  }
+  return poses;
+}
+
+/**
+ * @brief Measure beams per second for any lidar exposing Scan(world, pose, ScanBuffer&).
+ */
+template <typename Lidar>
+void RunCase(
+    const char* variant,
+    int beamCount,
+    const Lidar& lidar,
+    const slam::core::WorldGrid& world,
+    const std::vector<slam::core::RobotPose>& poses,
+    double minSeconds) {
+  using Clock = std::chrono::steady_clock;
+  slam::core::ScanBuffer buffer(beamCount);
+  double checksum = 0.0;
+  for (const slam::core::RobotPose& pose : poses) {
+    lidar.Scan(world, pose, buffer);
+    for (const double distance : buffer.Distances()) {
+      checksum += distance;
+    }
+  }
+
+  long long beams = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < minSeconds) {
+    for (const slam::core::RobotPose& pose : poses) {
+      lidar.Scan(world, pose, buffer);
+      beams += beamCount;
+    }
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  std::cout << "{\"variant\":\"" << variant << "\""
+            << ",\"beams\":" << beamCount
+            << ",\"beams_per_sec\":" << std::fixed << std::setprecision(0) << static_cast<double>(beams) / elapsed
+            << ",\"checksum\":" << std::setprecision(3) << checksum
+            << "}\n";
+}
+
+/**
+ * @brief Compare the dynamic lidar with both precisions of one compile-time preset.
+ */
+template <int BeamCount>
+void RunPreset(
+    const slam::core::WorldGrid& world, const std::vector<slam::core::RobotPose>& poses, double minSeconds) {
+  RunCase("dynamic", BeamCount, slam::core::SimulatedLidar(kMaxRange, BeamCount, kStepSize), world, poses, minSeconds);
+  RunCase("template-double", BeamCount, slam::core::SimulatedLidarT<BeamCount, double>(kMaxRange, kStepSize), world,
+          poses, minSeconds);
+  RunCase("template-float", BeamCount,
+          slam::core::SimulatedLidarT<BeamCount, float>(static_cast<float>(kMaxRange), static_cast<float>(kStepSize)),
+          world, poses, minSeconds);
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Lidar preset benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const slam::core::WorldGrid world = BuildDemoLayout();
+  const std::vector<slam::core::RobotPose> poses = SampleFreePoses(world);
+  RunPreset<72>(world, poses, minSeconds);
+  RunPreset<360>(world, poses, minSeconds);
+  RunPreset<1080>(world, poses, minSeconds);
+  return 0;
+}
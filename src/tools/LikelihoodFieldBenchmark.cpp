@@ -0,0 +1,204 @@
+/**
+ * @file LikelihoodFieldBenchmark.cpp
+ * @brief Offline cost of incremental likelihood-field updates and batched scan scoring.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/LikelihoodField.h"
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kBeamCount = 360;
+constexpr int kScanCount = 200;
+constexpr int kPoseCount = 256;
+
+/**
+ * @brief One world size and lidar range.
+ */
+struct WorldCase {
+  const char* name;
+  int size;
+  double maxRange;
+  int obstacleCount;
+};
+
+/**
+ * @brief Square world with border walls and random blocks.
+ */
+slam::core::WorldGrid BuildWorld(const WorldCase& worldCase) {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(worldCase.size, worldCase.size);
+  std::mt19937 rng(static_cast<std::uint32_t>(worldCase.size));
+  std::uniform_int_distribution<int> cornerDist(1, worldCase.size - 12);
+  std::uniform_int_distribution<int> sizeDist(2, 10);
+  for (int i = 0; i < worldCase.obstacleCount; ++i) {
+    world.AddRectangle(cornerDist(rng), cornerDist(rng), sizeDist(rng), sizeDist(rng));
+  }
+  return world;
+}
+
+/**
+ * @brief Random free poses.
+ */
+std::vector<slam::core::RobotPose> FreePoses(const slam::core::WorldGrid& world, int count, std::uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> posDist(2.0, static_cast<double>(world.Width() - 2));
+  std::uniform_real_distribution<double> headingDist(-3.14, 3.14);
+  std::vector<slam::core::RobotPose> poses;
+  while (static_cast<int>(poses.size()) < count) {
+    const slam::core::RobotPose pose{posDist(rng), posDist(rng), headingDist(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      poses.push_back(pose);
+    }
+  }
+  return poses;
+}
+
+/**
+ * @brief Build a field from scratch over the map's occupied cells.
+ */
+slam::core::LikelihoodField RebuildField(const slam::core::OccupancyGridMap& map) {
+  slam::core::LikelihoodField field(map.Width(), map.Height());
+  for (int y = 0; y < map.Height(); ++y) {
+    for (int x = 0; x < map.Width(); ++x) {
+      if (map.ClassifiedValueAt(x, y) == slam::core::kOccupied) {
+        field.SetObstacle(x, y);
+      }
+    }
+  }
+  field.Update();
+  return field;
+}
+
+/**
+ * @brief Per-endpoint reference: double-precision transform and one bounds-checked lookup per hit.
+ */
+double ScoreScalar(const slam::core::LikelihoodField& field, const slam::core::RobotPose& pose,
+                   const slam::core::ScanBuffer& scan) {
+  double sum = 0.0;
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    if (!scan.Hit(i)) {
+      continue;
+    }
+    const double angle = pose.theta + scan.RelativeAngles()[i];
+    const double x = pose.x + std::cos(angle) * scan.Distances()[i];
+    const double y = pose.y + std::sin(angle) * scan.Distances()[i];
+    if (x >= 0.0 && y >= 0.0 && x < field.Width() && y < field.Height()) {
+      sum += field.LikelihoodAt(static_cast<int>(x), static_cast<int>(y));
+    }
+  }
+  return sum;
+}
+
+/**
+ * @brief Mean seconds per call of fn, repeated until minSeconds elapse (at least 3 calls).
+ */
+template <typename Fn>
+double TimePerCall(double minSeconds, Fn fn) {
+  long long count = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (count < 3 || elapsed < minSeconds) {
+    fn();
+    ++count;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  return elapsed / static_cast<double>(count);
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Likelihood field benchmark entrypoint.
+ * @return Process exit code.
+ * @note field_update_ms is the extra integrate time per scan with the field maintained,
+ * against rebuild_ms for recomputing the field from scratch once. score_us times
+ * LikelihoodField::Score for one scan at one pose against scalar_score_us, the
+ * per-endpoint double-precision loop.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const WorldCase worlds[] = {{"app", 128, 30.0, 20}, {"large", 512, 60.0, 600}, {"huge", 1024, 60.0, 2400}};
+  for (const WorldCase& worldCase : worlds) {
+    const slam::core::WorldGrid world = BuildWorld(worldCase);
+    const slam::core::SimulatedLidar lidar(worldCase.maxRange, kBeamCount, 1.0);
+    const std::vector<slam::core::RobotPose> trajectory = FreePoses(world, kScanCount, 360U);
+    std::vector<slam::core::ScanBuffer> scans(trajectory.size());
+    for (std::size_t i = 0; i < trajectory.size(); ++i) {
+      lidar.Scan(world, trajectory[i], scans[i]);
+    }
+
+    // Same scans into a plain map and a field-maintaining map; the difference is the field's share.
+    slam::core::OccupancyGridMap plain(worldCase.size, worldCase.size, slam::core::MapUpdateMode::kLogOdds);
+    slam::core::OccupancyGridMap tracked(worldCase.size, worldCase.size, slam::core::MapUpdateMode::kLogOdds);
+    tracked.SetMaintainLikelihoodField(true);
+    const Clock::time_point plainStart = Clock::now();
+    for (std::size_t i = 0; i < trajectory.size(); ++i) {
+      plain.IntegrateScan(trajectory[i], scans[i]);
+    }
+    const double plainMs = std::chrono::duration<double, std::milli>(Clock::now() - plainStart).count() / kScanCount;
+    const Clock::time_point trackedStart = Clock::now();
+    for (std::size_t i = 0; i < trajectory.size(); ++i) {
+      tracked.IntegrateScan(trajectory[i], scans[i]);
+    }
+    const double trackedMs = std::chrono::duration<double, std::milli>(Clock::now() - trackedStart).count() / kScanCount;
+    const double rebuildMs = TimePerCall(minSeconds, [&]() { RebuildField(tracked); }) * 1e3;
+
+    const slam::core::LikelihoodField& field = tracked.Field();
+    const std::vector<slam::core::RobotPose> queries = FreePoses(world, kPoseCount, 7U);
+    slam::core::ScanBuffer scan;
+    lidar.Scan(world, queries.front(), scan);
+    slam::core::ScanPoints points;
+    points.Assign(scan);
+    double checksum = 0.0;
+    const double scoreUs = TimePerCall(minSeconds, [&]() {
+                             for (const slam::core::RobotPose& pose : queries) {
+                               checksum += field.Score(pose, points);
+                             }
+                           }) *
+                           1e6 / kPoseCount;
+    const double scalarUs = TimePerCall(minSeconds, [&]() {
+                              for (const slam::core::RobotPose& pose : queries) {
+                                checksum += ScoreScalar(field, pose, scan);
+                              }
+                            }) *
+                            1e6 / kPoseCount;
+    std::cout << "{\"world\":\"" << worldCase.name << "\",\"map\":" << worldCase.size << ",\"beams\":" << kBeamCount
+              << ",\"hits\":" << points.Size() << std::fixed << std::setprecision(3)
+              << ",\"integrate_ms\":" << plainMs << ",\"field_update_ms\":" << (trackedMs - plainMs)
+              << ",\"rebuild_ms\":" << rebuildMs << ",\"score_us\":" << scoreUs << ",\"scalar_score_us\":" << scalarUs
+              << ",\"checksum\":" << std::setprecision(1) << checksum << "}\n";
+  }
+  return 0;
+}
@@ -0,0 +1,358 @@
+/**
+ * @file MapIntegrationBenchmark.cpp
+ * @brief Offline ns-per-beam and writes-per-scan benchmark for occupancy map ray integration.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/GridLine.h"
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+constexpr int kWorldWidth = 120;
+constexpr int kWorldHeight = 80;
+constexpr double kMaxRange = 30.0;
+constexpr double kStepSize = 1.0;
+constexpr int kPoseCount = 64;
+
+/**
+ * @brief Build the demo world layout without the raylib-backed world loader.
+ */
+slam::core::WorldGrid BuildDemoLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(80, 55, 18, 10);
+  return world;
+}
+
+/**
+ * @brief Scan the world once from deterministic collision-free poses.
+ */
+std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>> BuildScans(
+    const slam::core::WorldGrid& world, int beamCount) {
+  const slam::core::SimulatedLidar lidar(kMaxRange, beamCount, kStepSize);
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> xDist(1.0, static_cast<double>(kWorldWidth - 1));
+  std::uniform_real_distribution<double> yDist(1.0, static_cast<double>(kWorldHeight - 1));
+  std::uniform_real_distribution<double> thetaDist(-3.14159265358979323846, 3.14159265358979323846);
+  std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>> scans;
+  while (static_cast<int>(scans.size()) < kPoseCount) {
+    const slam::core::RobotPose pose{xDist(rng), yDist(rng), thetaDist(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      slam::core::ScanBuffer buffer;
+      lidar.Scan(world, pose, buffer);
+      scans.emplace_back(pose, std::move(buffer));
+    }
+  }
+  return scans;
+}
+
+/**
+ * @brief Plain row-major grid used by the reference integrators.
+ */
+struct ReferenceGrid {
+  int width = 0;
+  int height = 0;
+  std::vector<std::int16_t> cells;
+
+  bool InBounds(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+  std::int16_t& At(int x, int y) { return cells[static_cast<std::size_t>(y * width + x)]; }
+};
+
+/**
+ * @brief Original line rasterizer that returns a freshly allocated point list.
+ */
+std::vector<std::pair<int, int>> BresenhamPoints(std::pair<int, int> start, std::pair<int, int> end) {
+  int x0 = start.first;
+  int y0 = start.second;
+  const int x1 = end.first;
+  const int y1 = end.second;
+
+  std::vector<std::pair<int, int>> points;
+  const int dx = std::abs(x1 - x0);
+  const int dy = std::abs(y1 - y0);
+  const int xStep = (x0 < x1) ? 1 : -1;
+  const int yStep = (y0 < y1) ? 1 : -1;
+
+  int err = dx - dy;
+  while (true) {
+    points.push_back({x0, y0});
+    if (x0 == x1 && y0 == y1) {
+      break;
+    }
+    const int errTwice = 2 * err;
+    if (errTwice > -dy) {
+      err -= dy;
+      x0 += xStep;
+    }
+    if (errTwice < dx) {
+      err += dx;
+      y0 += yStep;
+    }
+  }
+  return points;
+}
+
+/**
+ * @brief Original integration: one point vector per beam, bounds-checked per cell.
+ */
+void IntegrateWithPointVector(ReferenceGrid& grid, const slam::core::RobotPose& pose, const slam::core::ScanBuffer& scan) {
+  const std::pair<int, int> start{static_cast<int>(pose.x), static_cast<int>(pose.y)};
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    const std::pair<int, int> end{static_cast<int>(scan.EndX()[i]), static_cast<int>(scan.EndY()[i])};
+    const std::vector<std::pair<int, int>> points = BresenhamPoints(start, end);
+    const std::size_t freeCount = scan.Hit(i) ? points.size() - 1 : points.size();
+    for (std::size_t p = 1; p < freeCount; ++p) {
+      if (grid.InBounds(points[p].first, points[p].second)) {
+        grid.At(points[p].first, points[p].second) = slam::core::kFree;
+      }
+    }
+    if (scan.Hit(i) && grid.InBounds(end.first, end.second)) {
+      grid.At(end.first, end.second) = slam::core::kOccupied;
+    }
+  }
+}
+
+/**
+ * @brief In-place Bresenham walk without allocation, still bounds-checked per cell.
+ */
+void IntegrateWithPerCellBounds(ReferenceGrid& grid, const slam::core::RobotPose& pose, const slam::core::ScanBuffer& scan) {
+  for (std::size_t i = 0; i < scan.Size(); ++i) {
+    int x = static_cast<int>(pose.x);
+    int y = static_cast<int>(pose.y);
+    const int endX = static_cast<int>(scan.EndX()[i]);
+    const int endY = static_cast<int>(scan.EndY()[i]);
+    const bool hit = scan.Hit(i);
+    const int dx = std::abs(endX - x);
+    const int dy = std::abs(endY - y);
+    const int xStep = (x < endX) ? 1 : -1;
+    const int yStep = (y < endY) ? 1 : -1;
+    int err = dx - dy;
+    while (x != endX || y != endY) {
+      const int errTwice = 2 * err;
+      if (errTwice > -dy) {
+        err -= dy;
+        x += xStep;
+      }
+      if (errTwice < dx) {
+        err += dx;
+        y += yStep;
+      }
+      if (hit && x == endX && y == endY) {
+        break;
+      }
+      if (grid.InBounds(x, y)) {
+        grid.At(x, y) = slam::core::kFree;
+      }
+    }
+    if (hit && grid.InBounds(endX, endY)) {
+      grid.At(endX, endY) = slam::core::kOccupied;
+    }
+  }
+}
+
+/**
+ * @brief Timing and result of one integrator.
+ */
+struct CaseResult {
+  double nsPerBeam = 0.0;
+  /// Sum of map cells after one pass over every scan, equal across non-deduplicated overwrite integrators.
+  long long checksum = 0;
+};
+
+/**
+ * @brief Integrate every scan repeatedly into a reference grid until minSeconds elapse.
+ */
+template <typename Integrate>
+CaseResult RunReference(
+    const std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>>& scans,
+    int mapWidth,
+    int mapHeight,
+    double minSeconds,
+    Integrate integrate) {
+  using Clock = std::chrono::steady_clock;
+  ReferenceGrid grid{mapWidth, mapHeight, std::vector<std::int16_t>(static_cast<std::size_t>(mapWidth * mapHeight), slam::core::kUnknown)};
+  CaseResult result;
+  for (const auto& [pose, scan] : scans) {
+    integrate(grid, pose, scan);
+  }
+  for (const std::int16_t cell : grid.cells) {
+    result.checksum += cell;
+  }
+
+  long long beams = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < minSeconds) {
+    for (const auto& [pose, scan] : scans) {
+      integrate(grid, pose, scan);
+      beams += static_cast<long long>(scan.Size());
+    }
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  result.nsPerBeam = elapsed * 1e9 / static_cast<double>(beams);
+  return result;
+}
+
+/**
+ * @brief Integrate every scan repeatedly through OccupancyGridMap's clipped line visitor.
+ */
+CaseResult RunOccupancyMap(
+    const std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>>& scans,
+    int mapWidth,
+    int mapHeight,
+    slam::core::MapUpdateMode mode,
+    bool deduplicate,
+    double minSeconds) {
+  using Clock = std::chrono::steady_clock;
+  slam::core::OccupancyGridMap map(mapWidth, mapHeight, mode);
+  map.SetDeduplicateScanUpdates(deduplicate);
+  CaseResult result;
+  for (const auto& [pose, scan] : scans) {
+    map.IntegrateScan(pose, scan);
+  }
+  for (int y = 0; y < mapHeight; ++y) {
+    for (int x = 0; x < mapWidth; ++x) {
+      result.checksum += map.ValueAt(x, y);
+    }
+  }
+
+  long long beams = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < minSeconds) {
+    for (const auto& [pose, scan] : scans) {
+      map.IntegrateScan(pose, scan);
+      beams += static_cast<long long>(scan.Size());
+    }
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  result.nsPerBeam = elapsed * 1e9 / static_cast<double>(beams);
+  return result;
+}
+
+/**
+ * @brief Average cell writes per scan, counting repeats unless updates are deduplicated per scan.
+ */
+double CountWritesPerScan(
+    const std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>>& scans,
+    int mapWidth,
+    int mapHeight,
+    bool deduplicate) {
+  const slam::core::GridRect bounds{.xBegin = 0, .yBegin = 0, .xEnd = mapWidth, .yEnd = mapHeight};
+  const std::size_t cellCount = static_cast<std::size_t>(mapWidth * mapHeight);
+  std::vector<std::uint32_t> missStamps(cellCount, 0U);
+  std::vector<std::uint32_t> hitStamps(cellCount, 0U);
+  std::uint32_t generation = 0;
+  long long writes = 0;
+  const auto write = [&](std::vector<std::uint32_t>& stamps, int x, int y) {
+    const std::size_t index = static_cast<std::size_t>(y * mapWidth + x);
+    if (!deduplicate || stamps[index] != generation) {
+      stamps[index] = generation;
+      ++writes;
+    }
+  };
+  for (const auto& [pose, scan] : scans) {
+    ++generation;
+    const int startX = static_cast<int>(pose.x);
+    const int startY = static_cast<int>(pose.y);
+    for (std::size_t i = 0; i < scan.Size(); ++i) {
+      const int endX = static_cast<int>(scan.EndX()[i]);
+      const int endY = static_cast<int>(scan.EndY()[i]);
+      const int length = slam::core::GridLineLength(startX, startY, endX, endY);
+      slam::core::VisitGridLine(startX, startY, endX, endY, 1, scan.Hit(i) ? length : length + 1, bounds,
+                                [&](int x, int y) { write(missStamps, x, y); });
+      if (scan.Hit(i) && endX >= 0 && endX < mapWidth && endY >= 0 && endY < mapHeight) {
+        write(hitStamps, endX, endY);
+      }
+    }
+  }
+  return static_cast<double>(writes) / static_cast<double>(scans.size());
+}
+
+/**
+ * @brief Print one result line as JSON.
+ */
+void PrintResult(
+    const char* map, int beamCount, const char* integrator, double writesPerScan, const CaseResult& result) {
+  std::cout << "{\"map\":\"" << map << "\""
+            << ",\"beams\":" << beamCount
+            << ",\"integrator\":\"" << integrator << "\""
+            << std::fixed << std::setprecision(2)
+            << ",\"ns_per_beam\":" << result.nsPerBeam
+            << ",\"us_per_scan\":" << result.nsPerBeam * beamCount * 1e-3
+            << ",\"writes_per_scan\":" << std::setprecision(1) << writesPerScan
+            << ",\"checksum\":" << result.checksum
+            << "}\n";
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Map integration benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const slam::core::WorldGrid world = BuildDemoLayout();
+  // "cropped" maps only the world's top-left quarter, so most beams leave the map and clip.
+  const struct {
+    const char* name;
+    int width;
+    int height;
+  } maps[] = {{"full", kWorldWidth, kWorldHeight}, {"cropped", kWorldWidth / 2, kWorldHeight / 2}};
+  for (const int beamCount : {72, 720, 3600}) {
+    const auto scans = BuildScans(world, beamCount);
+    for (const auto& map : maps) {
+      using slam::core::MapUpdateMode;
+      const double writes = CountWritesPerScan(scans, map.width, map.height, false);
+      const double dedupedWrites = CountWritesPerScan(scans, map.width, map.height, true);
+      PrintResult(map.name, beamCount, "point-vector", writes,
+                  RunReference(scans, map.width, map.height, minSeconds, IntegrateWithPointVector));
+      PrintResult(map.name, beamCount, "per-cell-bounds", writes,
+                  RunReference(scans, map.width, map.height, minSeconds, IntegrateWithPerCellBounds));
+      PrintResult(map.name, beamCount, "clipped-visitor", writes,
+                  RunOccupancyMap(scans, map.width, map.height, MapUpdateMode::kOverwrite, false, minSeconds));
+      PrintResult(map.name, beamCount, "clipped-visitor-dedup", dedupedWrites,
+                  RunOccupancyMap(scans, map.width, map.height, MapUpdateMode::kOverwrite, true, minSeconds));
+      PrintResult(map.name, beamCount, "log-odds", writes,
+                  RunOccupancyMap(scans, map.width, map.height, MapUpdateMode::kLogOdds, false, minSeconds));
+      PrintResult(map.name, beamCount, "log-odds-dedup", dedupedWrites,
+                  RunOccupancyMap(scans, map.width, map.height, MapUpdateMode::kLogOdds, true, minSeconds));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,331 @@
+/**
+ * @file MapLayoutBenchmark.cpp
+ * @brief Offline integrate and scan+integrate time and cache misses of row-major, tiled, and Morton grids.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+constexpr int kWorldSize = 4096;
+constexpr double kMaxRange = 400.0;
+constexpr double kStepSize = 1.0;
+constexpr int kPoseCount = 32;
+constexpr int kObstacleCount = 4000;
+
+/**
+ * @brief Large world scattered with random blocks, so beams run long in every direction.
+ */
+slam::core::WorldGrid BuildLargeWorld() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldSize, kWorldSize);
+  std::mt19937 rng(4096U);
+  std::uniform_int_distribution<int> cornerDist(1, kWorldSize - 40);
+  std::uniform_int_distribution<int> sizeDist(2, 30);
+  for (int i = 0; i < kObstacleCount; ++i) {
+    world.AddRectangle(cornerDist(rng), cornerDist(rng), sizeDist(rng), sizeDist(rng));
+  }
+  return world;
+}
+
+/**
+ * @brief Scan the world once from deterministic collision-free poses spread over the map.
+ */
+std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>> BuildScans(
+    const slam::core::WorldGrid& world, int beamCount) {
+  const slam::core::SimulatedLidar lidar(kMaxRange, beamCount, kStepSize);
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> posDist(1.0, static_cast<double>(kWorldSize - 1));
+  std::uniform_real_distribution<double> thetaDist(-3.14159265358979323846, 3.14159265358979323846);
+  std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>> scans;
+  while (static_cast<int>(scans.size()) < kPoseCount) {
+    const slam::core::RobotPose pose{posDist(rng), posDist(rng), thetaDist(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      slam::core::ScanBuffer buffer;
+      lidar.Scan(world, pose, buffer);
+      scans.emplace_back(pose, std::move(buffer));
+    }
+  }
+  return scans;
+}
+
+/**
+ * @brief Which cache level a CacheMissCounter counts read misses of.
+ */
+enum class CacheLevel {
+  kL1Data,
+  kLastLevel,
+};
+
+/**
+ * @brief Hardware cache-miss counter for the calling thread; reports nothing where unsupported.
+ * @note Containers and hosts with a strict perf_event_paranoid setting refuse the counter,
+ * in which case only timings are printed. perf has no portable L2 event, so the outer
+ * level is the last-level cache.
+ */
+class CacheMissCounter {
+ public:
+  explicit CacheMissCounter(CacheLevel level) {
+#if defined(__linux__)
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = ((level == CacheLevel::kL1Data) ? PERF_COUNT_HW_CACHE_L1D : PERF_COUNT_HW_CACHE_LL) |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8U) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+    static_cast<void>(level);
+#endif
+  }
+  ~CacheMissCounter() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+  }
+  CacheMissCounter(const CacheMissCounter&) = delete;
+  CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+  /// @return True when the counter could be opened.
+  bool Available() const { return fd_ >= 0; }
+
+  /// Zero and start the counter.
+  void Start() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  /// @return Misses since Start(), or -1 when unavailable.
+  long long Stop() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      long long count = 0;
+      if (read(fd_, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count))) {
+        return count;
+      }
+    }
+#endif
+    return -1;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+/**
+ * @brief L1 data and last-level read-miss counters started and stopped together.
+ */
+struct CacheCounters {
+  CacheMissCounter l1{CacheLevel::kL1Data};
+  CacheMissCounter lastLevel{CacheLevel::kLastLevel};
+};
+
+/**
+ * @brief Timing, cache misses, and result of one layout.
+ */
+struct CaseResult {
+  double usPerScan = 0.0;
+  /// L1 data read misses per scan, or negative when the counter is unavailable.
+  double l1MissesPerScan = -1.0;
+  /// Last-level cache read misses per scan, or negative when the counter is unavailable.
+  double lastLevelMissesPerScan = -1.0;
+  /// Sum of map cells after one pass over every pose; equal across layouts.
+  long long checksum = 0;
+};
+
+/**
+ * @brief Run pass() (one scan per pose) until minSeconds elapse and fill in timings and misses.
+ */
+template <typename Pass>
+void MeasurePasses(CacheCounters& counters, double minSeconds, CaseResult& result, Pass pass) {
+  using Clock = std::chrono::steady_clock;
+  long long scanCount = 0;
+  counters.l1.Start();
+  counters.lastLevel.Start();
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < minSeconds) {
+    pass();
+    scanCount += kPoseCount;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  const long long l1Misses = counters.l1.Stop();
+  const long long lastLevelMisses = counters.lastLevel.Stop();
+  result.usPerScan = elapsed * 1e6 / static_cast<double>(scanCount);
+  if (l1Misses >= 0) {
+    result.l1MissesPerScan = static_cast<double>(l1Misses) / static_cast<double>(scanCount);
+  }
+  if (lastLevelMisses >= 0) {
+    result.lastLevelMissesPerScan = static_cast<double>(lastLevelMisses) / static_cast<double>(scanCount);
+  }
+}
+
+/**
+ * @brief Sum of every map cell.
+ */
+long long Checksum(const slam::core::OccupancyGridMap& map) {
+  long long sum = 0;
+  for (int y = 0; y < kWorldSize; ++y) {
+    for (int x = 0; x < kWorldSize; ++x) {
+      sum += map.ValueAt(x, y);
+    }
+  }
+  return sum;
+}
+
+/**
+ * @brief Integrate every precomputed scan repeatedly into a 4096x4096 map until minSeconds elapse.
+ */
+CaseResult RunLayout(
+    const std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>>& scans,
+    slam::core::MapLayout layout,
+    slam::core::IntegrationMode integration,
+    CacheCounters& counters,
+    double minSeconds) {
+  slam::core::OccupancyGridMap map(kWorldSize, kWorldSize, slam::core::MapUpdateMode::kLogOdds);
+  map.SetLayout(layout);
+  map.SetIntegrationMode(integration);
+  const auto pass = [&]() {
+    for (const auto& [pose, scan] : scans) {
+      map.IntegrateScan(pose, scan);
+    }
+  };
+  CaseResult result;
+  pass();
+  result.checksum = Checksum(map);
+  MeasurePasses(counters, minSeconds, result, pass);
+  return result;
+}
+
+/**
+ * @brief Sphere-trace a fresh scan from every pose and integrate it, world clearance and map in one layout.
+ */
+CaseResult RunScanAndIntegrate(
+    slam::core::WorldGrid& world,
+    const std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>>& scans,
+    int beamCount,
+    slam::core::MapLayout layout,
+    CacheCounters& counters,
+    double minSeconds) {
+  world.SetLayout(layout);
+  const slam::core::SimulatedLidar lidar(kMaxRange, beamCount, kStepSize, slam::core::LidarMode::kSphereTrace);
+  slam::core::OccupancyGridMap map(kWorldSize, kWorldSize, slam::core::MapUpdateMode::kLogOdds);
+  map.SetLayout(layout);
+  slam::core::ScanBuffer scan;
+  const auto pass = [&]() {
+    for (const auto& entry : scans) {
+      lidar.Scan(world, entry.first, scan);
+      map.IntegrateScan(entry.first, scan);
+    }
+  };
+  CaseResult result;
+  pass();
+  result.checksum = Checksum(map);
+  MeasurePasses(counters, minSeconds, result, pass);
+  return result;
+}
+
+/**
+ * @brief Print a miss count, or null when the counter is unavailable.
+ */
+void PrintMisses(const char* key, double missesPerScan) {
+  std::cout << ",\"" << key << "\":";
+  if (missesPerScan < 0.0) {
+    std::cout << "null";
+  } else {
+    std::cout << std::setprecision(0) << missesPerScan;
+  }
+}
+
+/**
+ * @brief Print one result line as JSON.
+ */
+void PrintResult(
+    int beamCount, const char* workload, const char* integration, const char* layout, const CaseResult& result) {
+  std::cout << "{\"map\":" << kWorldSize << ",\"beams\":" << beamCount << ",\"workload\":\"" << workload
+            << "\",\"integration\":\"" << integration << "\",\"layout\":\"" << layout << "\"" << std::fixed
+            << std::setprecision(2) << ",\"us_per_scan\":" << result.usPerScan;
+  PrintMisses("l1d_misses_per_scan", result.l1MissesPerScan);
+  PrintMisses("llc_misses_per_scan", result.lastLevelMissesPerScan);
+  std::cout << ",\"checksum\":" << result.checksum << "}\n";
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Map layout benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  slam::core::WorldGrid world = BuildLargeWorld();
+  world.BuildDistanceField();
+  CacheCounters counters;
+  if (!counters.l1.Available() || !counters.lastLevel.Available()) {
+    std::cerr << "perf_event_open unavailable; unsupported miss counts are null\n";
+  }
+  using slam::core::IntegrationMode;
+  using slam::core::MapLayout;
+  constexpr std::pair<MapLayout, const char*> kLayouts[] = {
+      {MapLayout::kRowMajor, "row-major"}, {MapLayout::kTiled, "tiled"}, {MapLayout::kMorton, "morton"}};
+  for (const int beamCount : {360, 3600}) {
+    const auto scans = BuildScans(world, beamCount);
+    for (const auto& [integration, name] :
+         {std::pair{IntegrationMode::kBeams, "beams"}, std::pair{IntegrationMode::kVisibilityPolygon, "visibility-polygon"}}) {
+      for (const auto& [layout, layoutName] : kLayouts) {
+        PrintResult(beamCount, "integrate", name, layoutName, RunLayout(scans, layout, integration, counters, minSeconds));
+      }
+    }
+    for (const auto& [layout, layoutName] : kLayouts) {
+      PrintResult(beamCount, "sphere-trace+integrate", "beams", layoutName,
+                  RunScanAndIntegrate(world, scans, beamCount, layout, counters, minSeconds));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file PackedMapBenchmark.cpp
+ * @brief Offline memory, scan integration, and texture staging cost of int16 against two-bit maps.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <raylib.h>
+
+#include "core/OccupancyGridMap.h"
+#include "core/PackedOccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+#include "render/Renderer.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMapSize = 4096;
+constexpr double kMaxRange = 400.0;
+constexpr int kBeamCount = 3600;
+constexpr int kPoseCount = 32;
+constexpr int kObstacleCount = 4000;
+
+/**
+ * @brief Large world scattered with random blocks, scanned from deterministic free poses.
+ */
+std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>> BuildScans() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kMapSize, kMapSize);
+  std::mt19937 rng(4096U);
+  std::uniform_int_distribution<int> cornerDist(1, kMapSize - 40);
+  std::uniform_int_distribution<int> sizeDist(2, 30);
+  for (int i = 0; i < kObstacleCount; ++i) {
+    world.AddRectangle(cornerDist(rng), cornerDist(rng), sizeDist(rng), sizeDist(rng));
+  }
+  const slam::core::SimulatedLidar lidar(kMaxRange, kBeamCount, 1.0);
+  std::uniform_real_distribution<double> posDist(1.0, static_cast<double>(kMapSize - 1));
+  std::vector<std::pair<slam::core::RobotPose, slam::core::ScanBuffer>> scans;
+  while (static_cast<int>(scans.size()) < kPoseCount) {
+    const slam::core::RobotPose pose{posDist(rng), posDist(rng), 0.0};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      slam::core::ScanBuffer buffer;
+      lidar.Scan(world, pose, buffer);
+      scans.emplace_back(pose, std::move(buffer));
+    }
+  }
+  return scans;
+}
+
+/**
+ * @brief Mean seconds per call of fn, repeated until minSeconds elapse (at least 3 calls).
+ */
+template <typename Fn>
+double TimePerCall(double minSeconds, Fn fn) {
+  long long count = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (count < 3 || elapsed < minSeconds) {
+    fn();
+    ++count;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  return elapsed / static_cast<double>(count);
+}
+
+/**
+ * @brief Print one result line as JSON.
+ */
+void PrintResult(const char* storage, std::size_t cellBytes, double scanUs, double stageMs, long long checksum) {
+  std::cout << "{\"map\":" << kMapSize << ",\"storage\":\"" << storage << "\",\"cell_bytes\":" << cellBytes
+            << std::fixed << std::setprecision(2) << ",\"us_per_scan\":" << scanUs << ",\"upload_stage_ms\":" << stageMs
+            << ",\"checksum\":" << checksum << "}\n";
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Packed map benchmark entrypoint.
+ * @return Process exit code.
+ * @note upload_stage_ms is the CPU side of a full-map texture upload: producing one Color
+ * per cell (DrawMap() colors) that UpdateTexture() would copy. No GL context is opened.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const auto scans = BuildScans();
+  slam::core::OccupancyGridMap dense(kMapSize, kMapSize);
+  slam::core::PackedOccupancyGridMap packed(kMapSize, kMapSize);
+  const double denseScanUs = TimePerCall(minSeconds, [&]() {
+                               for (const auto& [pose, scan] : scans) {
+                                 dense.IntegrateScan(pose, scan);
+                               }
+                             }) *
+                             1e6 / kPoseCount;
+  const double packedScanUs = TimePerCall(minSeconds, [&]() {
+                                for (const auto& [pose, scan] : scans) {
+                                  packed.IntegrateScan(pose, scan);
+                                }
+                              }) *
+                              1e6 / kPoseCount;
+
+  std::vector<Color> pixels(static_cast<std::size_t>(kMapSize) * kMapSize);
+  const auto checksum = [&]() {
+    long long sum = 0;
+    for (const Color& pixel : pixels) {
+      sum += pixel.r;
+    }
+    return sum;
+  };
+  const double denseStageMs = TimePerCall(minSeconds, [&]() {
+                                for (int y = 0; y < kMapSize; ++y) {
+                                  for (int x = 0; x < kMapSize; ++x) {
+                                    pixels[static_cast<std::size_t>(y) * kMapSize + static_cast<std::size_t>(x)] =
+                                        (dense.ClassifiedValueAt(x, y) == slam::core::kOccupied)
+                                            ? slam::render::Palette::kMapObstacle
+                                            : slam::render::Palette::kBackground;
+                                  }
+                                }
+                              }) *
+                              1e3;
+  const long long denseChecksum = checksum();
+  const double packedStageMs =
+      TimePerCall(minSeconds, [&]() { slam::render::ExpandPackedMapToPixels(packed, pixels); }) * 1e3;
+  const long long packedChecksum = checksum();
+
+  std::vector<std::uint8_t> indices(static_cast<std::size_t>(kMapSize) * kMapSize);
+  const double indexStageMs =
+      TimePerCall(minSeconds, [&]() { packed.ExpandToPaletteIndices(indices); }) * 1e3;
+  long long indexChecksum = 0;
+  for (const std::uint8_t index : indices) {
+    indexChecksum += (index == slam::core::PackedOccupancyGridMap::kOccupiedCode) ? 80 : 0;
+  }
+
+  PrintResult("int16", dense.Data().size() * sizeof(std::int16_t), denseScanUs, denseStageMs, denseChecksum);
+  PrintResult("packed-2bit-rgba", packed.CellBytes(), packedScanUs, packedStageMs, packedChecksum);
+  PrintResult("packed-2bit-index", packed.CellBytes(), packedScanUs, indexStageMs, indexChecksum);
+  return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file ParallelScanBenchmark.cpp
+ * @brief Offline thread-scaling benchmark for sector-parallel scans and band-parallel integration.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorkerPool.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+constexpr int kWorldSize = 512;
+constexpr double kMaxRange = 200.0;
+constexpr double kStepSize = 1.0;
+constexpr int kPoseCount = 32;
+
+/**
+ * @brief Build a large bordered world scattered with rectangular blocks.
+ */
+slam::core::WorldGrid BuildDenseWorld() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldSize, kWorldSize);
+  std::mt19937 rng(42U);
+  std::uniform_int_distribution<int> position(1, kWorldSize - 2);
+  std::uniform_int_distribution<int> size(2, 12);
+  for (int i = 0; i < 600; ++i) {
+    world.AddRectangle(position(rng), position(rng), size(rng), size(rng));
+  }
+  return world;
+}
+
+/**
+ * @brief Sample deterministic collision-free poses.
+ */
+std::vector<slam::core::RobotPose> SampleFreePoses(const slam::core::WorldGrid& world) {
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> coordinate(1.0, static_cast<double>(kWorldSize - 1));
+  std::uniform_real_distribution<double> heading(-3.14159265358979323846, 3.14159265358979323846);
+  std::vector<slam::core::RobotPose> poses;
+  while (static_cast<int>(poses.size()) < kPoseCount) {
+    const slam::core::RobotPose pose{coordinate(rng), coordinate(rng), heading(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      poses.push_back(pose);
+    }
+  }
+  return poses;
+}
+
+/**
+ * @brief Per-stage wall time for one thread count.
+ */
+struct StageTimes {
+  double scan = 0.0;
+  double integrate = 0.0;
+  long long frames = 0;
+};
+
+/**
+ * @brief Time scan and integration stages on a pool of the given size.
+ */
+StageTimes RunCase(
+    const slam::core::WorldGrid& world,
+    const std::vector<slam::core::RobotPose>& poses,
+    int beamCount,
+    int threads,
+    double minSeconds) {
+  using Clock = std::chrono::steady_clock;
+  const slam::core::SimulatedLidar lidar(kMaxRange, beamCount, kStepSize);
+  slam::core::WorkerPool pool(threads);
+  slam::core::OccupancyGridMap map(kWorldSize, kWorldSize);
+  slam::core::ScanBuffer scan(beamCount);
+  StageTimes times;
+  while (times.scan + times.integrate < minSeconds) {
+    for (const slam::core::RobotPose& pose : poses) {
+      const Clock::time_point start = Clock::now();
+      lidar.Scan(world, pose, scan, pool);
+      const Clock::time_point scanned = Clock::now();
+      map.IntegrateScan(pose, scan, pool);
+      const Clock::time_point integrated = Clock::now();
+      times.scan += std::chrono::duration<double>(scanned - start).count();
+      times.integrate += std::chrono::duration<double>(integrated - scanned).count();
+      ++times.frames;
+    }
+  }
+  return times;
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Parallel scan benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const slam::core::WorldGrid world = BuildDenseWorld();
+  const std::vector<slam::core::RobotPose> poses = SampleFreePoses(world);
+  const unsigned hardwareThreads = std::thread::hardware_concurrency();
+  for (const int beamCount : {4096, 16384}) {
+    double baselineFrameMs = 0.0;
+    for (const int threads : {1, 2, 4, 8}) {
+      const StageTimes times = RunCase(world, poses, beamCount, threads, minSeconds);
+      const double perFrameMs = 1e3 / static_cast<double>(times.frames);
+      const double frameMs = (times.scan + times.integrate) * perFrameMs;
+      if (threads == 1) {
+        baselineFrameMs = frameMs;
+      }
+      std::cout << "{\"beams\":" << beamCount
+                << ",\"threads\":" << threads
+                << ",\"hardware_threads\":" << hardwareThreads
+                << std::fixed << std::setprecision(3)
+                << ",\"scan_ms\":" << times.scan * perFrameMs
+                << ",\"integrate_ms\":" << times.integrate * perFrameMs
+                << ",\"frame_ms\":" << frameMs
+                << ",\"speedup\":" << std::setprecision(2) << baselineFrameMs / frameMs
+                << "}\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file ParticleFilterBenchmark.cpp
+ * @brief Frame time and map memory of particle filter SLAM on copy-on-write maps.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "app/AssetPaths.h"
+#include "core/CowOccupancyGridMap.h"
+#include "core/OccupancyGridMap.h"
+#include "core/ParticleFilterSlam.h"
+#include "core/ScanBuffer.h"
+#include "core/ScanMatcher.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorkerPool.h"
+#include "core/WorldGrid.h"
+#include "world/WorldLoader.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kBeamCount = 180;
+constexpr double kMaxRange = 30.0;
+constexpr double kStep = 0.5;
+constexpr double kFrameBudgetMs = 1000.0 / 60.0;
+
+/**
+ * @brief One world to run the filter in.
+ */
+struct WorldCase {
+  const char* name;
+  slam::core::WorldGrid world;
+  int frames;
+};
+
+/**
+ * @brief Square world with border walls and random blocks, with its clearance field.
+ */
+slam::core::WorldGrid BuildBlockWorld(int size, int obstacleCount) {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(size, size);
+  std::mt19937 rng(static_cast<std::uint32_t>(size));
+  std::uniform_int_distribution<int> cornerDist(1, size - 12);
+  std::uniform_int_distribution<int> sizeDist(2, 10);
+  for (int i = 0; i < obstacleCount; ++i) {
+    world.AddRectangle(cornerDist(rng), cornerDist(rng), sizeDist(rng), sizeDist(rng));
+  }
+  world.BuildDistanceField();
+  return world;
+}
+
+/**
+ * @brief App-style walk: half-cell steps with the heading along the motion, turning at random near walls.
+ */
+std::vector<slam::core::RobotPose> BuildWalk(const slam::core::WorldGrid& world, int frames) {
+  std::mt19937 rng(120U);
+  std::uniform_real_distribution<double> headingDist(-std::numbers::pi, std::numbers::pi);
+  const auto roomy = [&world](double x, double y) {
+    const int cellX = static_cast<int>(x);
+    const int cellY = static_cast<int>(y);
+    return world.InBounds(cellX, cellY) && world.ClearanceAt(cellX, cellY) >= 1.5;
+  };
+  slam::core::RobotPose pose{};
+  for (int y = world.Height() / 2; y < world.Height() && !roomy(pose.x, pose.y); ++y) {
+    for (int x = world.Width() / 2; x < world.Width(); ++x) {
+      if (roomy(x + 0.5, y + 0.5)) {
+        pose = slam::core::RobotPose{x + 0.5, y + 0.5, 0.0};
+        break;
+      }
+    }
+  }
+  std::vector<slam::core::RobotPose> walk;
+  double heading = headingDist(rng);
+  for (int frame = 0; frame < frames; ++frame) {
+    for (int attempt = 0; attempt < 32 && !roomy(pose.x + kStep * std::cos(heading), pose.y + kStep * std::sin(heading));
+         ++attempt) {
+      heading = headingDist(rng);
+    }
+    if (roomy(pose.x + kStep * std::cos(heading), pose.y + kStep * std::sin(heading))) {
+      pose = slam::core::RobotPose{pose.x + kStep * std::cos(heading), pose.y + kStep * std::sin(heading), heading};
+    }
+    walk.push_back(pose);
+  }
+  return walk;
+}
+
+/**
+ * @brief Dead-reckoned odometry: every true motion increment perturbed with Gaussian noise.
+ */
+std::vector<slam::core::RobotPose> BuildOdometry(const std::vector<slam::core::RobotPose>& walk,
+                                                 const slam::core::RobotPose& start) {
+  std::mt19937 rng(7U);
+  std::normal_distribution<double> translationNoise(0.0, 0.05);
+  std::normal_distribution<double> headingNoise(0.0, 0.01);
+  std::vector<slam::core::RobotPose> odometry;
+  slam::core::RobotPose previous = start;
+  slam::core::RobotPose reading = start;
+  for (const slam::core::RobotPose& truth : walk) {
+    slam::core::RobotPose motion = slam::core::RelativePose(previous, truth);
+    previous = truth;
+    if (motion.x != 0.0 || motion.y != 0.0) {
+      motion.x += translationNoise(rng);
+      motion.y += translationNoise(rng);
+      motion.theta += headingNoise(rng);
+    }
+    reading = slam::core::ComposePose(reading, motion);
+    odometry.push_back(reading);
+  }
+  return odometry;
+}
+
+/**
+ * @brief Mean seconds per call of fn, repeated until minSeconds elapse (at least 3 calls).
+ */
+template <typename Fn>
+double TimePerCall(double minSeconds, Fn fn) {
+  long long count = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (count < 3 || elapsed < minSeconds) {
+    fn();
+    ++count;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  return elapsed / static_cast<double>(count);
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>] [--threads <count>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Particle filter benchmark entrypoint.
+ * @return Process exit code.
+ * @note map_mb counts shared tiles once plus every particle's tile table; naive_map_mb is
+ * the same particles each holding a full OccupancyGridMap. resample_ms copies the best
+ * particle's map once per particle, the work a full resampling step does, against
+ * naive_resample_ms: the same number of OccupancyGridMap copies.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  int threads = 1;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::atoi(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<WorldCase> worlds;
+  worlds.push_back(WorldCase{"maze", slam::world::BuildWorldFromImage(slam::app::ResolveAssetPath("assets/maze.png"), 120, 80), 400});
+  worlds.push_back(WorldCase{"large", BuildBlockWorld(1024, 2400), 200});
+  const slam::core::SimulatedLidar lidar(kMaxRange, kBeamCount, 1.0);
+  slam::core::WorkerPool pool(threads);
+  for (const WorldCase& worldCase : worlds) {
+    const slam::core::WorldGrid& world = worldCase.world;
+    const std::vector<slam::core::RobotPose> walk = BuildWalk(world, worldCase.frames);
+    const slam::core::RobotPose start = walk.front();
+    const std::vector<slam::core::RobotPose> odometry = BuildOdometry(walk, start);
+    std::vector<slam::core::ScanBuffer> scans(walk.size());
+    for (std::size_t i = 0; i < walk.size(); ++i) {
+      lidar.Scan(world, walk[i], scans[i]);
+    }
+
+    for (const int particleCount : {30, 100, 300}) {
+      slam::core::ParticleFilterSlam filter(
+          world.Width(), world.Height(), slam::core::ParticleFilterOptions{.particleCount = particleCount}, start);
+      double error = 0.0;
+      double drift = 0.0;
+      const Clock::time_point begin = Clock::now();
+      for (std::size_t i = 0; i < walk.size(); ++i) {
+        const slam::core::RobotPose& estimate = filter.Update(odometry[i], scans[i], pool);
+        error += std::hypot(estimate.x - walk[i].x, estimate.y - walk[i].y);
+        drift += std::hypot(odometry[i].x - walk[i].x, odometry[i].y - walk[i].y);
+      }
+      const double frameMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count() /
+                             static_cast<double>(walk.size());
+
+      const slam::core::CowOccupancyGridMap& best = filter.Best().map;
+      std::vector<slam::core::CowOccupancyGridMap> cowCopies;
+      const double resampleMs = TimePerCall(minSeconds, [&]() {
+                                  cowCopies.assign(static_cast<std::size_t>(particleCount), best);
+                                }) *
+                                1e3;
+      cowCopies.clear();
+      const slam::core::OccupancyGridMap dense(world.Width(), world.Height(), slam::core::MapUpdateMode::kLogOdds);
+      std::vector<slam::core::OccupancyGridMap> denseCopies;
+      const double naiveResampleMs = TimePerCall(minSeconds, [&]() {
+                                       denseCopies.assign(static_cast<std::size_t>(particleCount), dense);
+                                     }) *
+                                     1e3;
+      denseCopies.clear();
+      const double naiveBytes =
+          static_cast<double>(particleCount) * static_cast<double>(world.Width()) * static_cast<double>(world.Height()) * 2.0;
+
+      std::cout << "{\"world\":\"" << worldCase.name << "\",\"map\":\"" << world.Width() << "x" << world.Height()
+                << "\",\"particles\":" << particleCount << ",\"beams\":" << kBeamCount << ",\"frames\":" << walk.size()
+                << ",\"threads\":" << threads << std::fixed << std::setprecision(2) << ",\"ms_per_frame\":" << frameMs
+                << ",\"frame_budget_ms\":" << kFrameBudgetMs << ",\"map_mb\":" << filter.MapBytes() / 1048576.0
+                << ",\"naive_map_mb\":" << naiveBytes / 1048576.0 << ",\"resample_ms\":" << resampleMs
+                << ",\"naive_resample_ms\":" << naiveResampleMs << ",\"resamples\":" << filter.ResampleCount()
+                << ",\"mean_error_cells\":" << error / static_cast<double>(walk.size())
+                << ",\"mean_odometry_drift_cells\":" << drift / static_cast<double>(walk.size()) << "}\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file ResetBenchmark.cpp
+ * @brief Offline reset latency of full-buffer fills against epoch-stamped hit caches and maps.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/EpochMarks.h"
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kHitsPerFrame = 3600;
+constexpr int kMapSize = 4096;
+
+/**
+ * @brief Reset latency distribution of one case.
+ */
+struct ResetResult {
+  double meanUs = 0.0;
+  double maxUs = 0.0;
+  /// Scan integrated right after a reset, which pays for lazily refilled rows; negative if not measured.
+  double nextScanUs = -1.0;
+};
+
+/**
+ * @brief Time reset() after every frame of marks for at least minSeconds of wall time and 300 resets.
+ */
+template <typename MarkFrame, typename Reset>
+ResetResult TimeResets(double minSeconds, MarkFrame markFrame, Reset reset) {
+  ResetResult result;
+  double total = 0.0;
+  long long count = 0;
+  const Clock::time_point begin = Clock::now();
+  while (count < 300 || std::chrono::duration<double>(Clock::now() - begin).count() < minSeconds) {
+    markFrame();
+    const Clock::time_point start = Clock::now();
+    reset();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    total += seconds;
+    result.maxUs = std::max(result.maxUs, seconds * 1e6);
+    ++count;
+  }
+  result.meanUs = total * 1e6 / static_cast<double>(count);
+  return result;
+}
+
+/**
+ * @brief Hit-cache resets at one window size: a byte-per-pixel fill against HitPixelCache-style marks.
+ */
+void RunHitCache(int width, int height, double minSeconds) {
+  const std::size_t pixels = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+  std::mt19937 rng(7U);
+  std::uniform_int_distribution<std::size_t> pixelDist(0, pixels - 1);
+  std::vector<std::size_t> hits(kHitsPerFrame);
+  const auto drawHits = [&]() {
+    for (std::size_t& hit : hits) {
+      hit = pixelDist(rng);
+    }
+  };
+
+  std::vector<unsigned char> bytes(pixels, 0U);
+  const ResetResult fill = TimeResets(
+      minSeconds,
+      [&]() {
+        drawHits();
+        for (const std::size_t hit : hits) {
+          bytes[hit] = 1U;
+        }
+      },
+      [&]() { std::fill(bytes.begin(), bytes.end(), 0U); });
+
+  slam::core::EpochMarks<std::uint8_t> marks(pixels);
+  const ResetResult epoch = TimeResets(
+      minSeconds,
+      [&]() {
+        drawHits();
+        for (const std::size_t hit : hits) {
+          marks.Mark(hit);
+        }
+      },
+      [&]() { marks.Clear(); });
+
+  for (const auto& [method, result] : {std::pair{"fill", fill}, std::pair{"epoch", epoch}}) {
+    std::cout << "{\"target\":\"hit-cache\",\"width\":" << width << ",\"height\":" << height << ",\"method\":\""
+              << method << "\"" << std::fixed << std::setprecision(3) << ",\"reset_us_mean\":" << result.meanUs
+              << ",\"reset_us_max\":" << result.maxUs << ",\"next_scan_us\":null}\n";
+  }
+}
+
+/**
+ * @brief Map resets on a 4096x4096 log-odds map: the former whole-grid fill against OccupancyGridMap::Reset().
+ */
+void RunMap(double minSeconds) {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kMapSize, kMapSize);
+  world.AddRectangle(2000, 1900, 40, 300);
+  const slam::core::SimulatedLidar lidar(400.0, 3600, 1.0);
+  const slam::core::RobotPose pose{2048.5, 2048.5, 0.0};
+  slam::core::ScanBuffer scan;
+  lidar.Scan(world, pose, scan);
+
+  std::vector<std::int16_t> grid(static_cast<std::size_t>(kMapSize) * kMapSize, 0);
+  const ResetResult fill = TimeResets(
+      minSeconds, [&]() { grid[static_cast<std::size_t>(kMapSize) * 2048 + 2048] = -40; },
+      [&]() { std::fill(grid.begin(), grid.end(), std::int16_t{0}); });
+
+  slam::core::OccupancyGridMap map(kMapSize, kMapSize, slam::core::MapUpdateMode::kLogOdds);
+  double scanSeconds = 0.0;
+  long long scans = 0;
+  ResetResult epoch = TimeResets(
+      minSeconds,
+      [&]() {
+        const Clock::time_point start = Clock::now();
+        map.IntegrateScan(pose, scan);
+        scanSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+        ++scans;
+      },
+      [&]() { map.Reset(); });
+  // The first frame's scan ran on a fresh map; every later one followed a reset.
+  epoch.nextScanUs = scanSeconds * 1e6 / static_cast<double>(scans);
+
+  for (const auto& [method, result] : {std::pair{"fill", fill}, std::pair{"epoch", epoch}}) {
+    std::cout << "{\"target\":\"map\",\"width\":" << kMapSize << ",\"height\":" << kMapSize << ",\"method\":\""
+              << method << "\"" << std::fixed << std::setprecision(3) << ",\"reset_us_mean\":" << result.meanUs
+              << ",\"reset_us_max\":" << result.maxUs << ",\"next_scan_us\":";
+    if (result.nextScanUs < 0.0) {
+      std::cout << "null";
+    } else {
+      std::cout << result.nextScanUs;
+    }
+    std::cout << "}\n";
+  }
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Reset latency benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  // 1080p, 4K UHD, and a 4K HiDPI framebuffer at 2x scale.
+  for (const auto& [width, height] : {std::pair{1920, 1080}, std::pair{3840, 2160}, std::pair{7680, 4320}}) {
+    RunHitCache(width, height, minSeconds);
+  }
+  RunMap(minSeconds);
+  return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file ScanBatchBenchmark.cpp
+ * @brief Offline poses-per-second benchmark for batched multi-pose scans.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/ScanBatchBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorkerPool.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+constexpr int kWorldWidth = 120;
+constexpr int kWorldHeight = 80;
+constexpr double kMaxRange = 30.0;
+constexpr double kStepSize = 1.0;
+
+/**
+ * @brief Build the demo world layout without the raylib-backed world loader.
+ */
+slam::core::WorldGrid BuildDemoLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(80, 55, 18, 10);
+  return world;
+}
+
+/**
+ * @brief Sample particle-like poses scattered over the free space.
+ */
+std::vector<slam::core::RobotPose> SampleFreePoses(const slam::core::WorldGrid& world, int count) {
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> xDist(1.0, static_cast<double>(world.Width() - 1));
+  std::uniform_real_distribution<double> yDist(1.0, static_cast<double>(world.Height() - 1));
+  std::uniform_real_distribution<double> thetaDist(-3.14159265358979323846, 3.14159265358979323846);
+  std::vector<slam::core::RobotPose> poses;
+  while (static_cast<int>(poses.size()) < count) {
+    const slam::core::RobotPose pose{xDist(rng), yDist(rng), thetaDist(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      poses.push_back(pose);
+    }
+  }
+  return poses;
+}
+
+/**
+ * @brief Repeat one batch-scoring step until minSeconds elapse and report poses per second.
+ */
+template <typename Step>
+void RunCase(const char* variant, int poseCount, int beamCount, int threads, double minSeconds, Step&& step) {
+  using Clock = std::chrono::steady_clock;
+  double checksum = step();
+  long long poses = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < minSeconds) {
+    step();
+    poses += poseCount;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  std::cout << "{\"variant\":\"" << variant << "\""
+            << ",\"poses\":" << poseCount
+            << ",\"beams\":" << beamCount
+            << ",\"threads\":" << threads
+            << ",\"poses_per_sec\":" << std::fixed << std::setprecision(0) << static_cast<double>(poses) / elapsed
+            << ",\"checksum\":" << std::setprecision(3) << checksum
+            << "}\n";
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Scan batch benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const slam::core::WorldGrid world = BuildDemoLayout();
+  const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  slam::core::WorkerPool pool(hardwareThreads);
+  for (const int beamCount : {72, 360}) {
+    const slam::core::SimulatedLidar lidar(kMaxRange, beamCount, kStepSize);
+    for (const int poseCount : {100, 300, 1000}) {
+      const std::vector<slam::core::RobotPose> poses = SampleFreePoses(world, poseCount);
+      slam::core::ScanBatchBuffer batch;
+
+      RunCase("per-pose-scan", poseCount, beamCount, 1, minSeconds, [&] {
+        double sum = 0.0;
+        for (const slam::core::RobotPose& pose : poses) {
+          for (const slam::core::ScanSample& sample : lidar.Scan(world, pose)) {
+            sum += sample.distance;
+          }
+        }
+        return sum;
+      });
+      const auto batchChecksum = [&] {
+        double sum = 0.0;
+        for (std::size_t p = 0; p < batch.PoseCount(); ++p) {
+          for (const double distance : batch.Distances(p)) {
+            sum += distance;
+          }
+        }
+        return sum;
+      };
+      RunCase("scan-batch", poseCount, beamCount, 1, minSeconds, [&] {
+        lidar.ScanBatch(world, poses, batch);
+        return batchChecksum();
+      });
+      RunCase("scan-batch-pool", poseCount, beamCount, hardwareThreads, minSeconds, [&] {
+        lidar.ScanBatch(world, poses, batch, pool);
+        return batchChecksum();
+      });
+    }
+  }
+  return 0;
+}
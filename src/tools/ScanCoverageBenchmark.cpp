@@ -0,0 +1,170 @@
+/**
+ * @file ScanCoverageBenchmark.cpp
+ * @brief Offline map coverage and cost per scan for per-beam and visibility-polygon integration.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+constexpr int kWorldWidth = 120;
+constexpr int kWorldHeight = 80;
+constexpr double kMaxRange = 30.0;
+constexpr double kStepSize = 1.0;
+constexpr int kPoseCount = 64;
+
+/**
+ * @brief Build the demo world layout without the raylib-backed world loader.
+ */
+slam::core::WorldGrid BuildDemoLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(80, 55, 18, 10);
+  return world;
+}
+
+/**
+ * @brief Sample deterministic collision-free poses.
+ */
+std::vector<slam::core::RobotPose> SampleFreePoses(const slam::core::WorldGrid& world) {
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> xDist(1.0, static_cast<double>(kWorldWidth - 1));
+  std::uniform_real_distribution<double> yDist(1.0, static_cast<double>(kWorldHeight - 1));
+  std::uniform_real_distribution<double> thetaDist(-3.14159265358979323846, 3.14159265358979323846);
+  std::vector<slam::core::RobotPose> poses;
+  while (static_cast<int>(poses.size()) < kPoseCount) {
+    const slam::core::RobotPose pose{xDist(rng), yDist(rng), thetaDist(rng)};
+    if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+      poses.push_back(pose);
+    }
+  }
+  return poses;
+}
+
+/**
+ * @brief Coverage and per-stage cost of one integration mode at one beam count.
+ */
+struct CoverageResult {
+  double freeCellsPerScan = 0.0;
+  /// Free cells that are obstacles in the ground-truth world.
+  double wrongCellsPerScan = 0.0;
+  double scanUs = 0.0;
+  double integrateUs = 0.0;
+};
+
+/**
+ * @brief Integrate each pose's scan into a fresh map, then time scan and integration separately.
+ */
+CoverageResult RunCase(
+    const slam::core::WorldGrid& world,
+    const std::vector<slam::core::RobotPose>& poses,
+    int beamCount,
+    slam::core::IntegrationMode mode,
+    double minSeconds) {
+  using Clock = std::chrono::steady_clock;
+  const slam::core::SimulatedLidar lidar(kMaxRange, beamCount, kStepSize);
+  slam::core::OccupancyGridMap map(kWorldWidth, kWorldHeight);
+  map.SetIntegrationMode(mode);
+  slam::core::ScanBuffer scan(beamCount);
+  CoverageResult result;
+
+  for (const slam::core::RobotPose& pose : poses) {
+    map.Reset();
+    lidar.Scan(world, pose, scan);
+    map.IntegrateScan(pose, scan);
+    for (int y = 0; y < kWorldHeight; ++y) {
+      for (int x = 0; x < kWorldWidth; ++x) {
+        if (map.ClassifiedValueAt(x, y) == slam::core::kFree) {
+          result.freeCellsPerScan += 1.0;
+          result.wrongCellsPerScan += world.IsObstacle(x, y) ? 1.0 : 0.0;
+        }
+      }
+    }
+  }
+  result.freeCellsPerScan /= static_cast<double>(poses.size());
+  result.wrongCellsPerScan /= static_cast<double>(poses.size());
+
+  double scanSeconds = 0.0;
+  double integrateSeconds = 0.0;
+  long long scans = 0;
+  while (scanSeconds + integrateSeconds < minSeconds) {
+    for (const slam::core::RobotPose& pose : poses) {
+      const Clock::time_point start = Clock::now();
+      lidar.Scan(world, pose, scan);
+      const Clock::time_point scanned = Clock::now();
+      map.IntegrateScan(pose, scan);
+      const Clock::time_point integrated = Clock::now();
+      scanSeconds += std::chrono::duration<double>(scanned - start).count();
+      integrateSeconds += std::chrono::duration<double>(integrated - scanned).count();
+      ++scans;
+    }
+  }
+  result.scanUs = scanSeconds * 1e6 / static_cast<double>(scans);
+  result.integrateUs = integrateSeconds * 1e6 / static_cast<double>(scans);
+  return result;
+}
+
+/**
+ * @brief Print one result line as JSON.
+ */
+void PrintResult(int beamCount, const char* integration, const CoverageResult& result) {
+  std::cout << "{\"beams\":" << beamCount
+            << ",\"integration\":\"" << integration << "\""
+            << std::fixed << std::setprecision(1)
+            << ",\"free_cells_per_scan\":" << result.freeCellsPerScan
+            << ",\"wrong_free_cells_per_scan\":" << result.wrongCellsPerScan
+            << std::setprecision(2)
+            << ",\"scan_us\":" << result.scanUs
+            << ",\"integrate_us\":" << result.integrateUs
+            << ",\"total_us\":" << result.scanUs + result.integrateUs
+            << "}\n";
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Scan coverage benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const slam::core::WorldGrid world = BuildDemoLayout();
+  const std::vector<slam::core::RobotPose> poses = SampleFreePoses(world);
+  for (const int beamCount : {18, 36, 72, 360, 3600}) {
+    PrintResult(beamCount, "beams", RunCase(world, poses, beamCount, slam::core::IntegrationMode::kBeams, minSeconds));
+    PrintResult(beamCount, "visibility-polygon",
+                RunCase(world, poses, beamCount, slam::core::IntegrationMode::kVisibilityPolygon, minSeconds));
+  }
+  return 0;
+}
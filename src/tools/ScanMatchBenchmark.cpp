@@ -0,0 +1,196 @@
+/**
+ * @file ScanMatchBenchmark.cpp
+ * @brief Offline cost of branch-and-bound correlative scan matching against an exhaustive search.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/ScanMatcher.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kBeamCount = 360;
+constexpr int kQueryCount = 16;
+constexpr double kFrameBudgetMs = 1000.0 / 60.0;
+
+/**
+ * @brief One world size and lidar range.
+ */
+struct WorldCase {
+  const char* name;
+  int size;
+  double maxRange;
+  int obstacleCount;
+};
+
+/**
+ * @brief One search window.
+ */
+struct WindowCase {
+  int linearWindow;
+  double angularWindow;
+};
+
+/**
+ * @brief A scan with its true pose and a perturbed prediction inside the search window.
+ */
+struct Query {
+  slam::core::RobotPose truth;
+  slam::core::RobotPose predicted;
+  slam::core::ScanBuffer scan;
+};
+
+/**
+ * @brief Square world with border walls and random blocks.
+ */
+slam::core::WorldGrid BuildWorld(const WorldCase& worldCase) {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(worldCase.size, worldCase.size);
+  std::mt19937 rng(static_cast<std::uint32_t>(worldCase.size));
+  std::uniform_int_distribution<int> cornerDist(1, worldCase.size - 12);
+  std::uniform_int_distribution<int> sizeDist(2, 10);
+  for (int i = 0; i < worldCase.obstacleCount; ++i) {
+    world.AddRectangle(cornerDist(rng), cornerDist(rng), sizeDist(rng), sizeDist(rng));
+  }
+  return world;
+}
+
+/**
+ * @brief Map the world from free poses, then pick query poses with predictions inside the window.
+ */
+std::vector<Query> BuildQueries(const slam::core::WorldGrid& world, const slam::core::SimulatedLidar& lidar,
+                                const WindowCase& window, slam::core::OccupancyGridMap& map) {
+  std::mt19937 rng(360U);
+  std::uniform_real_distribution<double> posDist(2.0, static_cast<double>(world.Width() - 2));
+  std::uniform_real_distribution<double> headingDist(-3.14, 3.14);
+  const auto freePose = [&]() {
+    for (;;) {
+      const slam::core::RobotPose pose{posDist(rng), posDist(rng), headingDist(rng)};
+      if (!world.IsObstacle(static_cast<int>(pose.x), static_cast<int>(pose.y))) {
+        return pose;
+      }
+    }
+  };
+  slam::core::ScanBuffer scan;
+  const int mappingScans = (world.Width() * world.Height()) / 400 + 8;
+  for (int i = 0; i < mappingScans; ++i) {
+    const slam::core::RobotPose pose = freePose();
+    lidar.Scan(world, pose, scan);
+    map.IntegrateScan(pose, scan);
+  }
+  const double linear = static_cast<double>(window.linearWindow);
+  std::uniform_real_distribution<double> linearDist(-linear, linear);
+  std::uniform_real_distribution<double> angularDist(-window.angularWindow, window.angularWindow);
+  std::vector<Query> queries(kQueryCount);
+  for (Query& query : queries) {
+    query.truth = freePose();
+    query.predicted = slam::core::RobotPose{
+        query.truth.x + linearDist(rng), query.truth.y + linearDist(rng), query.truth.theta + angularDist(rng)};
+    lidar.Scan(world, query.truth, query.scan);
+  }
+  return queries;
+}
+
+/**
+ * @brief Mean seconds per call of fn, repeated until minSeconds elapse (at least 3 calls).
+ */
+template <typename Fn>
+double TimePerCall(double minSeconds, Fn fn) {
+  long long count = 0;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (count < 3 || elapsed < minSeconds) {
+    fn();
+    ++count;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  return elapsed / static_cast<double>(count);
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Scan match benchmark entrypoint.
+ * @return Process exit code.
+ * @note mean_error_cells is the translation error of the pruned match against the true pose;
+ * scores_match is true when every pruned match scored the same as the exhaustive search.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const WorldCase worlds[] = {{"app", 128, 30.0, 20}, {"large", 512, 60.0, 600}};
+  const WindowCase windows[] = {{4, 0.2}, {12, 0.4}, {24, 0.6}};
+  for (const WorldCase& worldCase : worlds) {
+    const slam::core::WorldGrid world = BuildWorld(worldCase);
+    const slam::core::SimulatedLidar lidar(worldCase.maxRange, kBeamCount, 1.0);
+    for (const WindowCase& window : windows) {
+      slam::core::OccupancyGridMap map(worldCase.size, worldCase.size);
+      map.SetMaintainPyramid(true);
+      std::vector<Query> queries = BuildQueries(world, lidar, window, map);
+      slam::core::CorrelativeScanMatcher matcher(
+          slam::core::ScanMatcherOptions{.linearWindow = window.linearWindow, .angularWindow = window.angularWindow});
+
+      bool scoresMatch = true;
+      double error = 0.0;
+      std::size_t prunedNodes = 0;
+      std::size_t exhaustiveNodes = 0;
+      for (const Query& query : queries) {
+        const slam::core::ScanMatchResult pruned = matcher.Match(map, query.predicted, query.scan);
+        const slam::core::ScanMatchResult exhaustive = matcher.MatchExhaustive(map, query.predicted, query.scan);
+        scoresMatch = scoresMatch && pruned.score == exhaustive.score;
+        error += std::hypot(pruned.pose.x - query.truth.x, pruned.pose.y - query.truth.y);
+        prunedNodes += pruned.nodesVisited;
+        exhaustiveNodes += exhaustive.nodesVisited;
+      }
+      const double prunedMs = TimePerCall(minSeconds, [&]() {
+                                for (const Query& query : queries) {
+                                  matcher.Match(map, query.predicted, query.scan);
+                                }
+                              }) *
+                              1e3 / kQueryCount;
+      const double exhaustiveMs = TimePerCall(minSeconds, [&]() {
+                                    for (const Query& query : queries) {
+                                      matcher.MatchExhaustive(map, query.predicted, query.scan);
+                                    }
+                                  }) *
+                                  1e3 / kQueryCount;
+      std::cout << "{\"world\":\"" << worldCase.name << "\",\"map\":" << worldCase.size << ",\"beams\":" << kBeamCount
+                << ",\"linear_window\":" << window.linearWindow << std::fixed << std::setprecision(2)
+                << ",\"angular_window\":" << window.angularWindow << ",\"bnb_ms\":" << prunedMs
+                << ",\"exhaustive_ms\":" << exhaustiveMs << ",\"frame_budget_ms\":" << kFrameBudgetMs
+                << ",\"bnb_nodes\":" << prunedNodes / kQueryCount << ",\"exhaustive_nodes\":"
+                << exhaustiveNodes / kQueryCount << ",\"mean_error_cells\":" << error / kQueryCount
+                << ",\"scores_match\":" << (scoresMatch ? "true" : "false") << "}\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file ScanPipelineBenchmark.cpp
+ * @brief Offline per-stage timing of the scan, map integration, and pixel conversion pipeline.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/OccupancyGridMap.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+#include "render/Renderer.h"
+
+namespace {
+
+constexpr int kWorldWidth = 120;
+constexpr int kWorldHeight = 80;
+constexpr double kMaxRange = 30.0;
+constexpr double kStepSize = 1.0;
+constexpr int kBeamCount = 3600;
+constexpr int kCellSize = 8;
+
+/**
+ * @brief Accumulated wall time per pipeline stage.
+ */
+struct StageTimes {
+  double scan = 0.0;
+  double integrate = 0.0;
+  double pixels = 0.0;
+  long long frames = 0;
+  /// Sum of the last frame's ray endpoints, equal across pipelines.
+  double checksum = 0.0;
+};
+
+/**
+ * @brief Build the demo world layout without the raylib-backed world loader.
+ */
+slam::core::WorldGrid BuildDemoLayout() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(kWorldWidth, kWorldHeight);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(80, 55, 18, 10);
+  return world;
+}
+
+/**
+ * @brief Rectangular loop through open space driven like the app: half-cell moves, turns only at corners.
+ */
+std::vector<slam::core::RobotPose> BuildDriveTrajectory() {
+  constexpr double kHalfPi = 1.57079632679489661923;
+  const double corners[4][2] = {{10.0, 8.0}, {110.0, 8.0}, {110.0, 72.0}, {10.0, 72.0}};
+  std::vector<slam::core::RobotPose> poses;
+  for (int side = 0; side < 4; ++side) {
+    const double* from = corners[side];
+    const double* to = corners[(side + 1) % 4];
+    const double length = std::abs(to[0] - from[0]) + std::abs(to[1] - from[1]);
+    const double theta = static_cast<double>(side) * kHalfPi;
+    for (double travelled = 0.0; travelled < length; travelled += 0.5) {
+      const double t = travelled / length;
+      poses.push_back({from[0] + (to[0] - from[0]) * t, from[1] + (to[1] - from[1]) * t, theta});
+    }
+  }
+  return poses;
+}
+
+/**
+ * @brief Same path with the heading changing every frame, the worst case for direction caching.
+ */
+std::vector<slam::core::RobotPose> BuildSpinTrajectory() {
+  std::vector<slam::core::RobotPose> poses = BuildDriveTrajectory();
+  for (std::size_t i = 0; i < poses.size(); ++i) {
+    poses[i].theta = static_cast<double>(i) * 0.05;
+  }
+  return poses;
+}
+
+/**
+ * @brief Time one frame stage and add the elapsed seconds to a total.
+ */
+template <typename Fn>
+void TimeStage(double& total, Fn&& fn) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point start = Clock::now();
+  fn();
+  total += std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Array-of-structs pipeline where every stage re-derives endpoints with its own trig.
+ */
+StageTimes RunPerStageTrig(
+    const slam::core::WorldGrid& world, const std::vector<slam::core::RobotPose>& poses, double minSeconds) {
+  const slam::core::SimulatedLidar lidar(kMaxRange, kBeamCount, kStepSize);
+  slam::core::OccupancyGridMap map(kWorldWidth, kWorldHeight);
+  std::vector<slam::core::ScanSample> scan(static_cast<std::size_t>(kBeamCount));
+  std::vector<slam::render::PixelRay> rays;
+  StageTimes times;
+  while (times.scan + times.integrate + times.pixels < minSeconds) {
+    for (const slam::core::RobotPose& pose : poses) {
+      TimeStage(times.scan, [&] { lidar.ScanInto(world, pose, scan); });
+      TimeStage(times.integrate, [&] { map.IntegrateScan(pose, scan); });
+      TimeStage(times.pixels, [&] { slam::render::ScanSamplesToPixels(pose, scan, kCellSize, 0, rays); });
+      ++times.frames;
+    }
+  }
+  for (const slam::render::PixelRay& ray : rays) {
+    times.checksum += ray.end.x + ray.end.y;
+  }
+  return times;
+}
+
+/**
+ * @brief Struct-of-arrays pipeline where the lidar stores endpoints once and later stages read them.
+ */
+StageTimes RunCachedEndpoints(
+    const slam::core::WorldGrid& world, const std::vector<slam::core::RobotPose>& poses, double minSeconds) {
+  const slam::core::SimulatedLidar lidar(kMaxRange, kBeamCount, kStepSize);
+  slam::core::OccupancyGridMap map(kWorldWidth, kWorldHeight);
+  slam::core::ScanBuffer scan(kBeamCount);
+  std::vector<slam::render::PixelRay> rays;
+  StageTimes times;
+  while (times.scan + times.integrate + times.pixels < minSeconds) {
+    for (const slam::core::RobotPose& pose : poses) {
+      TimeStage(times.scan, [&] { lidar.Scan(world, pose, scan); });
+      TimeStage(times.integrate, [&] { map.IntegrateScan(pose, scan); });
+      TimeStage(times.pixels, [&] { slam::render::ScanSamplesToPixels(pose, scan, kCellSize, 0, rays); });
+      ++times.frames;
+    }
+  }
+  for (const slam::render::PixelRay& ray : rays) {
+    times.checksum += ray.end.x + ray.end.y;
+  }
+  return times;
+}
+
+/**
+ * @brief Print one result line as JSON with per-frame stage times in microseconds.
+ */
+void PrintResult(const char* trajectory, const char* pipeline, const StageTimes& times) {
+  const double perFrame = 1e6 / static_cast<double>(times.frames);
+  std::cout << "{\"trajectory\":\"" << trajectory << "\""
+            << ",\"pipeline\":\"" << pipeline << "\""
+            << ",\"beams\":" << kBeamCount
+            << std::fixed << std::setprecision(2)
+            << ",\"scan_us\":" << times.scan * perFrame
+            << ",\"integrate_us\":" << times.integrate * perFrame
+            << ",\"pixels_us\":" << times.pixels * perFrame
+            << ",\"total_us\":" << (times.scan + times.integrate + times.pixels) * perFrame
+            << ",\"checksum\":" << std::setprecision(3) << times.checksum
+            << "}\n";
+}
+
+/**
+ * @brief Print command-line usage.
+ */
+void PrintUsage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " [--min-seconds <seconds>]\n";
+}
+
+}  // namespace
+
+/**
+ * @brief Scan pipeline benchmark entrypoint.
+ * @return Process exit code.
+ */
+int main(int argc, char** argv) {
+  double minSeconds = 0.5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--min-seconds" && i + 1 < argc) {
+      minSeconds = std::atof(argv[++i]);
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  const slam::core::WorldGrid world = BuildDemoLayout();
+  const std::vector<slam::core::RobotPose> drive = BuildDriveTrajectory();
+  const std::vector<slam::core::RobotPose> spin = BuildSpinTrajectory();
+  PrintResult("drive", "per-stage-trig", RunPerStageTrig(world, drive, minSeconds));
+  PrintResult("drive", "cached-endpoints", RunCachedEndpoints(world, drive, minSeconds));
+  PrintResult("spin", "per-stage-trig", RunPerStageTrig(world, spin, minSeconds));
+  PrintResult("spin", "cached-endpoints", RunCachedEndpoints(world, spin, minSeconds));
+  return 0;
+}
@@ -18,6 +18,7 @@ core::WorldGrid BuildDemoWorld(int width, int height) {
   world.AddRectangle(60, 18, 10, 18);
   world.AddRectangle(35, 45, 30, 4);
   world.AddRectangle(80, 55, 18, 10);
+  world.BuildDistanceField();
   return world;
 }
 
@@ -53,6 +54,7 @@ core::WorldGrid BuildWorldFromImage(const std::string& imagePath, int width, int
     UnloadImageColors(pixels);
   }
   UnloadImage(image);
+  world.BuildDistanceField();
   return world;
 }
 
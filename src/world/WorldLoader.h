@@ -12,11 +12,11 @@
 namespace slam::world {
 
 /**
- * @brief Build the fallback demo world layout.
+ * @brief Build the fallback demo world layout with its distance field.
  */
 core::WorldGrid BuildDemoWorld(int width, int height);
 /**
- * @brief Build a world by thresholding a map image.
+ * @brief Build a world by thresholding a map image, then build its distance field.
  */
 core::WorldGrid BuildWorldFromImage(const std::string& imagePath, int width, int height);
 
@@ -38,9 +38,19 @@ void TestConfigDefaultsMatchRef2() {
   ASSERT_TRUE(config.screen.worldCellSize == 8, "cell size must be 8");
   ASSERT_TRUE(config.screen.fps == 60, "fps must be 60");
   ASSERT_TRUE(config.world.showWorldByDefault == false, "world visibility default must be OFF");
+  ASSERT_TRUE(config.world.layout == slam::core::MapLayout::kRowMajor, "clearance field must default to row-major");
   ASSERT_TRUE(config.lidar.maxRange == 30.0F, "lidar max range must be 30");
   ASSERT_TRUE(config.lidar.beamCount == 72, "lidar beam count must be 72");
   ASSERT_TRUE(config.lidar.stepSize == 1.0F, "lidar step size must be 1.0");
+  ASSERT_TRUE(config.lidar.mode == slam::core::LidarMode::kRayMarch, "lidar mode must default to ray march");
+  ASSERT_TRUE(config.lidar.workerThreads == 1, "lidar scanning must default to the main thread");
+  ASSERT_TRUE(config.map.updateMode == slam::core::MapUpdateMode::kOverwrite, "map must default to overwrite updates");
+  ASSERT_TRUE(config.map.deduplicateScanUpdates == false, "per-scan deduplication must default to OFF");
+  ASSERT_TRUE(config.map.integrationMode == slam::core::IntegrationMode::kBeams, "map must default to per-beam integration");
+  ASSERT_TRUE(config.map.layout == slam::core::MapLayout::kRowMajor, "map must default to row-major cells");
+  ASSERT_TRUE(config.tracking.enabled == false, "scan-matching pose tracking must default to OFF");
+  ASSERT_TRUE(config.tracking.odometryNoise == 0.0 && config.tracking.headingNoise == 0.0,
+              "simulated odometry must default to noise-free");
 }
 
 }  // namespace
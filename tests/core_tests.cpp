@@ -1,14 +1,36 @@
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <cstdlib>
 #include <functional>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <random>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "core/BatchedRayMarch.h"
+#include "core/CowOccupancyGridMap.h"
+#include "core/GridIndexer.h"
+#include "core/GridLine.h"
+#include "core/LikelihoodField.h"
+#include "core/OccupancyCell.h"
 #include "core/OccupancyGridMap.h"
+#include "core/PackedOccupancyGridMap.h"
+#include "core/ParticleFilterSlam.h"
+#include "core/ScanBatchBuffer.h"
+#include "core/ScanBuffer.h"
+#include "core/ScanMatcher.h"
 #include "core/SimulatedLidar.h"
+#include "core/SimulatedLidarT.h"
+#include "core/SparseOccupancyGridMap.h"
 #include "core/Types.h"
+#include "core/WorkerPool.h"
 #include "core/WorldGrid.h"
 
 namespace {
@@ -47,6 +69,96 @@ void TestLidarDetectsExpectedWallDistance() {
   ASSERT_TRUE(scan[0].hit, "forward beam must hit obstacle");
 }
 
+void TestGridTraversalReturnsExactSubCellDistance() {
+  slam::core::WorldGrid world(20, 20);
+  world.SetObstacle(8, 5);
+  slam::core::SimulatedLidar lidar(10.0, 4, 1.0, slam::core::LidarMode::kGridTraversal);
+  const slam::core::RobotPose pose{5.5, 5.25, 0.0};
+
+  const std::vector<slam::core::ScanSample> scan = lidar.Scan(world, pose);
+
+  ASSERT_TRUE(scan[0].hit, "forward beam must hit obstacle");
+  ASSERT_TRUE(std::fabs(scan[0].distance - 2.5) < 1e-12, "forward beam must enter cell 8 at 2.5");
+
+  world.SetObstacle(2, 5);
+  const std::vector<slam::core::ScanSample> backScan = lidar.Scan(world, pose);
+  ASSERT_TRUE(backScan[2].hit, "backward beam must hit obstacle");
+  ASSERT_TRUE(std::fabs(backScan[2].distance - 2.5) < 1e-12, "backward beam must enter cell 2 at 2.5");
+}
+
+void TestGridTraversalDoesNotSkipThinWalls() {
+  slam::core::WorldGrid world(20, 20);
+  world.SetObstacle(7, 5);
+  const slam::core::RobotPose pose{5.5, 5.5, 0.0};
+  slam::core::SimulatedLidar coarseMarch(10.0, 1, 3.0);
+  slam::core::SimulatedLidar traversal(10.0, 1, 3.0, slam::core::LidarMode::kGridTraversal);
+
+  const auto marched = coarseMarch.Scan(world, pose);
+  const auto traversed = traversal.Scan(world, pose);
+
+  ASSERT_TRUE(marched[0].distance > 1.5, "coarse ray march is expected to step past the wall");
+  ASSERT_TRUE(traversed[0].hit, "grid traversal must hit the thin wall");
+  ASSERT_TRUE(std::fabs(traversed[0].distance - 1.5) < 1e-12, "grid traversal must report wall entry distance");
+}
+
+void TestGridTraversalMatchesFineRayMarch() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(40, 30);
+  world.AddRectangle(10, 6, 6, 3);
+  world.AddRectangle(24, 14, 3, 9);
+  constexpr double kFineStep = 0.001;
+  slam::core::SimulatedLidar fineMarch(25.0, 90, kFineStep);
+  slam::core::SimulatedLidar traversal(25.0, 90, kFineStep, slam::core::LidarMode::kGridTraversal);
+  const slam::core::RobotPose pose{17.3, 12.6, 0.4};
+
+  const auto marched = fineMarch.Scan(world, pose);
+  const auto traversed = traversal.Scan(world, pose);
+
+  for (std::size_t i = 0; i < marched.size(); ++i) {
+    ASSERT_TRUE(marched[i].hit == traversed[i].hit, "hit flags must agree with a fine ray march");
+    ASSERT_TRUE(traversed[i].distance <= marched[i].distance + 1e-9, "traversal must not overshoot the march");
+    ASSERT_TRUE(marched[i].distance - traversed[i].distance <= kFineStep + 1e-9,
+                "traversal distance must be within one fine step of the march");
+  }
+}
+
+void TestDistanceFieldMeasuresClearanceToNearestObstacle() {
+  slam::core::WorldGrid world(20, 20);
+  world.SetObstacle(10, 10);
+  world.BuildDistanceField();
+
+  ASSERT_TRUE(world.HasDistanceField(), "distance field must be available after build");
+  ASSERT_TRUE(world.ClearanceAt(10, 10) == 0.0, "obstacle cell clearance must be zero");
+  ASSERT_TRUE(std::fabs(world.ClearanceAt(10, 13) - 3.0) < 1e-6, "axis-aligned clearance mismatch");
+  ASSERT_TRUE(std::fabs(world.ClearanceAt(13, 14) - 5.0) < 1e-6, "diagonal clearance mismatch");
+  ASSERT_TRUE(std::fabs(world.ClearanceAt(0, 5) - 1.0) < 1e-6, "outside of the grid must count as obstacle");
+
+  world.SetObstacle(3, 3);
+  ASSERT_TRUE(!world.HasDistanceField(), "editing obstacles must invalidate the distance field");
+}
+
+void TestSphereTraceMatchesGridTraversal() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(60, 40);
+  world.AddRectangle(10, 6, 6, 3);
+  world.AddRectangle(30, 14, 2, 15);
+  world.AddRectangle(44, 30, 9, 4);
+  world.SetObstacle(22, 22);
+  world.BuildDistanceField();
+  slam::core::SimulatedLidar traversal(30.0, 360, 1.0, slam::core::LidarMode::kGridTraversal);
+  slam::core::SimulatedLidar sphereTrace(30.0, 360, 1.0, slam::core::LidarMode::kSphereTrace);
+
+  for (const slam::core::RobotPose pose : {slam::core::RobotPose{5.5, 5.5, 0.0},
+                                           slam::core::RobotPose{20.25, 20.75, 1.1},
+                                           slam::core::RobotPose{40.6, 10.1, -2.3}}) {
+    const auto expected = traversal.Scan(world, pose);
+    const auto actual = sphereTrace.Scan(world, pose);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_TRUE(expected[i].hit == actual[i].hit, "sphere trace hit flags must match traversal");
+      ASSERT_TRUE(std::fabs(expected[i].distance - actual[i].distance) < 1e-9,
+                  "sphere trace distances must match traversal");
+    }
+  }
+}
+
 void TestOccupancyGridMarksFreeAndHitCells() {
   slam::core::OccupancyGridMap map(20, 20);
   slam::core::RobotPose pose{5.0F, 5.0F, 0.0F};
@@ -59,6 +171,1327 @@ void TestOccupancyGridMarksFreeAndHitCells() {
   ASSERT_TRUE(map.ValueAt(8, 5) == slam::core::kOccupied, "cell (8,5) must be occupied");
 }
 
+void TestClippedGridLineMatchesFilteredBresenham() {
+  std::mt19937 rng(77U);
+  std::uniform_int_distribution<int> coordinate(-30, 30);
+  for (int trial = 0; trial < 4000; ++trial) {
+    const int x0 = coordinate(rng);
+    const int y0 = coordinate(rng);
+    const int x1 = coordinate(rng);
+    const int y1 = coordinate(rng);
+    const int xa = coordinate(rng);
+    const int xb = coordinate(rng);
+    const int ya = coordinate(rng);
+    const int yb = coordinate(rng);
+    const slam::core::GridRect clip{
+        .xBegin = std::min(xa, xb), .yBegin = std::min(ya, yb), .xEnd = std::max(xa, xb), .yEnd = std::max(ya, yb)};
+    const int length = slam::core::GridLineLength(x0, y0, x1, y1);
+    const int stepBegin = trial % 3;
+    const int stepEnd = length + 1 - (trial % 2);
+
+    // Reference: classic all-octant loop, filtered per cell.
+    std::vector<std::pair<int, int>> expected;
+    int x = x0;
+    int y = y0;
+    const int dx = std::abs(x1 - x0);
+    const int dy = std::abs(y1 - y0);
+    int err = dx - dy;
+    for (int step = 0;; ++step) {
+      if (step >= stepBegin && step < stepEnd && x >= clip.xBegin && x < clip.xEnd && y >= clip.yBegin &&
+          y < clip.yEnd) {
+        expected.emplace_back(x, y);
+      }
+      if (x == x1 && y == y1) {
+        break;
+      }
+      const int errTwice = 2 * err;
+      if (errTwice > -dy) {
+        err -= dy;
+        x += (x0 < x1) ? 1 : -1;
+      }
+      if (errTwice < dx) {
+        err += dx;
+        y += (y0 < y1) ? 1 : -1;
+      }
+    }
+
+    std::vector<std::pair<int, int>> visited;
+    slam::core::VisitGridLine(
+        x0, y0, x1, y1, stepBegin, stepEnd, clip, [&](int cx, int cy) { visited.emplace_back(cx, cy); });
+    ASSERT_TRUE(visited == expected, "clipped visitor must match the filtered Bresenham line");
+  }
+
+  std::vector<std::pair<int, int>> whole;
+  slam::core::VisitGridLine(3, 1, -2, 4, [&](int cx, int cy) { whole.emplace_back(cx, cy); });
+  ASSERT_TRUE(whole.size() == 6U && whole.front() == std::make_pair(3, 1) && whole.back() == std::make_pair(-2, 4),
+              "unclipped visitor must include both ends");
+}
+
+void TestLogOddsOccupancyAccumulatesAndClamps() {
+  const slam::core::LogOddsParams params{};
+  slam::core::OccupancyGridMap map(200, 20, slam::core::MapUpdateMode::kLogOdds, params);
+  const slam::core::RobotPose pose{5.0, 5.0, 0.0};
+  const std::vector<slam::core::ScanSample> wallHit{
+      slam::core::ScanSample{.relativeAngle = 0.0, .distance = 3.0, .hit = true}};
+  ASSERT_TRUE(map.ValueAt(8, 5) == 0 && map.ClassifiedValueAt(8, 5) == slam::core::kUnknown, "cells must start unknown");
+
+  map.IntegrateScan(pose, wallHit);
+  ASSERT_TRUE(map.ValueAt(5, 5) == 0, "robot cell must not be updated");
+  ASSERT_TRUE(map.ValueAt(6, 5) == -params.missDecrement, "ray cells must take one miss");
+  ASSERT_TRUE(map.ValueAt(8, 5) == params.hitIncrement, "end cell must take one hit");
+  ASSERT_TRUE(map.ClassifiedValueAt(7, 5) == slam::core::kFree, "one miss must classify as free");
+  ASSERT_TRUE(map.ClassifiedValueAt(8, 5) == slam::core::kOccupied, "one hit must classify as occupied");
+
+  for (int i = 0; i < 20; ++i) {
+    map.IntegrateScan(pose, wallHit);
+  }
+  ASSERT_TRUE(map.ValueAt(7, 5) == params.clampMin, "misses must clamp at clampMin");
+  ASSERT_TRUE(map.ValueAt(8, 5) == params.clampMax, "hits must clamp at clampMax");
+
+  // One noisy beam through the wall must not erase it, unlike the overwrite update.
+  const std::vector<slam::core::ScanSample> noisyMiss{
+      slam::core::ScanSample{.relativeAngle = 0.0, .distance = 150.0, .hit = false}};
+  map.IntegrateScan(pose, noisyMiss);
+  ASSERT_TRUE(map.ClassifiedValueAt(8, 5) == slam::core::kOccupied, "one miss must not clear a confirmed wall");
+  for (int x = 9; x <= 155; ++x) {
+    ASSERT_TRUE(map.ValueAt(x, 5) == -params.missDecrement, "every cell of a long ray must take exactly one miss");
+  }
+  slam::core::OccupancyGridMap overwrite(200, 20);
+  overwrite.IntegrateScan(pose, wallHit);
+  overwrite.IntegrateScan(pose, noisyMiss);
+  ASSERT_TRUE(overwrite.ClassifiedValueAt(8, 5) == slam::core::kFree, "overwrite mode clears the wall on one miss");
+
+  map.Reset();
+  ASSERT_TRUE(map.ValueAt(8, 5) == 0, "reset must return log-odds cells to 0");
+
+  bool threw = false;
+  try {
+    slam::core::OccupancyGridMap invalid(
+        10, 10, slam::core::MapUpdateMode::kLogOdds, slam::core::LogOddsParams{.occupiedThreshold = -50});
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_TRUE(threw, "thresholds out of order must be rejected");
+}
+
+void TestScanDeduplicationUpdatesEachCellOncePerScan() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(120, 80);
+  world.AddRectangle(60, 18, 10, 18);
+  const slam::core::SimulatedLidar lidar(30.0, 3600, 1.0);
+  const slam::core::RobotPose pose{50.5, 30.5, 0.3};
+  slam::core::ScanBuffer scan;
+  lidar.Scan(world, pose, scan);
+
+  const slam::core::LogOddsParams params{};
+  slam::core::OccupancyGridMap repeated(120, 80, slam::core::MapUpdateMode::kLogOdds, params);
+  slam::core::OccupancyGridMap deduplicated(120, 80, slam::core::MapUpdateMode::kLogOdds, params);
+  deduplicated.SetDeduplicateScanUpdates(true);
+  repeated.IntegrateScan(pose, scan);
+  deduplicated.IntegrateScan(pose, scan);
+
+  ASSERT_TRUE(repeated.ValueAt(51, 30) == params.clampMin, "shared near-robot cells take one miss per beam");
+  for (int y = 0; y < 80; ++y) {
+    for (int x = 0; x < 120; ++x) {
+      const int value = deduplicated.ValueAt(x, y);
+      ASSERT_TRUE(value == 0 || value == -params.missDecrement || value == params.hitIncrement ||
+                      value == params.hitIncrement - params.missDecrement,
+                  "deduplicated cells take at most one miss and one hit per scan");
+      ASSERT_TRUE((value == 0) == (repeated.ValueAt(x, y) == 0), "deduplication must touch the same cells");
+    }
+  }
+  deduplicated.IntegrateScan(pose, scan);
+  ASSERT_TRUE(deduplicated.ValueAt(51, 30) == -2 * params.missDecrement, "a new scan must update cells again");
+
+  slam::core::WorkerPool pool(3);
+  slam::core::OccupancyGridMap parallel(120, 80, slam::core::MapUpdateMode::kLogOdds, params);
+  parallel.SetDeduplicateScanUpdates(true);
+  parallel.IntegrateScan(pose, scan, pool);
+  parallel.IntegrateScan(pose, scan, pool);
+  ASSERT_TRUE(parallel.Data() == deduplicated.Data(), "band-parallel deduplication must match serial");
+}
+
+void TestVisibilityPolygonFillsRoomOncePerScan() {
+  const slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(40, 30);
+  const slam::core::RobotPose pose{20.5, 15.5, 0.2};
+  const auto countFree = [](const slam::core::OccupancyGridMap& map) {
+    int count = 0;
+    for (int y = 0; y < map.Height(); ++y) {
+      for (int x = 0; x < map.Width(); ++x) {
+        count += (map.ClassifiedValueAt(x, y) == slam::core::kFree) ? 1 : 0;
+      }
+    }
+    return count;
+  };
+
+  const slam::core::SimulatedLidar sparseLidar(60.0, 36, 1.0);
+  slam::core::ScanBuffer sparse;
+  sparseLidar.Scan(world, pose, sparse);
+  slam::core::OccupancyGridMap beams(40, 30);
+  slam::core::OccupancyGridMap polygon(40, 30);
+  polygon.SetIntegrationMode(slam::core::IntegrationMode::kVisibilityPolygon);
+  beams.IntegrateScan(pose, sparse);
+  polygon.IntegrateScan(pose, sparse);
+
+  const int interior = 38 * 28;
+  ASSERT_TRUE(countFree(polygon) * 100 >= interior * 95, "polygon fill must cover the room interior");
+  ASSERT_TRUE(countFree(beams) * 2 < countFree(polygon), "36 beams must leave gaps that the polygon covers");
+  for (int y = 0; y < 30; ++y) {
+    for (int x = 0; x < 40; ++x) {
+      ASSERT_TRUE(!(world.IsObstacle(x, y) && polygon.ClassifiedValueAt(x, y) == slam::core::kFree),
+                  "polygon fill must not free wall cells");
+    }
+  }
+  ASSERT_TRUE(polygon.ValueAt(20, 15) == slam::core::kUnknown, "robot cell must not be freed");
+
+  const std::vector<slam::core::ScanSample> samples = sparseLidar.Scan(world, pose);
+  slam::core::OccupancyGridMap fromSamples(40, 30);
+  fromSamples.SetIntegrationMode(slam::core::IntegrationMode::kVisibilityPolygon);
+  fromSamples.IntegrateScan(pose, samples);
+  ASSERT_TRUE(fromSamples.Data() == polygon.Data(), "sample and buffer scans must fill the same polygon");
+
+  const slam::core::SimulatedLidar denseLidar(60.0, 3600, 1.0);
+  slam::core::ScanBuffer dense;
+  denseLidar.Scan(world, pose, dense);
+  const slam::core::LogOddsParams params{};
+  slam::core::OccupancyGridMap logOdds(40, 30, slam::core::MapUpdateMode::kLogOdds, params);
+  logOdds.SetIntegrationMode(slam::core::IntegrationMode::kVisibilityPolygon);
+  logOdds.IntegrateScan(pose, dense);
+  for (const std::int16_t value : logOdds.Data()) {
+    ASSERT_TRUE(value == 0 || value == -params.missDecrement || value == params.hitIncrement,
+                "polygon fill must update each cell at most once per scan");
+  }
+
+  slam::core::WorkerPool pool(3);
+  slam::core::OccupancyGridMap parallel(40, 30, slam::core::MapUpdateMode::kLogOdds, params);
+  parallel.SetIntegrationMode(slam::core::IntegrationMode::kVisibilityPolygon);
+  parallel.IntegrateScan(pose, dense, pool);
+  ASSERT_TRUE(parallel.Data() == logOdds.Data(), "band-parallel polygon fill must match serial");
+}
+
+void TestVisibilityPolygonKeepsOccludersOccupied() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(80, 60);
+  world.AddRectangle(35, 25, 10, 10);
+  const slam::core::SimulatedLidar lidar(60.0, 36, 1.0);
+  int polygonFreed = 0;
+  int beamFreed = 0;
+  for (int k = 0; k < 72; ++k) {
+    const double angle = k * std::numbers::pi / 36.0;
+    const double radius = 12.0 + (k % 3) * 7.0;
+    const slam::core::RobotPose pose{40.3 + radius * std::cos(angle), 30.1 + 0.8 * radius * std::sin(angle), angle};
+    slam::core::ScanBuffer scan;
+    lidar.Scan(world, pose, scan);
+    slam::core::OccupancyGridMap beams(80, 60);
+    slam::core::OccupancyGridMap polygon(80, 60);
+    polygon.SetIntegrationMode(slam::core::IntegrationMode::kVisibilityPolygon);
+    beams.IntegrateScan(pose, scan);
+    polygon.IntegrateScan(pose, scan);
+    for (int y = 25; y < 35; ++y) {
+      for (int x = 35; x < 45; ++x) {
+        const bool freed = polygon.ClassifiedValueAt(x, y) == slam::core::kFree;
+        const bool outerRing = x == 35 || x == 44 || y == 25 || y == 34;
+        ASSERT_TRUE(!(freed && !outerRing), "polygon fill must not cut through the occluder");
+        polygonFreed += freed ? 1 : 0;
+        beamFreed += (beams.ClassifiedValueAt(x, y) == slam::core::kFree) ? 1 : 0;
+      }
+    }
+  }
+  ASSERT_TRUE(polygonFreed <= beamFreed, "polygon fill must not free more occluder cells than per-beam lines");
+}
+
+void TestTiledAndMortonLayoutsMatchRowMajor() {
+  // 53x37 leaves partial tiles on the right and bottom edges and pads Morton storage to 64x64.
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(53, 37);
+  world.AddRectangle(30, 8, 5, 12);
+  const slam::core::SimulatedLidar lidar(40.0, 360, 1.0);
+  const std::vector<slam::core::RobotPose> poses{{12.5, 10.5, 0.0}, {40.2, 28.7, 1.3}, {20.1, 30.4, 2.6}};
+  const slam::core::LogOddsParams params{};
+  slam::core::WorkerPool pool(3);
+
+  for (const auto& [layout, storageSize] : {std::pair{slam::core::MapLayout::kTiled, std::size_t{64U * 48U}},
+                                            std::pair{slam::core::MapLayout::kMorton, std::size_t{64U * 64U}}}) {
+    for (const slam::core::MapUpdateMode mode : {slam::core::MapUpdateMode::kOverwrite, slam::core::MapUpdateMode::kLogOdds}) {
+      for (const slam::core::IntegrationMode integration :
+           {slam::core::IntegrationMode::kBeams, slam::core::IntegrationMode::kVisibilityPolygon}) {
+        slam::core::OccupancyGridMap rowMajor(53, 37, mode, params);
+        slam::core::OccupancyGridMap reordered(53, 37, mode, params);
+        slam::core::OccupancyGridMap reorderedParallel(53, 37, mode, params);
+        reordered.SetLayout(layout);
+        reorderedParallel.SetLayout(layout);
+        for (slam::core::OccupancyGridMap* map : {&rowMajor, &reordered, &reorderedParallel}) {
+          map->SetIntegrationMode(integration);
+          map->SetDeduplicateScanUpdates(true);
+        }
+        ASSERT_TRUE(reordered.Data().size() == storageSize, "storage must be padded to whole tiles or power-of-two sides");
+
+        slam::core::ScanBuffer scan;
+        for (const slam::core::RobotPose& pose : poses) {
+          lidar.Scan(world, pose, scan);
+          rowMajor.IntegrateScan(pose, scan);
+          reordered.IntegrateScan(pose, scan);
+          reorderedParallel.IntegrateScan(pose, scan, pool);
+        }
+        for (int y = 0; y < 37; ++y) {
+          for (int x = 0; x < 53; ++x) {
+            ASSERT_TRUE(reordered.ValueAt(x, y) == rowMajor.ValueAt(x, y), "cells must match row-major cells in every layout");
+            ASSERT_TRUE(reorderedParallel.ValueAt(x, y) == rowMajor.ValueAt(x, y), "band-parallel cells must match in every layout");
+          }
+        }
+
+        reordered.SetLayout(slam::core::MapLayout::kRowMajor);
+        ASSERT_TRUE(reordered.Data() == rowMajor.Data(), "switching layouts must carry every cell over");
+      }
+    }
+  }
+}
+
+void TestMortonIndexingIsDenseAndMatchesBitInterleave() {
+  std::mt19937 rng(21U);
+  std::uniform_int_distribution<std::uint32_t> valueDist;
+  for (int i = 0; i < 1000; ++i) {
+    const std::uint32_t x = valueDist(rng);
+    const std::uint32_t y = valueDist(rng);
+    std::uint64_t expected = 0;
+    for (unsigned bit = 0; bit < 32U; ++bit) {
+      expected |= static_cast<std::uint64_t>((x >> bit) & 1U) << (2U * bit);
+      expected |= static_cast<std::uint64_t>((y >> bit) & 1U) << (2U * bit + 1U);
+    }
+    ASSERT_TRUE(slam::core::MortonEncode(x, y) == expected, "Morton code must interleave x and y bits");
+  }
+
+  // Every layout must map each cell to its own slot inside the storage, including non-square
+  // and non-power-of-two grids.
+  for (const auto& [width, height] : {std::pair{1, 1}, std::pair{16, 16}, std::pair{53, 37}, std::pair{300, 7}, std::pair{5, 130}}) {
+    for (const slam::core::MapLayout layout :
+         {slam::core::MapLayout::kRowMajor, slam::core::MapLayout::kTiled, slam::core::MapLayout::kMorton}) {
+      const slam::core::GridIndexer indexer(layout, width, height);
+      const auto cells = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+      const auto roundUp = [](int side, unsigned multiple) {
+        return (static_cast<std::size_t>(side) + multiple - 1U) / multiple * multiple;
+      };
+      std::size_t expectedSize = cells;
+      if (layout == slam::core::MapLayout::kTiled) {
+        expectedSize = roundUp(width, 16U) * roundUp(height, 16U);
+      } else if (layout == slam::core::MapLayout::kMorton) {
+        expectedSize = std::bit_ceil(static_cast<std::size_t>(width)) * std::bit_ceil(static_cast<std::size_t>(height));
+        ASSERT_TRUE(expectedSize <= 4U * cells, "Morton padding must stay within 4x the cell count");
+      }
+      ASSERT_TRUE(indexer.StorageSize() == expectedSize, "storage must pad each side only to its tile or power of two");
+      std::vector<bool> used(indexer.StorageSize(), false);
+      for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+          const std::size_t index = indexer.Index(x, y);
+          ASSERT_TRUE(index < used.size() && !used[index], "cell indices must be distinct and in range");
+          used[index] = true;
+        }
+      }
+    }
+  }
+  ASSERT_TRUE(slam::core::GridIndexer(slam::core::MapLayout::kMorton, 300, 7).StorageSize() == 512U * 8U,
+              "Morton storage must round each side up on its own");
+  ASSERT_TRUE(slam::core::GridIndexer(slam::core::MapLayout::kMorton, 4, 4).Index(1, 2) == 9U,
+              "Morton index of (1, 2) is 0b1001");
+
+  // The world clearance field reads the same in every layout, whether moved or built in place.
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(45, 29);
+  world.AddRectangle(20, 8, 4, 10);
+  world.BuildDistanceField();
+  slam::core::WorldGrid morton = world;
+  morton.SetLayout(slam::core::MapLayout::kMorton);
+  slam::core::WorldGrid builtMorton = slam::core::WorldGrid::WithBorderWalls(45, 29);
+  builtMorton.AddRectangle(20, 8, 4, 10);
+  builtMorton.SetLayout(slam::core::MapLayout::kMorton);
+  builtMorton.BuildDistanceField();
+  ASSERT_TRUE(morton.Layout() == slam::core::MapLayout::kMorton, "layout must be reported");
+  for (int y = 0; y < 29; ++y) {
+    for (int x = 0; x < 45; ++x) {
+      ASSERT_TRUE(morton.ClearanceAt(x, y) == world.ClearanceAt(x, y), "moved clearance must match");
+      ASSERT_TRUE(builtMorton.ClearanceAt(x, y) == world.ClearanceAt(x, y), "Morton-built clearance must match");
+    }
+  }
+  const slam::core::SimulatedLidar sphereTrace(30.0, 360, 1.0, slam::core::LidarMode::kSphereTrace);
+  const slam::core::RobotPose pose{10.5, 12.5, 0.3};
+  const std::vector<slam::core::ScanSample> expected = sphereTrace.Scan(world, pose);
+  const std::vector<slam::core::ScanSample> actual = sphereTrace.Scan(morton, pose);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_TRUE(actual[i].distance == expected[i].distance && actual[i].hit == expected[i].hit,
+                "sphere trace must not depend on the clearance layout");
+  }
+}
+
+void TestDirtyRegionsTrackChangedCells() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(70, 45);
+  world.AddRectangle(30, 10, 6, 20);
+  const slam::core::SimulatedLidar lidar(25.0, 180, 1.0);
+  const std::vector<slam::core::RobotPose> poses{{10.5, 10.5, 0.0}, {12.5, 30.2, 0.7}, {55.3, 35.1, 2.0}};
+  slam::core::WorkerPool pool(3);
+
+  for (const slam::core::MapUpdateMode mode : {slam::core::MapUpdateMode::kOverwrite, slam::core::MapUpdateMode::kLogOdds}) {
+    slam::core::OccupancyGridMap map(70, 45, mode);
+    slam::core::OccupancyGridMap parallel(70, 45, mode);
+    parallel.SetLayout(slam::core::MapLayout::kTiled);
+    std::vector<slam::core::GridRect> regions;
+    std::vector<slam::core::GridRect> parallelRegions;
+    ASSERT_TRUE(map.ConsumeDirtyRegions(regions).xEnd == 0 && regions.empty(), "a new map must start clean");
+
+    // A mirror refreshed only inside the consumed regions must track the map exactly.
+    std::vector<std::int16_t> mirror(70U * 45U, map.ValueAt(0, 0));
+    slam::core::ScanBuffer scan;
+    for (const slam::core::RobotPose& pose : poses) {
+      lidar.Scan(world, pose, scan);
+      map.IntegrateScan(pose, scan);
+      parallel.IntegrateScan(pose, scan, pool);
+      const slam::core::GridRect bounds = map.ConsumeDirtyRegions(regions);
+      parallel.ConsumeDirtyRegions(parallelRegions);
+      ASSERT_TRUE(!regions.empty(), "a scan of new ground must dirty tiles");
+      ASSERT_TRUE(regions.size() == parallelRegions.size(), "band-parallel scans must dirty the same tiles");
+      for (std::size_t i = 0; i < regions.size(); ++i) {
+        const slam::core::GridRect& region = regions[i];
+        ASSERT_TRUE(region.xBegin == parallelRegions[i].xBegin && region.yBegin == parallelRegions[i].yBegin &&
+                        region.xEnd == parallelRegions[i].xEnd && region.yEnd == parallelRegions[i].yEnd,
+                    "band-parallel dirty regions mismatch");
+        ASSERT_TRUE(region.xBegin >= bounds.xBegin && region.yBegin >= bounds.yBegin && region.xEnd <= bounds.xEnd &&
+                        region.yEnd <= bounds.yEnd && region.xEnd <= 70 && region.yEnd <= 45,
+                    "regions must lie inside the bounding box and the map");
+        for (int y = region.yBegin; y < region.yEnd; ++y) {
+          for (int x = region.xBegin; x < region.xEnd; ++x) {
+            mirror[static_cast<std::size_t>(y * 70 + x)] = map.ValueAt(x, y);
+          }
+        }
+      }
+      for (int y = 0; y < 45; ++y) {
+        for (int x = 0; x < 70; ++x) {
+          ASSERT_TRUE(mirror[static_cast<std::size_t>(y * 70 + x)] == map.ValueAt(x, y),
+                      "every changed cell must fall in a dirty region");
+        }
+      }
+    }
+
+    if (mode == slam::core::MapUpdateMode::kOverwrite) {
+      // Polygon fills update each cell once per scan, so a repeated scan changes no value.
+      slam::core::OccupancyGridMap polygon(70, 45, mode);
+      polygon.SetIntegrationMode(slam::core::IntegrationMode::kVisibilityPolygon);
+      polygon.IntegrateScan(poses.back(), scan);
+      ASSERT_TRUE(polygon.ConsumeDirtyRegions(regions).xEnd > 0, "first polygon scan must dirty tiles");
+      polygon.IntegrateScan(poses.back(), scan);
+      ASSERT_TRUE(polygon.ConsumeDirtyRegions(regions).xEnd == 0 && regions.empty(),
+                  "repeating a scan that changes nothing must leave nothing dirty");
+    }
+
+    // A copy keeps the tiles still pending on the original and owns its cells from then on.
+    const slam::core::RobotPose unseen{45.5, 38.5, 1.0};
+    lidar.Scan(world, unseen, scan);
+    map.IntegrateScan(unseen, scan);
+    slam::core::OccupancyGridMap copy = map;
+    map.ConsumeDirtyRegions(regions);
+    copy.ConsumeDirtyRegions(parallelRegions);
+    ASSERT_TRUE(!regions.empty() && regions.size() == parallelRegions.size(), "a copy must keep pending dirty tiles");
+    const std::vector<std::int16_t> cells = map.Data();
+    ASSERT_TRUE(copy.Data() == cells && copy.Stats().freeCells == map.Stats().freeCells, "a copy must carry every cell and count");
+    copy.Reset();
+    copy.IntegrateScan(poses.front(), scan);
+    ASSERT_TRUE(map.Data() == cells, "writing a copy must leave the original untouched");
+
+    map.Reset();
+    int covered = 0;
+    map.ConsumeDirtyRegions(regions);
+    for (const slam::core::GridRect& region : regions) {
+      covered += (region.xEnd - region.xBegin) * (region.yEnd - region.yBegin);
+    }
+    ASSERT_TRUE(covered == 70 * 45, "reset must dirty the whole map exactly once");
+    ASSERT_TRUE(regions.size() == 3U, "whole tile rows must merge into one region each");
+  }
+}
+
+void TestMapStatsMatchFullRecount() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(90, 60);
+  world.AddRectangle(40, 15, 8, 25);
+  const slam::core::SimulatedLidar lidar(35.0, 240, 1.0);
+  const std::vector<slam::core::RobotPose> poses{{12.5, 12.5, 0.0}, {20.2, 45.6, 0.9}, {70.4, 30.3, 2.4}, {12.5, 12.5, 0.0}};
+  // Hit and miss steps of one cell each let log-odds cells cross both thresholds back and forth.
+  const slam::core::LogOddsParams flippy{.hitIncrement = 60, .missDecrement = 60, .clampMin = -120, .clampMax = 120,
+                                         .occupiedThreshold = 50, .freeThreshold = -50};
+  slam::core::WorkerPool pool(3);
+  const auto checkStats = [](const slam::core::OccupancyGridMap& map) {
+    std::size_t freeCells = 0;
+    std::size_t occupiedCells = 0;
+    for (int y = 0; y < map.Height(); ++y) {
+      for (int x = 0; x < map.Width(); ++x) {
+        freeCells += (map.ClassifiedValueAt(x, y) == slam::core::kFree) ? 1U : 0U;
+        occupiedCells += (map.ClassifiedValueAt(x, y) == slam::core::kOccupied) ? 1U : 0U;
+      }
+    }
+    const slam::core::MapStats stats = map.Stats();
+    ASSERT_TRUE(stats.totalCells == static_cast<std::size_t>(map.Width() * map.Height()), "total cell count mismatch");
+    ASSERT_TRUE(stats.freeCells == freeCells, "free counter must match a full recount");
+    ASSERT_TRUE(stats.occupiedCells == occupiedCells, "occupied counter must match a full recount");
+    ASSERT_TRUE(stats.knownCells == freeCells + occupiedCells, "known counter must be free plus occupied");
+    ASSERT_TRUE(std::abs(stats.exploredFraction - static_cast<double>(stats.knownCells) /
+                                                      static_cast<double>(stats.totalCells)) < 1e-12,
+                "explored fraction must be known over total");
+  };
+
+  for (const slam::core::MapUpdateMode mode : {slam::core::MapUpdateMode::kOverwrite, slam::core::MapUpdateMode::kLogOdds}) {
+    for (const slam::core::IntegrationMode integration :
+         {slam::core::IntegrationMode::kBeams, slam::core::IntegrationMode::kVisibilityPolygon}) {
+      slam::core::OccupancyGridMap serial(90, 60, mode, flippy);
+      slam::core::OccupancyGridMap parallel(90, 60, mode, flippy);
+      serial.SetIntegrationMode(integration);
+      parallel.SetIntegrationMode(integration);
+      parallel.SetDeduplicateScanUpdates(true);
+      checkStats(serial);
+      slam::core::ScanBuffer scan;
+      for (const slam::core::RobotPose& pose : poses) {
+        lidar.Scan(world, pose, scan);
+        serial.IntegrateScan(pose, scan);
+        serial.IntegrateScan(pose, lidar.Scan(world, pose));
+        parallel.IntegrateScan(pose, scan, pool);
+        checkStats(serial);
+        checkStats(parallel);
+      }
+      ASSERT_TRUE(serial.Stats().freeCells > 0 && serial.Stats().occupiedCells > 0, "scans must classify cells");
+      parallel.SetLayout(slam::core::MapLayout::kTiled);
+      checkStats(parallel);
+      serial.Reset();
+      checkStats(serial);
+      ASSERT_TRUE(serial.Stats().knownCells == 0 && serial.Stats().exploredFraction == 0.0, "reset must clear counters");
+    }
+  }
+}
+
+void TestMapPyramidMatchesBruteForceBlockMax() {
+  // Odd sides exercise the clipped blocks on the right and bottom edges of every level.
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(53, 37);
+  world.AddRectangle(30, 8, 5, 17);
+  const slam::core::SimulatedLidar lidar(30.0, 180, 1.0);
+  const std::vector<slam::core::RobotPose> poses{{10.5, 10.5, 0.0}, {44.3, 30.2, 1.7}, {20.1, 28.4, 0.4}, {10.5, 10.5, 0.0}};
+  const slam::core::LogOddsParams flippy{.hitIncrement = 60, .missDecrement = 60, .clampMin = -120, .clampMax = 120,
+                                         .occupiedThreshold = 50, .freeThreshold = -50};
+  slam::core::WorkerPool pool(3);
+  const auto checkPyramid = [](const slam::core::OccupancyGridMap& map) {
+    ASSERT_TRUE(map.PyramidLevels() == 7, "53x37 needs levels down to 1x1");
+    for (int level = 0; level < map.PyramidLevels(); ++level) {
+      const int block = 1 << level;
+      for (int y = 0; y < (map.Height() + block - 1) / block; ++y) {
+        for (int x = 0; x < (map.Width() + block - 1) / block; ++x) {
+          std::int16_t largest = std::numeric_limits<std::int16_t>::min();
+          bool occupied = false;
+          for (int cellY = y * block; cellY < std::min((y + 1) * block, map.Height()); ++cellY) {
+            for (int cellX = x * block; cellX < std::min((x + 1) * block, map.Width()); ++cellX) {
+              largest = std::max(largest, map.ValueAt(cellX, cellY));
+              occupied = occupied || map.ClassifiedValueAt(cellX, cellY) == slam::core::kOccupied;
+            }
+          }
+          ASSERT_TRUE(map.PooledValueAt(level, x, y) == largest, "pooled value must be the block max");
+          ASSERT_TRUE(map.AnyOccupied(level, x, y) == occupied, "block occupancy must match its cells");
+        }
+      }
+      ASSERT_TRUE(!map.AnyOccupied(level, -1, 0) && !map.AnyOccupied(level, 0, map.Height()),
+                  "blocks outside the map are never occupied");
+    }
+  };
+
+  for (const slam::core::MapUpdateMode mode : {slam::core::MapUpdateMode::kOverwrite, slam::core::MapUpdateMode::kLogOdds}) {
+    for (const slam::core::IntegrationMode integration :
+         {slam::core::IntegrationMode::kBeams, slam::core::IntegrationMode::kVisibilityPolygon}) {
+      slam::core::OccupancyGridMap serial(53, 37, mode, flippy);
+      slam::core::OccupancyGridMap parallel(53, 37, mode, flippy);
+      slam::core::OccupancyGridMap late(53, 37, mode, flippy);
+      serial.SetIntegrationMode(integration);
+      parallel.SetIntegrationMode(integration);
+      late.SetIntegrationMode(integration);
+      ASSERT_TRUE(serial.PyramidLevels() == 1, "no pyramid is kept by default");
+      serial.SetMaintainPyramid(true);
+      parallel.SetMaintainPyramid(true);
+      parallel.SetLayout(slam::core::MapLayout::kMorton);
+      checkPyramid(serial);
+      slam::core::ScanBuffer scan;
+      for (const slam::core::RobotPose& pose : poses) {
+        lidar.Scan(world, pose, scan);
+        serial.IntegrateScan(pose, scan);
+        serial.IntegrateScan(pose, lidar.Scan(world, pose));
+        parallel.IntegrateScan(pose, scan, pool);
+        late.IntegrateScan(pose, scan);
+        checkPyramid(serial);
+        checkPyramid(parallel);
+      }
+      ASSERT_TRUE(serial.AnyOccupied(serial.PyramidLevels() - 1, 0, 0), "the root must see the walls");
+      late.SetMaintainPyramid(true);
+      checkPyramid(late);
+      serial.Reset();
+      checkPyramid(serial);
+      ASSERT_TRUE(!serial.AnyOccupied(serial.PyramidLevels() - 1, 0, 0), "reset must clear the pyramid");
+      serial.IntegrateScan(poses[1], lidar.Scan(world, poses[1]));
+      checkPyramid(serial);
+    }
+  }
+}
+
+void TestLikelihoodFieldTracksBruteForceDistances() {
+  // The second world moves the block, so overwrite scans also free cells the field must raise.
+  slam::core::WorldGrid before = slam::core::WorldGrid::WithBorderWalls(53, 37);
+  before.AddRectangle(30, 8, 5, 17);
+  slam::core::WorldGrid after = slam::core::WorldGrid::WithBorderWalls(53, 37);
+  after.AddRectangle(15, 20, 6, 6);
+  const slam::core::SimulatedLidar lidar(30.0, 180, 1.0);
+  const std::vector<std::pair<const slam::core::WorldGrid*, slam::core::RobotPose>> scans{
+      {&before, {10.5, 10.5, 0.0}}, {&before, {44.3, 30.2, 1.7}}, {&after, {10.5, 10.5, 0.0}},
+      {&after, {44.3, 30.2, 1.7}},  {&after, {40.1, 12.4, 0.4}},  {&before, {40.1, 12.4, 0.4}}};
+  const slam::core::LikelihoodFieldOptions options{.maxDistance = 6.0, .sigma = 1.5};
+  slam::core::WorkerPool pool(3);
+  const auto checkField = [&](const slam::core::OccupancyGridMap& map) {
+    const slam::core::LikelihoodField& field = map.Field();
+    for (int y = 0; y < map.Height(); ++y) {
+      for (int x = 0; x < map.Width(); ++x) {
+        int nearest = std::numeric_limits<int>::max();
+        for (int cellY = 0; cellY < map.Height(); ++cellY) {
+          for (int cellX = 0; cellX < map.Width(); ++cellX) {
+            if (map.ClassifiedValueAt(cellX, cellY) == slam::core::kOccupied) {
+              nearest = std::min(nearest, (cellX - x) * (cellX - x) + (cellY - y) * (cellY - y));
+            }
+          }
+        }
+        const double expected = (nearest > 36) ? std::numeric_limits<double>::infinity() : std::sqrt(nearest);
+        ASSERT_TRUE(field.DistanceAt(x, y) == expected, "field distance must match the nearest occupied cell");
+        ASSERT_TRUE(field.IsObstacle(x, y) == (nearest == 0), "field obstacles must be the occupied cells");
+      }
+    }
+  };
+
+  for (const slam::core::MapUpdateMode mode : {slam::core::MapUpdateMode::kOverwrite, slam::core::MapUpdateMode::kLogOdds}) {
+    slam::core::OccupancyGridMap serial(53, 37, mode);
+    slam::core::OccupancyGridMap parallel(53, 37, mode);
+    slam::core::OccupancyGridMap late(53, 37, mode);
+    ASSERT_TRUE(!serial.MaintainsLikelihoodField(), "no field is kept by default");
+    serial.SetMaintainLikelihoodField(true, options);
+    parallel.SetMaintainLikelihoodField(true, options);
+    parallel.SetMaintainPyramid(true);
+    parallel.SetLayout(slam::core::MapLayout::kMorton);
+    slam::core::ScanBuffer scan;
+    for (const auto& [world, pose] : scans) {
+      lidar.Scan(*world, pose, scan);
+      serial.IntegrateScan(pose, scan);
+      parallel.IntegrateScan(pose, scan, pool);
+      late.IntegrateScan(pose, scan);
+      checkField(serial);
+      checkField(parallel);
+    }
+    late.SetMaintainLikelihoodField(true, options);
+    checkField(late);
+
+    // Score must sum the per-cell likelihoods of the endpoint cells, skipping endpoints off the map.
+    slam::core::ScanPoints points;
+    points.Assign(scan);
+    ASSERT_TRUE(points.Size() == scan.HitCount(), "only hit beams become scan points");
+    const slam::core::LikelihoodField& field = serial.Field();
+    for (const slam::core::RobotPose& pose :
+         {scans.back().second, slam::core::RobotPose{41.3, 11.9, 0.5}, slam::core::RobotPose{3.0, 33.0, 2.0}}) {
+      const float c = static_cast<float>(std::cos(pose.theta));
+      const float s = static_cast<float>(std::sin(pose.theta));
+      double expected = 0.0;
+      for (std::size_t i = 0; i < points.Size(); ++i) {
+        const float x = static_cast<float>(pose.x) + c * points.X()[i] - s * points.Y()[i];
+        const float y = static_cast<float>(pose.y) + s * points.X()[i] + c * points.Y()[i];
+        if (x >= 0.0F && y >= 0.0F && x < 53.0F && y < 37.0F) {
+          expected += field.LikelihoodAt(static_cast<int>(x), static_cast<int>(y));
+        }
+      }
+      ASSERT_TRUE(std::abs(field.Score(pose, points) - expected) <= 1e-3, "score must sum endpoint likelihoods");
+    }
+    ASSERT_TRUE(field.Score(scans.back().second, points) > field.Score(slam::core::RobotPose{41.3, 11.9, 0.5}, points),
+                "the true pose must outscore a perturbed one");
+
+    serial.Reset();
+    checkField(serial);
+    serial.IntegrateScan(scans[0].second, lidar.Scan(*scans[0].first, scans[0].second));
+    checkField(serial);
+  }
+
+  bool threw = false;
+  try {
+    slam::core::LikelihoodField invalid(10, 10, slam::core::LikelihoodFieldOptions{.maxDistance = 4.0, .sigma = 0.0});
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_TRUE(threw, "a non-positive sigma must be rejected");
+}
+
+void TestScanMatcherRecoversPerturbedPoses() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(100, 70);
+  world.AddRectangle(30, 20, 6, 18);
+  world.AddRectangle(60, 45, 20, 5);
+  world.AddRectangle(70, 10, 4, 4);
+  const slam::core::SimulatedLidar lidar(30.0, 360, 1.0);
+  const slam::core::RobotPose truth{40.5, 30.5, 0.3};
+  slam::core::OccupancyGridMap map(100, 70);
+  map.SetMaintainPyramid(true);
+  slam::core::ScanBuffer scan;
+  for (const slam::core::RobotPose& pose : {truth, slam::core::RobotPose{20.5, 50.5, 0.0}, slam::core::RobotPose{85.5, 30.5, 1.0}}) {
+    lidar.Scan(world, pose, scan);
+    map.IntegrateScan(pose, scan);
+  }
+  lidar.Scan(world, truth, scan);
+
+  slam::core::CorrelativeScanMatcher matcher(slam::core::ScanMatcherOptions{.linearWindow = 6, .angularWindow = 0.25});
+  const std::vector<slam::core::RobotPose> offsets{{0.0, 0.0, 0.0}, {2.3, -1.6, 0.08}, {-4.2, 3.1, -0.15}, {5.4, 5.7, 0.2}};
+  for (const slam::core::RobotPose& offset : offsets) {
+    const slam::core::RobotPose predicted{truth.x + offset.x, truth.y + offset.y, truth.theta + offset.theta};
+    const slam::core::ScanMatchResult pruned = matcher.Match(map, predicted, scan);
+    const slam::core::ScanMatchResult exhaustive = matcher.MatchExhaustive(map, predicted, scan);
+    ASSERT_TRUE(pruned.score == exhaustive.score, "branch and bound must find the exhaustive best score");
+    ASSERT_TRUE(pruned.nodesVisited < exhaustive.nodesVisited, "branch and bound must prune candidates");
+    ASSERT_TRUE(pruned.score >= pruned.predictedScore, "the match never scores below the prediction");
+    ASSERT_TRUE(std::abs(pruned.pose.x - truth.x) <= 1.0 && std::abs(pruned.pose.y - truth.y) <= 1.0,
+                "matched translation must be within a cell of the truth");
+    ASSERT_TRUE(std::abs(std::remainder(pruned.pose.theta - truth.theta, 2.0 * std::acos(-1.0))) <= 0.05,
+                "matched heading must be within two angular steps of the truth");
+  }
+  const slam::core::ScanMatchResult exact = matcher.Match(map, truth, scan);
+  ASSERT_TRUE(exact.score == exact.predictedScore, "an exact prediction must score best");
+  ASSERT_TRUE(std::abs(exact.pose.x - truth.x) <= 0.5 && std::abs(exact.pose.y - truth.y) <= 0.5,
+              "refinement moves an exact prediction by at most half a cell");
+
+  bool threw = false;
+  try {
+    slam::core::OccupancyGridMap plain(100, 70);
+    (void)matcher.Match(plain, truth, scan);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_TRUE(threw, "matching needs the map pyramid");
+}
+
+constexpr slam::core::RobotPose kLoopStart{20.5, 18.5, 0.0};
+
+// Pillars keep every leg of LoopPath() observable along its direction of travel.
+slam::core::WorldGrid PillarLoopWorld() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(100, 70);
+  world.AddRectangle(40, 28, 10, 8);
+  for (int y = 7; y < 70; y += 12) {
+    for (int x = 6; x < 100; x += 12) {
+      const bool nearPath = std::abs(y + 1 - 18.5) < 3.0 || std::abs(y + 1 - 46.5) < 3.0 ||
+                            std::abs(x + 1 - 20.5) < 3.0 || std::abs(x + 1 - 65.5) < 3.0;
+      if (!nearPath) {
+        world.AddRectangle(x, y, 2, 2);
+      }
+    }
+  }
+  return world;
+}
+
+// Two laps around the central block with the app's 0.5-cell steps and heading along motion.
+std::vector<slam::core::RobotPose> LoopPath() {
+  std::vector<slam::core::RobotPose> path;
+  slam::core::RobotPose pose = kLoopStart;
+  const std::vector<std::pair<double, double>> legs{{0.5, 0.0}, {0.0, 0.5}, {-0.5, 0.0}, {0.0, -0.5}};
+  for (int lap = 0; lap < 2; ++lap) {
+    for (const auto& [vx, vy] : legs) {
+      const int steps = (vx != 0.0) ? 90 : 56;
+      for (int i = 0; i < steps; ++i) {
+        pose = slam::core::RobotPose{pose.x + vx, pose.y + vy, std::atan2(vy, vx)};
+        path.push_back(pose);
+      }
+    }
+  }
+  return path;
+}
+
+void TestPoseTrackingBoundsOdometryDrift() {
+  const slam::core::WorldGrid world = PillarLoopWorld();
+  const slam::core::SimulatedLidar lidar(30.0, 360, 1.0);
+  const std::vector<slam::core::RobotPose> path = LoopPath();
+
+  const slam::core::PoseTrackerOptions noisy{.matcher = {.linearWindow = 4, .angularWindow = 0.2},
+                                             .odometryNoise = 0.05,
+                                             .headingNoise = 0.01,
+                                             .seed = 1U};
+  slam::core::PoseTrackerOptions deadReckoning = noisy;
+  deadReckoning.matcher = slam::core::ScanMatcherOptions{.linearWindow = 0, .angularWindow = 0.0};
+  const slam::core::RobotPose start = kLoopStart;
+  slam::core::PoseTracker tracker(noisy, start);
+  slam::core::PoseTracker odometryOnly(deadReckoning, start);
+  slam::core::OccupancyGridMap map(100, 70, slam::core::MapUpdateMode::kLogOdds);
+  map.SetMaintainPyramid(true);
+  slam::core::ScanBuffer scan;
+  lidar.Scan(world, start, scan);
+  map.IntegrateScan(start, scan);
+
+  double worstTracked = 0.0;
+  double worstDrift = 0.0;
+  for (const slam::core::RobotPose& truth : path) {
+    lidar.Scan(world, truth, scan);
+    const slam::core::RobotPose& estimate = tracker.Track(map, truth, scan);
+    map.IntegrateScan(estimate, tracker.CorrectedScan());
+    const slam::core::RobotPose& drifted = odometryOnly.Track(map, truth, scan);
+    worstTracked = std::max(worstTracked, std::hypot(estimate.x - truth.x, estimate.y - truth.y));
+    worstDrift = std::max(worstDrift, std::hypot(drifted.x - truth.x, drifted.y - truth.y));
+  }
+  const slam::core::RobotPose& last = path.back();
+  ASSERT_TRUE(worstTracked < 1.5, "tracked pose must stay within 1.5 cells of the truth");
+  ASSERT_TRUE(std::abs(std::remainder(tracker.Estimate().theta - last.theta, 2.0 * std::acos(-1.0))) < 0.1,
+              "tracked heading must stay close to the truth");
+  ASSERT_TRUE(worstDrift > 2.0 * worstTracked, "uncorrected odometry must drift further than the tracked pose");
+}
+
+void TestCowMapSharesTilesUntilWritten() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(100, 70);
+  world.AddRectangle(50, 15, 8, 20);
+  const slam::core::SimulatedLidar lidar(25.0, 360, 1.0);
+  const slam::core::RobotPose first{20.5, 20.5, 0.0};
+  const slam::core::RobotPose second{80.2, 55.7, 0.9};
+  const auto sameCells = [](const auto& expected, const slam::core::CowOccupancyGridMap& map) {
+    for (int y = -1; y <= map.Height(); ++y) {
+      for (int x = -1; x <= map.Width(); ++x) {
+        const bool inside = x >= 0 && y >= 0 && x < map.Width() && y < map.Height();
+        const std::int16_t value = inside ? expected.ValueAt(x, y) : slam::core::UnknownCellValue(map.UpdateMode());
+        if (map.ValueAt(x, y) != value) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+
+  for (const slam::core::MapUpdateMode mode : {slam::core::MapUpdateMode::kOverwrite, slam::core::MapUpdateMode::kLogOdds}) {
+    slam::core::OccupancyGridMap dense(100, 70, mode);
+    slam::core::CowOccupancyGridMap cow(100, 70, mode);
+    slam::core::CowOccupancyGridMap fromSamples(100, 70, mode);
+    ASSERT_TRUE(cow.TileCount() == 7U * 5U && cow.AllocatedTiles() == 0U, "a new map allocates no tiles");
+    slam::core::ScanBuffer scan;
+    lidar.Scan(world, first, scan);
+    for (int repeat = 0; repeat < 2; ++repeat) {
+      dense.IntegrateScan(first, scan);
+      cow.IntegrateScan(first, scan);
+      fromSamples.IntegrateScan(first, lidar.Scan(world, first));
+    }
+    ASSERT_TRUE(sameCells(dense, cow) && sameCells(dense, fromSamples), "cells must match the dense map's beams");
+    const std::size_t allocated = cow.AllocatedTiles();
+    ASSERT_TRUE(allocated > 0U && allocated < cow.TileCount(), "only tiles the scan reached are allocated");
+    ASSERT_TRUE(cow.ExclusiveTiles() == allocated, "a map owns the tiles it allocated");
+
+    slam::core::CowOccupancyGridMap copy = cow;
+    ASSERT_TRUE(cow.ExclusiveTiles() == 0U && copy.ExclusiveTiles() == 0U, "a copy shares every tile");
+    ASSERT_TRUE(cow.SharedCellBytes() + copy.SharedCellBytes() ==
+                    static_cast<double>(allocated * slam::core::CowOccupancyGridMap::kTileCells * sizeof(std::int16_t)),
+                "shared tiles are counted once across the copies");
+
+    lidar.Scan(world, second, scan);
+    dense.IntegrateScan(second, scan);
+    copy.IntegrateScan(second, scan);
+    ASSERT_TRUE(sameCells(dense, copy), "the written copy must see its own scans");
+    ASSERT_TRUE(sameCells(fromSamples, cow), "writing a copy must leave the original untouched");
+    ASSERT_TRUE(copy.ExclusiveTiles() > 0U && copy.ExclusiveTiles() < copy.AllocatedTiles(),
+                "only tiles written after the copy are duplicated");
+    copy.Reset();
+    ASSERT_TRUE(copy.AllocatedTiles() == 0U && sameCells(fromSamples, cow), "resetting a copy must keep the original");
+    ASSERT_TRUE(cow.ExclusiveTiles() == 0U, "tiles stay shared after the copy that shared them is dropped");
+    cow.IntegrateScan(second, scan);
+    ASSERT_TRUE(sameCells(dense, cow) && cow.ExclusiveTiles() > 0U, "writing shared tiles clones them back into ownership");
+  }
+}
+
+void TestParticleFilterBoundsOdometryDrift() {
+  const slam::core::WorldGrid world = PillarLoopWorld();
+  const slam::core::SimulatedLidar lidar(30.0, 360, 1.0);
+  const std::vector<slam::core::RobotPose> path = LoopPath();
+  // Odometry integrates every true motion increment with Gaussian noise added.
+  const slam::core::RobotPose start = kLoopStart;
+  std::vector<slam::core::RobotPose> odometry;
+  std::mt19937 rng(5U);
+  std::normal_distribution<double> translationNoise(0.0, 0.05);
+  std::normal_distribution<double> headingNoise(0.0, 0.01);
+  slam::core::RobotPose previous = start;
+  slam::core::RobotPose reading = start;
+  for (const slam::core::RobotPose& truth : path) {
+    slam::core::RobotPose motion = slam::core::RelativePose(previous, truth);
+    motion.x += translationNoise(rng);
+    motion.y += translationNoise(rng);
+    motion.theta += headingNoise(rng);
+    reading = slam::core::ComposePose(reading, motion);
+    previous = truth;
+    odometry.push_back(reading);
+  }
+
+  const slam::core::ParticleFilterOptions options{.particleCount = 30};
+  slam::core::ParticleFilterSlam serial(100, 70, options, start);
+  slam::core::ParticleFilterSlam parallel(100, 70, options, start);
+  slam::core::WorkerPool pool(3);
+  slam::core::ScanBuffer scan;
+  lidar.Scan(world, start, scan);
+  serial.Update(start, scan);
+  parallel.Update(start, scan, pool);
+  double worstTracked = 0.0;
+  double worstDrift = 0.0;
+  bool parallelMatches = true;
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    lidar.Scan(world, path[i], scan);
+    const slam::core::RobotPose& estimate = serial.Update(odometry[i], scan);
+    const slam::core::RobotPose& pooled = parallel.Update(odometry[i], scan, pool);
+    parallelMatches = parallelMatches && estimate.x == pooled.x && estimate.y == pooled.y && estimate.theta == pooled.theta;
+    worstTracked = std::max(worstTracked, std::hypot(estimate.x - path[i].x, estimate.y - path[i].y));
+    worstDrift = std::max(worstDrift, std::hypot(odometry[i].x - path[i].x, odometry[i].y - path[i].y));
+  }
+  ASSERT_TRUE(parallelMatches, "the pooled update must match the serial one");
+  ASSERT_TRUE(worstTracked < 1.5, "the best particle must stay within 1.5 cells of the truth");
+  ASSERT_TRUE(worstDrift > 2.0 * worstTracked, "uncorrected odometry must drift further than the filter");
+  ASSERT_TRUE(serial.ResampleCount() > 0U, "weights must degenerate and trigger resampling");
+  ASSERT_TRUE(serial.MapBytes() < 30.0 * 100.0 * 70.0 * sizeof(std::int16_t),
+              "shared tiles must keep particle maps below one dense map per particle");
+
+  serial.Reset(start);
+  ASSERT_TRUE(serial.Best().map.AllocatedTiles() == 0U && serial.Estimate().x == start.x, "reset must clear the maps");
+  bool threw = false;
+  try {
+    slam::core::ParticleFilterSlam invalid(100, 70, slam::core::ParticleFilterOptions{.particleCount = 0}, start);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_TRUE(threw, "an empty particle set must be rejected");
+}
+
+void TestPackedMapMatchesOverwriteMapAtTwoBitsPerCell() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(100, 70);
+  world.AddRectangle(50, 15, 8, 20);
+  const slam::core::SimulatedLidar lidar(40.0, 360, 1.0);
+  slam::core::OccupancyGridMap dense(100, 70);
+  slam::core::PackedOccupancyGridMap packed(100, 70);
+  slam::core::PackedOccupancyGridMap fromSamples(100, 70);
+  slam::core::ScanBuffer scan;
+  for (const slam::core::RobotPose& pose : {slam::core::RobotPose{20.5, 20.5, 0.0}, slam::core::RobotPose{80.2, 55.7, 0.9}}) {
+    lidar.Scan(world, pose, scan);
+    dense.IntegrateScan(pose, scan);
+    packed.IntegrateScan(pose, scan);
+    fromSamples.IntegrateScan(pose, lidar.Scan(world, pose));
+  }
+  for (int y = 0; y < 70; ++y) {
+    for (int x = 0; x < 100; ++x) {
+      ASSERT_TRUE(packed.ValueAt(x, y) == dense.ValueAt(x, y), "packed cells must match the overwrite map");
+      ASSERT_TRUE(fromSamples.ValueAt(x, y) == dense.ValueAt(x, y), "sample and buffer scans must match");
+    }
+  }
+  const slam::core::MapStats denseStats = dense.Stats();
+  const slam::core::MapStats packedStats = packed.Stats();
+  ASSERT_TRUE(packedStats.freeCells == denseStats.freeCells && packedStats.occupiedCells == denseStats.occupiedCells &&
+                  packedStats.totalCells == 100U * 70U,
+              "popcount stats must match the counters");
+  ASSERT_TRUE(packed.WordsPerRow() == 4U && packed.CellBytes() == 4U * 70U * 8U, "rows must pad to whole words");
+  ASSERT_TRUE(packed.ValueAt(-1, 3) == slam::core::kUnknown && packed.ValueAt(100, 3) == slam::core::kUnknown,
+              "out-of-bounds cells must read unknown");
+
+  // Log-odds evidence packs to its classification.
+  slam::core::OccupancyGridMap logOdds(100, 70, slam::core::MapUpdateMode::kLogOdds);
+  for (int i = 0; i < 3; ++i) {
+    logOdds.IntegrateScan(slam::core::RobotPose{20.5, 20.5, 0.0}, lidar.Scan(world, slam::core::RobotPose{20.5, 20.5, 0.0}));
+  }
+  slam::core::PackedOccupancyGridMap classified(1, 1);
+  classified.Assign(logOdds);
+  ASSERT_TRUE(classified.Width() == 100 && classified.Height() == 70, "Assign must take the source dimensions");
+  for (int y = 0; y < 70; ++y) {
+    for (int x = 0; x < 100; ++x) {
+      ASSERT_TRUE(classified.ValueAt(x, y) == logOdds.ClassifiedValueAt(x, y), "Assign must pack classified cells");
+    }
+  }
+
+  // Span fills across word boundaries leave the neighbours alone.
+  slam::core::PackedOccupancyGridMap spans(100, 3);
+  spans.FillSpan(1, 5, 90, slam::core::kFree);
+  spans.FillSpan(1, 30, 34, slam::core::kOccupied);
+  spans.FillSpan(1, 40, 41, slam::core::kUnknown);
+  spans.FillSpan(1, -20, 2, slam::core::kOccupied);
+  spans.Set(99, 2, slam::core::kOccupied);
+  for (int x = 0; x < 100; ++x) {
+    std::int16_t expected = slam::core::kUnknown;
+    if (x < 2 || (x >= 30 && x < 34)) {
+      expected = slam::core::kOccupied;
+    } else if (x >= 5 && x < 90 && x != 40) {
+      expected = slam::core::kFree;
+    }
+    ASSERT_TRUE(spans.ValueAt(x, 1) == expected, "span fill must write exactly its cells");
+    ASSERT_TRUE(spans.ValueAt(x, 0) == slam::core::kUnknown, "span fill must stay in its row");
+  }
+  ASSERT_TRUE(spans.Stats().occupiedCells == 7U && spans.Stats().freeCells == 80U, "span stats mismatch");
+
+  // Expansion covers a width that is not a multiple of four cells.
+  std::vector<std::uint8_t> indices(100U * 3U);
+  spans.ExpandToPaletteIndices(indices);
+  const slam::core::PackedOccupancyGridMap::RgbaPalette palette{{{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}}};
+  std::vector<std::uint8_t> rgba(4U * 100U * 3U);
+  spans.ExpandToRgba(palette, rgba);
+  for (int y = 0; y < 3; ++y) {
+    for (int x = 0; x < 100; ++x) {
+      const std::size_t cell = static_cast<std::size_t>(y) * 100U + static_cast<std::size_t>(x);
+      ASSERT_TRUE(indices[cell] == spans.CodeAt(x, y), "palette index must be the cell code");
+      ASSERT_TRUE(rgba[4U * cell] == palette[spans.CodeAt(x, y)][0] && rgba[4U * cell + 3U] == palette[spans.CodeAt(x, y)][3],
+                  "RGBA expansion must use the code's palette entry");
+    }
+  }
+  bool threw = false;
+  try {
+    spans.ExpandToPaletteIndices(std::span<std::uint8_t>(indices.data(), 10U));
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_TRUE(threw, "a short output buffer must be rejected");
+
+  packed.Reset();
+  ASSERT_TRUE(packed.Stats().knownCells == 0U && packed.ValueAt(20, 21) == slam::core::kUnknown, "reset must clear cells");
+}
+
+void TestSparseMapMatchesDenseAndGrowsWithExploredArea() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(120, 80);
+  world.AddRectangle(60, 18, 10, 18);
+  const slam::core::SimulatedLidar lidar(30.0, 360, 1.0);
+  const std::vector<slam::core::RobotPose> poses{{20.5, 20.5, 0.0}, {90.3, 60.7, 1.1}};
+  const slam::core::LogOddsParams params{};
+
+  for (const slam::core::MapUpdateMode mode : {slam::core::MapUpdateMode::kOverwrite, slam::core::MapUpdateMode::kLogOdds}) {
+    slam::core::OccupancyGridMap dense(120, 80, mode, params);
+    slam::core::SparseOccupancyGridMap sparse(mode, params);
+    slam::core::SparseOccupancyGridMap fromSamples(mode, params);
+    slam::core::ScanBuffer scan;
+    for (const slam::core::RobotPose& pose : poses) {
+      lidar.Scan(world, pose, scan);
+      dense.IntegrateScan(pose, scan);
+      sparse.IntegrateScan(pose, scan);
+      fromSamples.IntegrateScan(pose, lidar.Scan(world, pose));
+    }
+    for (int y = 0; y < 80; ++y) {
+      for (int x = 0; x < 120; ++x) {
+        ASSERT_TRUE(sparse.ValueAt(x, y) == dense.ValueAt(x, y), "sparse cells must match the dense map");
+        ASSERT_TRUE(sparse.ClassifiedValueAt(x, y) == dense.ClassifiedValueAt(x, y), "sparse classification mismatch");
+        ASSERT_TRUE(fromSamples.ValueAt(x, y) == dense.ValueAt(x, y), "sample and buffer scans must match");
+      }
+    }
+    ASSERT_TRUE(sparse.ValueAt(-5, 3) == sparse.ValueAt(500, 500), "unallocated space must read unknown");
+  }
+
+  // Two small rooms a million cells apart: chunks cover the rooms, not the space between them.
+  slam::core::SparseOccupancyGridMap sparse;
+  const slam::core::WorldGrid room = slam::core::WorldGrid::WithBorderWalls(40, 40);
+  slam::core::ScanBuffer scan;
+  const slam::core::RobotPose local{20.5, 20.5, 0.0};
+  lidar.Scan(room, local, scan);
+  sparse.IntegrateScan(local, scan);
+  const std::size_t oneRoomChunks = sparse.ChunkCount();
+  ASSERT_TRUE(oneRoomChunks > 0 && oneRoomChunks <= 4, "a 40x40 room must fit in at most 2x2 chunks");
+
+  const double far = -1000000.0;
+  std::vector<slam::core::ScanSample> shifted = lidar.Scan(room, local);
+  sparse.IntegrateScan(slam::core::RobotPose{local.x + far, local.y + far, 0.0}, shifted);
+  ASSERT_TRUE(sparse.ChunkCount() <= 2 * oneRoomChunks + 2, "a distant room must add only its own chunks");
+  ASSERT_TRUE(sparse.CellBytes() == sparse.ChunkCount() * slam::core::SparseOccupancyGridMap::kChunkCells * 2U,
+              "cell storage must scale with allocated chunks");
+  ASSERT_TRUE(sparse.ValueAt(static_cast<int>(far) + 20, static_cast<int>(far) + 21) == slam::core::kFree,
+              "negative coordinates must integrate like positive ones");
+  ASSERT_TRUE(sparse.ValueAt(static_cast<int>(far), static_cast<int>(far) + 20) == slam::core::kOccupied,
+              "distant wall cell must be marked occupied");
+
+  const slam::core::GridRect bounds = sparse.Bounds();
+  ASSERT_TRUE(bounds.xBegin <= static_cast<int>(far) && bounds.xEnd >= 40, "bounds must cover both rooms");
+  std::size_t knownCells = 0;
+  std::size_t visited = 0;
+  sparse.ForEachChunk([&](const slam::core::SparseOccupancyGridMap::ChunkView& chunk) {
+    ++visited;
+    for (std::size_t i = 0; i < chunk.cells.size(); ++i) {
+      const int x = chunk.chunkX * slam::core::SparseOccupancyGridMap::kChunkSize +
+                    static_cast<int>(i % slam::core::SparseOccupancyGridMap::kChunkSize);
+      const int y = chunk.chunkY * slam::core::SparseOccupancyGridMap::kChunkSize +
+                    static_cast<int>(i / slam::core::SparseOccupancyGridMap::kChunkSize);
+      ASSERT_TRUE(chunk.cells[i] == sparse.ValueAt(x, y), "chunk view must expose ValueAt cells");
+      knownCells += (chunk.cells[i] != slam::core::kUnknown) ? 1U : 0U;
+    }
+  });
+  ASSERT_TRUE(visited == sparse.ChunkCount(), "ForEachChunk must visit every chunk once");
+  ASSERT_TRUE(knownCells > 2U * 38U * 38U, "both rooms must be observed");
+
+  sparse.Reset();
+  ASSERT_TRUE(sparse.ChunkCount() == 0 && sparse.ValueAt(20, 21) == slam::core::kUnknown, "reset must drop chunks");
+}
+
+void TestScanBufferMatchesArrayOfStructsScan() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(40, 30);
+  world.AddRectangle(10, 6, 6, 3);
+  const slam::core::SimulatedLidar lidar(25.0, 100, 1.0);
+  const slam::core::RobotPose pose{17.3, 12.6, 0.4};
+
+  const std::vector<slam::core::ScanSample> expected = lidar.Scan(world, pose);
+  slam::core::ScanBuffer buffer;
+  lidar.Scan(world, pose, buffer);
+
+  ASSERT_TRUE(buffer.Size() == expected.size(), "buffer must hold one entry per beam");
+  std::size_t expectedHits = 0;
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    const double angle = pose.theta + expected[i].relativeAngle;
+    ASSERT_TRUE(buffer.RelativeAngles()[i] == expected[i].relativeAngle, "angle mismatch");
+    ASSERT_TRUE(buffer.Distances()[i] == expected[i].distance, "distance mismatch");
+    ASSERT_TRUE(buffer.Hit(i) == expected[i].hit, "hit flag mismatch");
+    ASSERT_TRUE(buffer.EndX()[i] == pose.x + std::cos(angle) * expected[i].distance, "endpoint x mismatch");
+    ASSERT_TRUE(buffer.EndY()[i] == pose.y + std::sin(angle) * expected[i].distance, "endpoint y mismatch");
+    expectedHits += expected[i].hit ? 1U : 0U;
+  }
+  ASSERT_TRUE(buffer.HitCount() == expectedHits, "hit count must match packed flags");
+
+  slam::core::OccupancyGridMap fromSamples(40, 30);
+  slam::core::OccupancyGridMap fromBuffer(40, 30);
+  fromSamples.IntegrateScan(pose, expected);
+  fromBuffer.IntegrateScan(pose, buffer);
+  ASSERT_TRUE(fromSamples.Data() == fromBuffer.Data(), "buffer integration must match sample integration");
+
+  buffer.Resize(3);
+  ASSERT_TRUE(buffer.HitCount() <= 3U, "shrinking must drop stale hit flags");
+}
+
+void TestScanBufferReusesDirectionsOnlyForSameHeading() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(40, 30);
+  world.AddRectangle(10, 6, 6, 3);
+  const slam::core::SimulatedLidar lidar(25.0, 90, 1.0);
+  slam::core::ScanBuffer reused;
+
+  // Translate, turn, then translate again so cached directions are both reused and rebuilt.
+  const slam::core::RobotPose poses[] = {{17.5, 12.5, 0.4}, {18.0, 12.5, 0.4}, {18.0, 12.5, 1.9}, {18.0, 13.0, 1.9}};
+  for (const slam::core::RobotPose& pose : poses) {
+    lidar.Scan(world, pose, reused);
+    ASSERT_TRUE(reused.HasDirectionsFor(pose.theta), "scan must cache directions for its heading");
+    slam::core::ScanBuffer fresh;
+    lidar.Scan(world, pose, fresh);
+    for (std::size_t i = 0; i < fresh.Size(); ++i) {
+      ASSERT_TRUE(reused.Distances()[i] == fresh.Distances()[i], "cached directions changed a distance");
+      ASSERT_TRUE(reused.EndX()[i] == fresh.EndX()[i] && reused.EndY()[i] == fresh.EndY()[i],
+                  "cached directions changed an endpoint");
+    }
+  }
+
+  reused.Resize(45);
+  ASSERT_TRUE(!reused.HasDirectionsFor(1.9), "changing the beam count must drop cached directions");
+}
+
+static_assert(slam::core::SimulatedLidar72::kTable.cos[18] == 0.0, "quarter-turn beam must be exactly axis-aligned");
+static_assert(slam::core::SimulatedLidar72::kTable.sin[18] == 1.0, "quarter-turn beam must be exactly axis-aligned");
+static_assert(slam::core::SimulatedLidar360::kTable.cos[180] == -1.0, "half-turn beam must be exactly axis-aligned");
+static_assert(slam::core::SimulatedLidar360::kTable.sin[180] == 0.0, "half-turn beam must be exactly axis-aligned");
+
+void TestCompileTimeBeamTableMatchesLibm() {
+  const auto& table = slam::core::SimulatedLidar1080::kTable;
+  for (std::size_t i = 0; i < table.angle.size(); ++i) {
+    ASSERT_TRUE(std::abs(table.cos[i] - std::cos(table.angle[i])) < 1e-15, "constexpr cos drifted from libm");
+    ASSERT_TRUE(std::abs(table.sin[i] - std::sin(table.angle[i])) < 1e-15, "constexpr sin drifted from libm");
+  }
+}
+
+void TestTemplateLidarMatchesDynamicRayMarch() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(40, 30);
+  world.AddRectangle(10, 6, 6, 3);
+  world.AddRectangle(24, 18, 4, 7);
+  const slam::core::SimulatedLidar dynamicLidar(25.0, 360, 1.0);
+  const slam::core::SimulatedLidar360 doubleLidar(25.0, 1.0);
+  const slam::core::SimulatedLidarT<360, float> floatLidar(25.0F, 1.0F);
+
+  for (const slam::core::RobotPose& pose :
+       {slam::core::RobotPose{17.3, 12.6, 0.4}, slam::core::RobotPose{30.7, 5.2, -2.1}}) {
+    const std::vector<slam::core::ScanSample> expected = dynamicLidar.Scan(world, pose);
+    const auto exact = doubleLidar.Scan(world, pose);
+    const auto coarse = floatLidar.Scan(world, pose);
+    // The template's rotated directions can differ from the dynamic ones in the last bit. That
+    // only changes a beam's result when, at the shorter of the two distances, the sample point
+    // lies on a cell boundary, so one march rounds into the obstacle and the other does not.
+    const auto onCellBoundary = [](double coordinate) {
+      return std::abs(coordinate - std::round(coordinate)) < 1e-9;
+    };
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_TRUE(std::abs(exact[i].relativeAngle - expected[i].relativeAngle) < 1e-12, "template relative angle mismatch");
+      if (exact[i].distance == expected[i].distance) {
+        ASSERT_TRUE(exact[i].hit == expected[i].hit, "double template hit flag mismatch");
+      } else {
+        const double angle = pose.theta + expected[i].relativeAngle;
+        const double shorter = std::min(exact[i].distance, expected[i].distance);
+        ASSERT_TRUE(onCellBoundary(pose.x + std::cos(angle) * shorter) || onCellBoundary(pose.y + std::sin(angle) * shorter),
+                    "double template may only differ from the dynamic ray march on a cell boundary");
+      }
+      ASSERT_TRUE(coarse[i].hit == expected[i].hit && std::abs(coarse[i].distance - expected[i].distance) <= 1.0,
+                  "float template must stay within one step of the dynamic ray march");
+    }
+
+    slam::core::ScanBuffer buffer;
+    doubleLidar.Scan(world, pose, buffer);
+    for (std::size_t i = 0; i < exact.size(); ++i) {
+      const double angle = pose.theta + exact[i].relativeAngle;
+      ASSERT_TRUE(buffer.Hit(i) == exact[i].hit && buffer.Distances()[i] == exact[i].distance,
+                  "template buffer must match the template's array scan");
+      ASSERT_TRUE(std::abs(buffer.EndX()[i] - (pose.x + std::cos(angle) * exact[i].distance)) < 1e-9,
+                  "template buffer endpoint mismatch");
+    }
+  }
+}
+
+void TestBatchedRayMarchIsBitIdenticalToScalar() {
+  std::mt19937 rng(7U);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::uniform_int_distribution<int> size(1, 6);
+  constexpr double kPi = 3.14159265358979323846;
+
+  for (int worldIndex = 0; worldIndex < 8; ++worldIndex) {
+    slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(90 + worldIndex * 7, 60);
+    for (int block = 0; block < 40; ++block) {
+      world.AddRectangle(static_cast<int>(unit(rng) * world.Width()), static_cast<int>(unit(rng) * world.Height()),
+                         size(rng), size(rng));
+    }
+
+    // Odd beam counts leave a scalar tail after the SIMD batches.
+    for (const int beamCount : {72, 101, 360}) {
+      const slam::core::SimulatedLidar scalar(35.0, beamCount, 0.75, slam::core::LidarMode::kRayMarch);
+      const slam::core::SimulatedLidar batched(35.0, beamCount, 0.75, slam::core::LidarMode::kBatchedRayMarch);
+      for (int poseIndex = 0; poseIndex < 40; ++poseIndex) {
+        // Mix arbitrary poses with half-cell positions and axis headings, where truncation ties are likeliest.
+        const bool snapped = (poseIndex % 4) == 0;
+        const slam::core::RobotPose pose{
+            snapped ? std::round(unit(rng) * world.Width() * 2.0) * 0.5 : unit(rng) * world.Width(),
+            snapped ? std::round(unit(rng) * world.Height() * 2.0) * 0.5 : unit(rng) * world.Height(),
+            snapped ? (poseIndex % 8 == 0 ? kPi * 0.5 : -kPi) : (unit(rng) * 2.0 - 1.0) * kPi,
+        };
+        const std::vector<slam::core::ScanSample> expected = scalar.Scan(world, pose);
+        const std::vector<slam::core::ScanSample> actual = batched.Scan(world, pose);
+        slam::core::ScanBuffer buffer;
+        batched.Scan(world, pose, buffer);
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+          ASSERT_TRUE(actual[i].distance == expected[i].distance && actual[i].hit == expected[i].hit,
+                      "batched march diverged from scalar march");
+          ASSERT_TRUE(buffer.Distances()[i] == expected[i].distance && buffer.Hit(i) == expected[i].hit,
+                      "batched buffer scan diverged from scalar march");
+        }
+      }
+    }
+
+    std::vector<double> dirX(203);
+    std::vector<double> dirY(203);
+    for (std::size_t i = 0; i < dirX.size(); ++i) {
+      const double angle = unit(rng) * 2.0 * kPi;
+      dirX[i] = std::cos(angle);
+      dirY[i] = std::sin(angle);
+    }
+    std::vector<double> expectedDistances(dirX.size());
+    std::vector<double> actualDistances(dirX.size());
+    std::unique_ptr<bool[]> expectedHits(new bool[dirX.size()]);
+    std::unique_ptr<bool[]> actualHits(new bool[dirX.size()]);
+    const double originX = unit(rng) * world.Width();
+    const double originY = unit(rng) * world.Height();
+    slam::core::RayMarchBeamsScalar(world, originX, originY, dirX, dirY, 1.0, 50.0, expectedDistances,
+                                    std::span<bool>(expectedHits.get(), dirX.size()));
+    slam::core::RayMarchBeams(world, originX, originY, dirX, dirY, 1.0, 50.0, actualDistances,
+                              std::span<bool>(actualHits.get(), dirX.size()));
+    for (std::size_t i = 0; i < dirX.size(); ++i) {
+      ASSERT_TRUE(actualDistances[i] == expectedDistances[i] && actualHits[i] == expectedHits[i],
+                  std::string("batched kernel (") + slam::core::RayMarchBatchIsa() + ") diverged from scalar kernel");
+    }
+  }
+}
+
+void TestWorkerPoolRunsEveryTaskOnce() {
+  for (const int threads : {1, 3, 8}) {
+    slam::core::WorkerPool pool(threads);
+    ASSERT_TRUE(pool.ThreadCount() == threads, "pool must report its thread count");
+    std::vector<std::atomic<int>> runs(257);
+    for (int batch = 0; batch < 20; ++batch) {
+      pool.ParallelFor(runs.size(), [&](std::size_t task) { runs[task].fetch_add(1); });
+    }
+    for (const std::atomic<int>& count : runs) {
+      ASSERT_TRUE(count.load() == 20, "every task must run exactly once per batch");
+    }
+  }
+
+  bool threw = false;
+  try {
+    slam::core::WorkerPool invalid(0);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_TRUE(threw, "zero-thread pool must be rejected");
+}
+
+void TestParallelScanAndIntegrationMatchSerial() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(160, 120);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(110, 70, 18, 30);
+
+  const slam::core::RobotPose poses[] = {{80.5, 60.5, 0.0}, {45.3, 30.9, 2.2}, {130.0, 20.0, -1.57079632679489661923}};
+  for (const slam::core::LidarMode mode : {slam::core::LidarMode::kRayMarch, slam::core::LidarMode::kBatchedRayMarch}) {
+    const slam::core::SimulatedLidar lidar(70.0, 3001, 1.0, mode);
+    for (const int threads : {2, 3, 8}) {
+      slam::core::WorkerPool pool(threads);
+      slam::core::OccupancyGridMap serialMap(160, 120);
+      slam::core::OccupancyGridMap parallelMap(160, 120);
+      slam::core::OccupancyGridMap serialLogOdds(160, 120, slam::core::MapUpdateMode::kLogOdds);
+      slam::core::OccupancyGridMap parallelLogOdds(160, 120, slam::core::MapUpdateMode::kLogOdds);
+      slam::core::ScanBuffer serial;
+      slam::core::ScanBuffer parallel;
+      for (const slam::core::RobotPose& pose : poses) {
+        lidar.Scan(world, pose, serial);
+        lidar.Scan(world, pose, parallel, pool);
+        for (std::size_t i = 0; i < serial.Size(); ++i) {
+          ASSERT_TRUE(parallel.Distances()[i] == serial.Distances()[i] && parallel.Hit(i) == serial.Hit(i) &&
+                          parallel.EndX()[i] == serial.EndX()[i] && parallel.EndY()[i] == serial.EndY()[i],
+                      "sector-parallel scan must match the serial scan");
+        }
+        serialMap.IntegrateScan(pose, serial);
+        parallelMap.IntegrateScan(pose, parallel, pool);
+        ASSERT_TRUE(parallelMap.Data() == serialMap.Data(), "band-parallel integration must match serial integration");
+        serialLogOdds.IntegrateScan(pose, serial);
+        parallelLogOdds.IntegrateScan(pose, parallel, pool);
+        ASSERT_TRUE(parallelLogOdds.Data() == serialLogOdds.Data(), "band-parallel log-odds must match serial log-odds");
+      }
+    }
+  }
+}
+
+void TestScanBatchMatchesPerPoseScans() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(120, 80);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+
+  std::mt19937 rng(11U);
+  std::uniform_real_distribution<double> xDist(1.0, 119.0);
+  std::uniform_real_distribution<double> yDist(1.0, 79.0);
+  std::uniform_real_distribution<double> thetaDist(-3.14159265358979323846, 3.14159265358979323846);
+  std::vector<slam::core::RobotPose> poses(150);
+  for (slam::core::RobotPose& pose : poses) {
+    pose = {xDist(rng), yDist(rng), thetaDist(rng)};
+  }
+
+  const slam::core::SimulatedLidar lidar(30.0, 90, 1.0);
+  slam::core::ScanBatchBuffer batch;
+  lidar.ScanBatch(world, poses, batch);
+  ASSERT_TRUE(batch.PoseCount() == poses.size() && batch.BeamCount() == 90U, "batch must be poses x beams");
+
+  std::size_t mismatches = 0;
+  for (std::size_t p = 0; p < poses.size(); ++p) {
+    const std::vector<slam::core::ScanSample> expected = lidar.Scan(world, poses[p]);
+    std::size_t expectedHits = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      expectedHits += expected[i].hit ? 1U : 0U;
+      // Rotated directions may differ from per-beam trig in the last bit; random poses never
+      // put a sample exactly on a cell boundary, so results still match.
+      mismatches += (batch.Distances(p)[i] != expected[i].distance || batch.Hit(p, i) != expected[i].hit) ? 1U : 0U;
+      const double angle = poses[p].theta + expected[i].relativeAngle;
+      ASSERT_TRUE(std::abs(batch.EndX(p)[i] - (poses[p].x + std::cos(angle) * batch.Distances(p)[i])) < 1e-9,
+                  "batch endpoint must lie along the beam");
+    }
+    ASSERT_TRUE(batch.HitCount(p) <= expected.size(), "per-pose hit count out of range");
+  }
+  ASSERT_TRUE(mismatches == 0U, "batch scan diverged from per-pose scans on " + std::to_string(mismatches) + " beams");
+
+  slam::core::WorkerPool pool(4);
+  slam::core::ScanBatchBuffer parallel;
+  lidar.ScanBatch(world, poses, parallel, pool);
+  for (std::size_t p = 0; p < poses.size(); ++p) {
+    for (std::size_t i = 0; i < batch.BeamCount(); ++i) {
+      ASSERT_TRUE(parallel.Distances(p)[i] == batch.Distances(p)[i] && parallel.Hit(p, i) == batch.Hit(p, i) &&
+                      parallel.EndY(p)[i] == batch.EndY(p)[i],
+                  "pool batch must match the serial batch");
+    }
+  }
+}
+
 void TestWorldBuilderAddsBorderWalls() {
   const slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(12, 10);
   for (int x = 0; x < 12; ++x) {
@@ -71,6 +1504,49 @@ void TestWorldBuilderAddsBorderWalls() {
   }
 }
 
+void TestWorldRowQueriesMatchPerCellScan() {
+  slam::core::WorldGrid world(150, 3);
+  for (const int x : {0, 5, 63, 64, 65, 127, 128, 149}) {
+    world.SetObstacle(x, 1);
+  }
+
+  for (int xBegin = -3; xBegin < 154; xBegin += 2) {
+    for (int xEnd = xBegin; xEnd < 156; xEnd += 3) {
+      int expectedFirst = xEnd;
+      for (int x = xBegin; x < xEnd; ++x) {
+        if (world.IsObstacle(x, 1)) {
+          expectedFirst = x;
+          break;
+        }
+      }
+      int expectedLast = xBegin - 1;
+      for (int x = xEnd - 1; x >= xBegin; --x) {
+        if (world.IsObstacle(x, 1)) {
+          expectedLast = x;
+          break;
+        }
+      }
+      ASSERT_TRUE(world.FirstObstacleInRow(1, xBegin, xEnd) == expectedFirst, "first-obstacle row query mismatch");
+      ASSERT_TRUE(world.LastObstacleInRow(1, xBegin, xEnd) == expectedLast, "last-obstacle row query mismatch");
+    }
+  }
+  ASSERT_TRUE(world.FirstObstacleInRow(-1, 10, 20) == 10, "rows outside the grid must be blocked");
+}
+
+void TestWorldRectanglesAndOutOfBoundsUsePackedGuards() {
+  slam::core::WorldGrid world(130, 4);
+  world.AddRectangle(-5, 1, 200, 2);
+  for (int x = 0; x < 130; ++x) {
+    ASSERT_TRUE(world.IsObstacle(x, 1) && world.IsObstacle(x, 2), "clipped rectangle rows must be blocked");
+    ASSERT_TRUE(!world.IsObstacle(x, 0) && !world.IsObstacle(x, 3), "rows outside rectangle must stay free");
+  }
+  ASSERT_TRUE(world.IsObstacle(-1, 0) && world.IsObstacle(130, 0), "columns outside grid must be blocked");
+  ASSERT_TRUE(world.IsObstacle(0, -1) && world.IsObstacle(0, 4), "rows outside grid must be blocked");
+  ASSERT_TRUE(world.IsObstacle(-2147483647, 2147483647), "extreme coordinates must be blocked");
+  ASSERT_TRUE(world.ObstacleWords().size() == static_cast<std::size_t>(world.WordsPerRow() * 6),
+              "packed storage must hold one guard row above and below");
+}
+
 void TestResetClearsMapToUnknown() {
   slam::core::OccupancyGridMap map(20, 20);
   slam::core::RobotPose pose{5.0F, 5.0F, 0.0F};
@@ -80,6 +1556,32 @@ void TestResetClearsMapToUnknown() {
 
   map.Reset();
   ASSERT_TRUE(map.ValueAt(8, 5) == slam::core::kUnknown, "reset must clear to unknown");
+
+  // Reset only retires rows; rescanning must behave exactly like a fresh map.
+  const slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(50, 35);
+  const slam::core::SimulatedLidar lidar(30.0, 120, 1.0);
+  const slam::core::RobotPose first{12.5, 10.5, 0.3};
+  const slam::core::RobotPose second{35.2, 24.8, 2.1};
+  for (const slam::core::MapLayout layout :
+       {slam::core::MapLayout::kRowMajor, slam::core::MapLayout::kTiled, slam::core::MapLayout::kMorton}) {
+    slam::core::OccupancyGridMap reused(50, 35, slam::core::MapUpdateMode::kLogOdds);
+    slam::core::OccupancyGridMap fresh(50, 35, slam::core::MapUpdateMode::kLogOdds);
+    reused.SetLayout(layout);
+    fresh.SetLayout(layout);
+    for (int round = 0; round < 3; ++round) {
+      reused.IntegrateScan(first, lidar.Scan(world, first));
+      reused.Reset();
+    }
+    for (int y = 0; y < 35; ++y) {
+      for (int x = 0; x < 50; ++x) {
+        ASSERT_TRUE(reused.ValueAt(x, y) == 0, "every cell must read unknown after reset");
+      }
+    }
+    reused.IntegrateScan(second, lidar.Scan(world, second));
+    fresh.IntegrateScan(second, lidar.Scan(world, second));
+    ASSERT_TRUE(reused.Data() == fresh.Data(), "rows refilled lazily must match a fresh map");
+    ASSERT_TRUE(reused.Stats().knownCells == fresh.Stats().knownCells, "counters must restart after reset");
+  }
 }
 
 }  // namespace
@@ -87,8 +1589,40 @@ void TestResetClearsMapToUnknown() {
 int main() {
   const std::vector<TestResult> results = {
       Run("Lidar wall distance", TestLidarDetectsExpectedWallDistance),
+      Run("Grid traversal exact distance", TestGridTraversalReturnsExactSubCellDistance),
+      Run("Grid traversal thin walls", TestGridTraversalDoesNotSkipThinWalls),
+      Run("Grid traversal vs fine march", TestGridTraversalMatchesFineRayMarch),
+      Run("Distance field clearance", TestDistanceFieldMeasuresClearanceToNearestObstacle),
+      Run("Sphere trace vs traversal", TestSphereTraceMatchesGridTraversal),
       Run("Occupancy integration", TestOccupancyGridMarksFreeAndHitCells),
+      Run("Log-odds occupancy", TestLogOddsOccupancyAccumulatesAndClamps),
+      Run("Per-scan update deduplication", TestScanDeduplicationUpdatesEachCellOncePerScan),
+      Run("Visibility polygon integration", TestVisibilityPolygonFillsRoomOncePerScan),
+      Run("Visibility polygon occlusion", TestVisibilityPolygonKeepsOccludersOccupied),
+      Run("Tiled and Morton map layouts", TestTiledAndMortonLayoutsMatchRowMajor),
+      Run("Morton indexing", TestMortonIndexingIsDenseAndMatchesBitInterleave),
+      Run("Dirty map regions", TestDirtyRegionsTrackChangedCells),
+      Run("Map stats counters", TestMapStatsMatchFullRecount),
+      Run("Map pyramid", TestMapPyramidMatchesBruteForceBlockMax),
+      Run("Likelihood field", TestLikelihoodFieldTracksBruteForceDistances),
+      Run("Correlative scan matcher", TestScanMatcherRecoversPerturbedPoses),
+      Run("Pose tracking vs odometry drift", TestPoseTrackingBoundsOdometryDrift),
+      Run("Particle filter SLAM", TestParticleFilterBoundsOdometryDrift),
+      Run("Sparse chunked map", TestSparseMapMatchesDenseAndGrowsWithExploredArea),
+      Run("Copy-on-write map", TestCowMapSharesTilesUntilWritten),
+      Run("Packed two-bit map", TestPackedMapMatchesOverwriteMapAtTwoBitsPerCell),
+      Run("Clipped grid line", TestClippedGridLineMatchesFilteredBresenham),
+      Run("Scan buffer layout", TestScanBufferMatchesArrayOfStructsScan),
+      Run("Scan buffer direction cache", TestScanBufferReusesDirectionsOnlyForSameHeading),
+      Run("Compile-time beam table", TestCompileTimeBeamTableMatchesLibm),
+      Run("Template lidar vs dynamic", TestTemplateLidarMatchesDynamicRayMarch),
+      Run("Batched ray march equivalence", TestBatchedRayMarchIsBitIdenticalToScalar),
+      Run("Worker pool task coverage", TestWorkerPoolRunsEveryTaskOnce),
+      Run("Parallel scan and integration", TestParallelScanAndIntegrationMatchSerial),
+      Run("Scan batch vs per-pose scans", TestScanBatchMatchesPerPoseScans),
       Run("World border walls", TestWorldBuilderAddsBorderWalls),
+      Run("World row queries", TestWorldRowQueriesMatchPerCellScan),
+      Run("World packed guards", TestWorldRectanglesAndOutOfBoundsUsePackedGuards),
       Run("Map reset", TestResetClearsMapToUnknown),
   };
 
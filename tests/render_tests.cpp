@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "core/ScanBuffer.h"
 #include "core/Types.h"
 #include "render/Renderer.h"
 
@@ -70,6 +71,31 @@ void TestScanSamplesToPixelsReturnsExpectedEndpoints() {
       "ray1 end mismatch");
 }
 
+void TestScanBufferToPixelsMatchesSampleConversion() {
+  const slam::core::RobotPose pose{5.25, 7.5, 0.3};
+  const std::vector<slam::core::ScanSample> scan = {
+      {.relativeAngle = 0.0, .distance = 3.5, .hit = true},
+      {.relativeAngle = 1.7, .distance = 30.0, .hit = false},
+      {.relativeAngle = 4.1, .distance = 2.25, .hit = true},
+  };
+  slam::core::ScanBuffer buffer(static_cast<int>(scan.size()));
+  for (std::size_t i = 0; i < scan.size(); ++i) {
+    buffer.Store(i, pose, scan[i]);
+  }
+
+  const std::vector<slam::render::PixelRay> expected = slam::render::ScanSamplesToPixels(pose, scan, 8, 4);
+  std::vector<slam::render::PixelRay> actual;
+  slam::render::ScanSamplesToPixels(pose, buffer, 8, 4, actual);
+
+  ASSERT_TRUE(actual.size() == expected.size(), "must produce one ray per beam");
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_TRUE(actual[i].start.x == expected[i].start.x && actual[i].start.y == expected[i].start.y,
+                "ray start mismatch");
+    ASSERT_TRUE(actual[i].end.x == expected[i].end.x && actual[i].end.y == expected[i].end.y, "ray end mismatch");
+    ASSERT_TRUE(actual[i].hit == expected[i].hit, "ray hit mismatch");
+  }
+}
+
 void TestUpdateHitPointHistoryAccumulatesOrReplaces() {
   const std::vector<Vector2> history = {{1.0F, 1.0F}};
   const std::vector<Vector2> current = {{2.0F, 2.0F}, {3.0F, 3.0F}};
@@ -84,7 +110,7 @@ void TestUpdateHitPointHistoryAccumulatesOrReplaces() {
 void TestTryMarkHitPixelDeduplicatesByPixelIndex() {
   const int width = 8;
   const int height = 6;
-  std::vector<unsigned char> occupancy(static_cast<std::size_t>(width * height), 0U);
+  slam::render::HitPixelCache occupancy(static_cast<std::size_t>(width * height));
 
   ASSERT_TRUE(
       slam::render::TryMarkHitPixel(occupancy, width, height, Vector2{3.0F, 4.0F}),
@@ -98,6 +124,36 @@ void TestTryMarkHitPixelDeduplicatesByPixelIndex() {
   ASSERT_TRUE(
       !slam::render::TryMarkHitPixel(occupancy, width, height, Vector2{8.0F, 0.0F}),
       "right-edge out-of-bounds point must be rejected");
+
+  // 300 clears wrap the 8-bit epoch at least once; marks must never leak across a clear.
+  for (int round = 0; round < 300; ++round) {
+    occupancy.Clear();
+    ASSERT_TRUE(
+        slam::render::TryMarkHitPixel(occupancy, width, height, Vector2{3.0F, 4.0F}),
+        "a cleared cache must accept the pixel again");
+    ASSERT_TRUE(
+        !slam::render::TryMarkHitPixel(occupancy, width, height, Vector2{3.0F, 4.0F}),
+        "a pixel must be marked once per clear");
+    ASSERT_TRUE(occupancy.IsMarked(4U * 8U + 3U) && !occupancy.IsMarked(0U), "only the hit pixel must be marked");
+  }
+}
+
+void TestExpandPackedMapUsesDrawMapColors() {
+  slam::core::PackedOccupancyGridMap map(37, 2);
+  map.FillSpan(0, 3, 20, slam::core::kFree);
+  map.Set(36, 1, slam::core::kOccupied);
+  std::vector<Color> pixels;
+  slam::render::ExpandPackedMapToPixels(map, pixels);
+  ASSERT_TRUE(pixels.size() == 37U * 2U, "one pixel per cell expected");
+  for (int y = 0; y < 2; ++y) {
+    for (int x = 0; x < 37; ++x) {
+      const Color expected = (map.ValueAt(x, y) == slam::core::kOccupied) ? slam::render::Palette::kMapObstacle
+                                                                          : slam::render::Palette::kBackground;
+      const Color& actual = pixels[static_cast<std::size_t>(y) * 37U + static_cast<std::size_t>(x)];
+      ASSERT_TRUE(actual.r == expected.r && actual.g == expected.g && actual.b == expected.b && actual.a == expected.a,
+                  "packed pixels must use the DrawMap colors");
+    }
+  }
 }
 
 }  // namespace
@@ -106,8 +162,10 @@ int main() {
   const std::vector<TestResult> results = {
       Run("Palette reference colors", TestPaletteUsesReferenceColors),
       Run("Scan endpoints", TestScanSamplesToPixelsReturnsExpectedEndpoints),
+      Run("Scan buffer endpoints", TestScanBufferToPixelsMatchesSampleConversion),
       Run("Hit history mode", TestUpdateHitPointHistoryAccumulatesOrReplaces),
       Run("Hit pixel dedup", TestTryMarkHitPixelDeduplicatesByPixelIndex),
+      Run("Packed map pixels", TestExpandPackedMapUsesDrawMapColors),
   };
 
   int failed = 0;
@@ -0,0 +1,184 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/ScanBatchBuffer.h"
+#include "core/ScanBuffer.h"
+#include "core/SimulatedLidar.h"
+#include "core/Types.h"
+#include "core/WorldGrid.h"
+
+namespace {
+
+std::size_t gAllocationCount = 0;
+
+}  // namespace
+
+// Counting global allocator: every heap allocation in this binary goes through here.
+void* operator new(std::size_t size) {
+  ++gAllocationCount;
+  if (void* block = std::malloc(size == 0 ? 1 : size)) {
+    return block;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+  std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+  std::free(block);
+}
+
+namespace {
+
+struct TestResult {
+  std::string name;
+  bool passed = false;
+  std::string message;
+};
+
+#define ASSERT_TRUE(cond, msg) \
+  do {                         \
+    if (!(cond)) {             \
+      throw std::runtime_error(msg); \
+    }                          \
+  } while (false)
+
+TestResult Run(const std::string& name, const std::function<void()>& fn) {
+  try {
+    fn();
+    return {name, true, ""};
+  } catch (const std::exception& ex) {
+    return {name, false, ex.what()};
+  }
+}
+
+slam::core::WorldGrid BuildTestWorld() {
+  slam::core::WorldGrid world = slam::core::WorldGrid::WithBorderWalls(120, 80);
+  world.AddRectangle(20, 12, 15, 3);
+  world.AddRectangle(60, 18, 10, 18);
+  world.AddRectangle(35, 45, 30, 4);
+  world.AddRectangle(80, 55, 18, 10);
+  world.BuildDistanceField();
+  return world;
+}
+
+/**
+ * @brief Pose on a closed loop through open space, parameterized by frame index.
+ */
+slam::core::RobotPose LoopPose(int frame) {
+  const double phase = static_cast<double>(frame) * 0.01;
+  return slam::core::RobotPose{
+      .x = 45.0 + 20.0 * std::cos(phase),
+      .y = 32.0 + 8.0 * std::sin(phase),
+      .theta = phase,
+  };
+}
+
+void TestSteadyStateScanLoopDoesNotAllocate() {
+  constexpr int kFrames = 10000;
+  const slam::core::WorldGrid world = BuildTestWorld();
+
+  for (const slam::core::LidarMode mode : {slam::core::LidarMode::kRayMarch,
+                                           slam::core::LidarMode::kGridTraversal,
+                                           slam::core::LidarMode::kSphereTrace,
+                                           slam::core::LidarMode::kBatchedRayMarch}) {
+    const slam::core::SimulatedLidar lidar(30.0, 72, 1.0, mode);
+    slam::core::ScanBuffer buffer;
+    lidar.Scan(world, LoopPose(0), buffer);
+
+    double checksum = 0.0;
+    const std::size_t before = gAllocationCount;
+    for (int frame = 1; frame <= kFrames; ++frame) {
+      lidar.Scan(world, LoopPose(frame), buffer);
+      checksum += buffer.Distances()[0];
+    }
+    const std::size_t allocations = gAllocationCount - before;
+
+    ASSERT_TRUE(checksum > 0.0, "scan loop must produce distances");
+    ASSERT_TRUE(allocations == 0U, "steady-state scans allocated " + std::to_string(allocations) + " times");
+  }
+}
+
+void TestScanIntoCallerStorageMatchesVectorScan() {
+  const slam::core::WorldGrid world = BuildTestWorld();
+  const slam::core::SimulatedLidar lidar(30.0, 72, 1.0);
+  const slam::core::RobotPose pose = LoopPose(37);
+  const std::vector<slam::core::ScanSample> expected = lidar.Scan(world, pose);
+
+  std::array<slam::core::ScanSample, 72> storage{};
+  const std::size_t before = gAllocationCount;
+  lidar.ScanInto(world, pose, storage);
+  ASSERT_TRUE(gAllocationCount == before, "ScanInto must not allocate");
+
+  for (std::size_t i = 0; i < storage.size(); ++i) {
+    ASSERT_TRUE(storage[i].distance == expected[i].distance && storage[i].hit == expected[i].hit &&
+                    storage[i].relativeAngle == expected[i].relativeAngle,
+                "ScanInto must match the vector-returning scan");
+  }
+}
+
+void TestSteadyStateScanBatchDoesNotAllocate() {
+  const slam::core::WorldGrid world = BuildTestWorld();
+  const slam::core::SimulatedLidar lidar(30.0, 72, 1.0);
+  std::array<slam::core::RobotPose, 64> poses{};
+  for (std::size_t i = 0; i < poses.size(); ++i) {
+    poses[i] = LoopPose(static_cast<int>(i) * 10);
+  }
+  slam::core::ScanBatchBuffer batch;
+  lidar.ScanBatch(world, poses, batch);
+
+  const std::size_t before = gAllocationCount;
+  for (int frame = 0; frame < 200; ++frame) {
+    poses[static_cast<std::size_t>(frame) % poses.size()] = LoopPose(frame);
+    lidar.ScanBatch(world, poses, batch);
+  }
+  const std::size_t allocations = gAllocationCount - before;
+  ASSERT_TRUE(allocations == 0U, "steady-state batches allocated " + std::to_string(allocations) + " times");
+}
+
+void TestScanIntoRejectsUndersizedStorage() {
+  const slam::core::WorldGrid world = BuildTestWorld();
+  const slam::core::SimulatedLidar lidar(30.0, 72, 1.0);
+  std::array<slam::core::ScanSample, 8> storage{};
+
+  bool threw = false;
+  try {
+    lidar.ScanInto(world, LoopPose(0), storage);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_TRUE(threw, "undersized storage must be rejected");
+}
+
+}  // namespace
+
+int main() {
+  const std::vector<TestResult> results = {
+      Run("Steady-state scan allocations", TestSteadyStateScanLoopDoesNotAllocate),
+      Run("ScanInto caller storage", TestScanIntoCallerStorageMatchesVectorScan),
+      Run("ScanInto size check", TestScanIntoRejectsUndersizedStorage),
+      Run("Steady-state batch allocations", TestSteadyStateScanBatchDoesNotAllocate),
+  };
+
+  int failed = 0;
+  for (const TestResult& result : results) {
+    if (result.passed) {
+      std::cout << "[PASS] " << result.name << '\n';
+    } else {
+      ++failed;
+      std::cout << "[FAIL] " << result.name << " :: " << result.message << '\n';
+    }
+  }
+  std::cout << "Total: " << results.size() << ", Failed: " << failed << '\n';
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -61,6 +61,7 @@ void TestBuildDemoWorldAddsBorderWalls() {
     ASSERT_TRUE(world.IsObstacle(x, 0), "top border must be obstacle");
     ASSERT_TRUE(world.IsObstacle(x, 9), "bottom border must be obstacle");
   }
+  ASSERT_TRUE(world.HasDistanceField(), "demo world must ship with a distance field");
 }
 
 void TestMazeImageLoadingMatchesPixelThresholdRule() {